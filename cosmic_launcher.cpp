@@ -15,12 +15,40 @@
 #include "games/side_scroller_game.hpp"
 #include "games/qix_game.hpp"
 #include "wifi_config.hpp"
+#include "frame_scheduler.hpp"
+#include "render_pipeline.hpp"
+#include "game_arena.hpp"
+#include "frame_profiler.hpp"
+#include "input_recorder.hpp"
+#include "frame_stream.hpp"
+#include "math/fixed_bench.hpp"
 
 using namespace pimoroni;
 
-PicoGraphics_PenRGB888 graphics(32, 32, nullptr);
+// Frames are drawn on core 0 and presented from a second buffer on core 1
+RenderPipeline render_pipeline;
+PicoGraphics_PenRGB888 graphics(32, 32, render_pipeline.getBackBuffer());
 CosmicUnicorn cosmic_unicorn;
 
+// Memory games allocate from between being selected and exiting to the menu.
+// The hungriest game (SPOOK) peaks near 52 KB, so 64 KB leaves headroom
+#ifndef GAME_ARENA_SIZE
+#define GAME_ARENA_SIZE (64 * 1024)
+#endif
+
+alignas(8) static uint8_t game_arena_buffer[GAME_ARENA_SIZE];
+GameArena game_arena(game_arena_buffer, sizeof(game_arena_buffer));
+
+// Every new/delete goes through the arena check so game allocations land in
+// the arena while one is active (the SDK's own malloc-only versions are
+// disabled with PICO_CXX_DISABLE_ALLOCATION_OVERRIDES)
+void* operator new(size_t size) { return GameArena::allocateOrMalloc(size); }
+void* operator new[](size_t size) { return GameArena::allocateOrMalloc(size); }
+void operator delete(void* p) noexcept { GameArena::freeAny(p); }
+void operator delete[](void* p) noexcept { GameArena::freeAny(p); }
+void operator delete(void* p, size_t) noexcept { GameArena::freeAny(p); }
+void operator delete[](void* p, size_t) noexcept { GameArena::freeAny(p); }
+
 enum class LauncherState {
     MENU,
     PLAYING_GAME,
@@ -30,11 +58,48 @@ enum class LauncherState {
 LauncherState current_state = LauncherState::MENU;
 GameMenu menu;
 GameBase* current_game = nullptr;
-uint32_t last_frame_time = 0;
-const uint32_t target_frame_time = 50; // 20 FPS
+const uint32_t target_fps = 20;
+const uint32_t frame_stats_interval = 30 * target_fps; // Log pacing every 600 ticks (~30 seconds at 20 fps)
+
+PicoFrameClock frame_clock;
+FrameScheduler<PicoFrameClock> frame_scheduler(frame_clock, target_fps);
+
+// Input record/replay. Build with COSMIC_RECORD_INPUT to stream every frame's
+// buttons and clock over USB; the host build can record and replay files.
+InputRecorder input_recorder;
+InputReplay input_replay;
+uint32_t launcher_seed = 0;
+
+// Frame streaming. Build with COSMIC_STREAM_FRAMES to mirror every changed
+// frame over USB as FRM hex lines, shedding frames past the byte budget (the
+// hex doubles it on the wire). The host build defines it too and streams to
+// a file with --stream; other builds carry no encoder.
+#ifdef COSMIC_STREAM_FRAMES
+FrameStreamEncoder frame_stream;
+const uint32_t frame_stream_budget = 16 * 1024;  // Bytes per second
+#endif
+
+// The one place the C RNG is seeded - games must not reseed it themselves,
+// so a recorded seed reproduces a run
+void seedLauncherRandom(uint32_t seed) {
+    launcher_seed = seed;
+    srand(seed);
+}
 
 void initializeLauncher() {
     stdio_init_all();
+    seedLauncherRandom(input_replay.isActive() ? input_replay.getSeed() : (uint32_t)time_us_64());
+#ifdef COSMIC_RECORD_INPUT
+    input_recorder.begin(launcher_seed, frame_scheduler.getUpdatePeriodUs(), inputRecorderHexSink);
+#endif
+#if defined(COSMIC_STREAM_FRAMES) && PICO_ON_DEVICE
+    frame_stream.begin(frameStreamHexSink, nullptr, frame_stream_budget);
+#endif
+#ifdef COSMIC_FIXED_BENCH
+    // Time the fix16 game math against the RP2040's soft float, over USB
+    runFixedBenchOnBoard();
+#endif
+
     cosmic_unicorn.init();
     cosmic_unicorn.set_brightness(0.5f);
     
@@ -44,97 +109,89 @@ void initializeLauncher() {
     
     // Initialize menu
     menu.init(graphics);
+    menu.setGameArena(&game_arena);
     
-    // Add all games to menu
-    menu.addGame("SPOOK", "Halloween spookiness", std::make_unique<HalloweenGame>());
-    menu.addGame("P-TYPE", "Side-scrolling space shooter", std::make_unique<SideScrollerGame>());
-    menu.addGame("RACE", "Fast-paced racing game", std::make_unique<ArcadeRacerGame>());
-    menu.addGame("FROG", "Cross roads and rivers", std::make_unique<FroggerGame>());
-    menu.addGame("QIX", "Claim territory while avoiding the Qix!", std::make_unique<QixGame>());
-    menu.addGame("BLOCKS", "Classic block puzzle", std::make_unique<TetrisGame>());
-    menu.addGame("PRETTY", "Visual shader effects", std::make_unique<ShaderEffectsGame>());
+    // Add all games to menu - each is only constructed when selected
+    menu.addGame("SPOOK", "Halloween spookiness", createGame<HalloweenGame>);
+    menu.addGame("P-TYPE", "Side-scrolling space shooter", createGame<SideScrollerGame>);
+    menu.addGame("RACE", "Fast-paced racing game", createGame<ArcadeRacerGame>);
+    menu.addGame("FROG", "Cross roads and rivers", createGame<FroggerGame>);
+    menu.addGame("QIX", "Claim territory while avoiding the Qix!", createGame<QixGame>);
+    menu.addGame("BLOCKS", "Classic block puzzle", createGame<TetrisGame>);
+    menu.addGame("PRETTY", "Visual shader effects", createGame<ShaderEffectsGame>);
 }
 
-void readInputs(bool& button_a, bool& button_b, bool& button_c, bool& button_d,
-                bool& button_vol_up, bool& button_vol_down, 
-                bool& button_bright_up, bool& button_bright_down) {
+// Debounced, edge-detected buttons for the current update
+InputSampler input_sampler;
+
+const InputState& readInputs() {
     // Read physical buttons
-    bool physical_a = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_A);
-    bool physical_b = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_B);
-    bool physical_c = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_C);
-    bool physical_d = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_D);
-    bool physical_vol_up = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP);
-    bool physical_vol_down = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN);
-    bool physical_bright_up = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_UP);
-    bool physical_bright_down = cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN);
-    button_a = physical_a;
-    button_b = physical_b;
-    button_c = physical_c;
-    button_d = physical_d;
-    button_vol_up = physical_vol_up;
-    button_vol_down = physical_vol_down;
-    button_bright_up = physical_bright_up;
-    button_bright_down = physical_bright_down;
-
-    // Read network buttons
-    // NetworkButtons network_buttons = network_handler.get_network_buttons();
-   /* 
-    // Combine physical and network inputs (OR logic)
-    button_a = physical_a || network_buttons.button_a;
-    button_b = physical_b || network_buttons.button_b;
-    button_c = physical_c || network_buttons.button_c;
-    button_d = physical_d || network_buttons.button_d;
-    button_vol_up = physical_vol_up || network_buttons.button_vol_up;
-    button_vol_down = physical_vol_down || network_buttons.button_vol_down;
-    button_bright_up = physical_bright_up || network_buttons.button_bright_up;
-    button_bright_down = physical_bright_down || network_buttons.button_bright_down;
-    
-    // Clear network buttons after reading them to prevent them from sticking
-    network_handler.clear_network_buttons();
-    */
+    uint8_t buttons = 0;
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_A)) buttons |= inputBit(BUTTON_A);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_B)) buttons |= inputBit(BUTTON_B);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_C)) buttons |= inputBit(BUTTON_C);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_D)) buttons |= inputBit(BUTTON_D);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP)) buttons |= inputBit(BUTTON_VOLUME_UP);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN)) buttons |= inputBit(BUTTON_VOLUME_DOWN);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_UP)) buttons |= inputBit(BUTTON_BRIGHTNESS_UP);
+    if (cosmic_unicorn.is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN)) buttons |= inputBit(BUTTON_BRIGHTNESS_DOWN);
+    
+    // A replay overrides the buttons (and on the host, the clock)
+    uint8_t replay_buttons;
+    uint64_t replay_clock_us;
+    if (input_replay.next(replay_buttons, replay_clock_us)) {
+        buttons = replay_buttons;
+#if !PICO_ON_DEVICE
+        host_time_us = replay_clock_us;
+#endif
+    }
+    
+    if (input_recorder.isRecording()) {
+        input_recorder.recordFrame(buttons, time_us_64());
+    }
+    
+    // Network buttons would be ORed into the raw mask here
+    // buttons |= network_handler.get_network_buttons();
+    // network_handler.clear_network_buttons();
+    
+    return input_sampler.sample(buttons, to_ms_since_boot(get_absolute_time()));
 }
 
-void handleBrightnessControls(bool button_bright_up, bool button_bright_down) {
-    static bool bright_up_pressed = false;
-    static bool bright_down_pressed = false;
-    static uint32_t last_brightness_change = 0;
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    
-    if (current_time - last_brightness_change > 200) {
-        if (button_bright_up && !bright_up_pressed) {
-            cosmic_unicorn.adjust_brightness(0.1f);
-            bright_up_pressed = true;
-            last_brightness_change = current_time;
-        } else if (!button_bright_up) {
-            bright_up_pressed = false;
-        }
-        
-        if (button_bright_down && !bright_down_pressed) {
-            cosmic_unicorn.adjust_brightness(-0.1f);
-            bright_down_pressed = true;
-            last_brightness_change = current_time;
-        } else if (!button_bright_down) {
-            bright_down_pressed = false;
-        }
+void handleBrightnessControls(const InputState& input) {
+    // One step per press, repeating while held
+    if (input.wasRepeated(BUTTON_BRIGHTNESS_UP)) {
+        cosmic_unicorn.adjust_brightness(0.1f);
+    }
+    if (input.wasRepeated(BUTTON_BRIGHTNESS_DOWN)) {
+        cosmic_unicorn.adjust_brightness(-0.1f);
     }
 }
 
 void updateLauncher() {
-    bool button_a, button_b, button_c, button_d;
-    bool button_vol_up, button_vol_down, button_bright_up, button_bright_down;
-    
-    readInputs(button_a, button_b, button_c, button_d,
-               button_vol_up, button_vol_down, button_bright_up, button_bright_down);
+    const InputState* input;
     
-    // Handle brightness controls globally
-    handleBrightnessControls(button_bright_up, button_bright_down);
+    {
+        PROFILE_SCOPE("input");
+        input = &readInputs();
+        
+        // Handle brightness controls globally
+        handleBrightnessControls(*input);
+    }
     
     switch (current_state) {
         case LauncherState::MENU: {
-            GameBase* selected_game = menu.update(button_a, button_b, button_c);
+            GameBase* selected_game;
+            {
+                PROFILE_SCOPE("update");
+                selected_game = menu.update(*input);
+            }
             if (selected_game) {
                 current_game = selected_game;
+                FrameProfiler::setContext(menu.getSelectedGameName());
                 current_game->init(graphics, cosmic_unicorn);
+                frame_scheduler.setRates(current_game->getFrameRates());
+                // The A press that picked the game isn't the game's to see
+                input_sampler.suppressHeld();
                 current_state = LauncherState::PLAYING_GAME;
             }
             break;
@@ -143,12 +200,19 @@ void updateLauncher() {
         case LauncherState::PLAYING_GAME: {
             if (current_game) {
                 // Pass input to current game
-                current_game->handleInput(button_a, button_b, button_c, button_d,
-                                         button_vol_up, button_vol_down,
-                                         button_bright_up, button_bright_down);
+                {
+                    PROFILE_SCOPE("handleInput");
+                    current_game->setInput(*input);
+                    current_game->handleInput(*input);
+                }
                 
                 // Update game state
-                bool continue_game = current_game->update();
+                bool continue_game;
+                {
+                    PROFILE_SCOPE("update");
+                    current_game->setFrameTime(frame_scheduler.getUpdatePeriodUs() / 1000000.0f);
+                    continue_game = current_game->update();
+                }
                 
                 if (!continue_game) {
                     current_state = LauncherState::EXITING_GAME;
@@ -161,7 +225,12 @@ void updateLauncher() {
             if (current_game) {
                 current_game->cleanup();
                 current_game = nullptr;
+                menu.releaseGame();  // Destroys the game and frees its memory
             }
+            FrameProfiler::setContext("MENU");
+            frame_scheduler.setTargetFps(target_fps);
+            // Likewise the D still held from the exit isn't the menu's
+            input_sampler.suppressHeld();
             current_state = LauncherState::MENU;
             break;
         }
@@ -169,25 +238,37 @@ void updateLauncher() {
 }
 
 void renderLauncher() {
-    switch (current_state) {
-        case LauncherState::MENU:
-            menu.render(graphics);
-            break;
-            
-        case LauncherState::PLAYING_GAME:
-            if (current_game) {
-                current_game->render(graphics);
-            }
-            break;
-            
-        case LauncherState::EXITING_GAME:
-            // Clear screen during transition
-            graphics.set_pen(graphics.create_pen(0, 0, 0));
-            graphics.clear();
-            break;
+    {
+        PROFILE_SCOPE("render");
+        switch (current_state) {
+            case LauncherState::MENU:
+                menu.render(graphics);
+                break;
+                
+            case LauncherState::PLAYING_GAME:
+                if (current_game) {
+                    current_game->render(graphics);
+                }
+                break;
+                
+            case LauncherState::EXITING_GAME:
+                // Clear screen during transition
+                graphics.set_pen(graphics.create_pen(0, 0, 0));
+                graphics.clear();
+                break;
+        }
     }
     
-    cosmic_unicorn.update(&graphics);
+#ifdef COSMIC_STREAM_FRAMES
+    if (frame_stream.isStreaming()) {
+        PROFILE_SCOPE("stream");
+        frame_stream.encodeFrame((const uint32_t*)graphics.frame_buffer, time_us_64());
+    }
+#endif
+
+    // Hands the frame to core 1, which times its own cosmic_unicorn.update()
+    PROFILE_SCOPE("present");
+    render_pipeline.present();
 }
 
 void showSplashScreen() {
@@ -215,6 +296,7 @@ void showSplashScreen() {
     sleep_ms(1000); // Show splash for 1 second
 }
 
+#if PICO_ON_DEVICE
 int main() {
     stdio_init_all();  // <-- this enables USB serial
     showSplashScreen();
@@ -222,17 +304,44 @@ int main() {
     
     printf("Cosmic Launcher started! Menu items: %zu\n", menu.getItemCount());
     
+    render_pipeline.start(graphics, cosmic_unicorn);
+    
     while (true) {
-        uint32_t current_time = to_ms_since_boot(get_absolute_time());
-        
-        if (current_time - last_frame_time >= target_frame_time) {
+        // Sleeps until the next absolute deadline; if we fell behind, run the
+        // missed updates and render once. Games with a lower render rate
+        // than update rate skip the render on some ticks.
+        uint32_t updates = frame_scheduler.waitForNextFrame();
+        for (uint32_t i = 0; i < updates; i++) {
             updateLauncher();
+        }
+        if (frame_scheduler.renderDue()) {
             renderLauncher();
-            last_frame_time = current_time;
         }
+        frame_scheduler.endFrame();
         
-        sleep_ms(10); // Small delay to prevent CPU hogging
+        if (FrameProfiler::reportIfDue()) {
+            render_pipeline.reportPanelTime();
+        }
+        
+        const FrameStats& stats = frame_scheduler.getStats();
+        if (stats.ticks % frame_stats_interval == 0) {
+            printf("Frames: %lu rendered, %lu skipped, %lu overruns (max %lu us), %lu updates dropped, "
+                   "now %lu/%lu fps update/render (%lu slowdowns)\n",
+                   (unsigned long)stats.renders, (unsigned long)stats.skipped_renders,
+                   (unsigned long)stats.overruns, (unsigned long)stats.max_overrun_us,
+                   (unsigned long)stats.dropped_updates, (unsigned long)frame_scheduler.getUpdateFps(),
+                   (unsigned long)frame_scheduler.getRenderFps(), (unsigned long)stats.rate_reductions);
+            printf("Panel: %lu uploads (%lu partial, %lu rows), %lu unchanged frames not uploaded\n",
+                   (unsigned long)render_pipeline.getPresentedCount(),
+                   (unsigned long)render_pipeline.getPartialCount(),
+                   (unsigned long)render_pipeline.getRowsUploaded(),
+                   (unsigned long)render_pipeline.getUnchangedCount());
+        }
     }
     
     return 0;
 }
+#else
+// Host build (host/CMakeLists.txt): run every game headlessly instead
+#include "host_runner.hpp"
+#endif
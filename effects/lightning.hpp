@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../game_base.hpp"
+#include "../gfx/blend.hpp"
 #include <cmath>
 #include <vector>
 #include <functional>
@@ -101,7 +102,7 @@ public:
         updateLightningBranches(dt);
     }
     
-    void render(PicoGraphics* graphics) {
+    void render(PicoGraphics_PenRGB888* graphics) {
         drawLightning(graphics);
         
         // Thunder flash overlay
@@ -109,18 +110,18 @@ public:
             float flash_intensity = thunder_flash_timer / 0.2f; // 0.2 second flash
             if (flash_intensity > 1.0f) flash_intensity = 1.0f;
             
-            uint32_t flash_color = graphics->create_pen(
+            uint32_t flash_color = packPen(
                 (int)(255 * flash_intensity * 0.3f),
                 (int)(255 * flash_intensity * 0.4f),
                 (int)(255 * flash_intensity * 0.7f)
             );
-            graphics->set_pen(flash_color);
             
-            // Random flash pixels across the screen
+            // The whole scene brightens a little, with random brighter flecks
+            blendRect(*graphics, 0, 0, 32, 32, dimPen(flash_color, 48), BlendMode::ADD);
             for (int i = 0; i < (int)(flash_intensity * 20); i++) {
                 int x = rand() % 32;
                 int y = rand() % 32;
-                graphics->pixel(Point(x, y));
+                blendPixel(*graphics, x, y, flash_color, BlendMode::ADD);
             }
         }
     }
@@ -243,22 +244,21 @@ private:
         }
     }
     
-    void drawLightning(PicoGraphics* graphics) {
+    void drawLightning(PicoGraphics_PenRGB888* graphics) {
         for (const auto& branch : lightning_branches) {
             if (branch.active) {
                 // Calculate intensity-based color
                 float intensity_factor = branch.intensity;
                 
                 // Draw lightning glow first (wider, dimmer)
-                uint32_t glow_color = graphics->create_pen(
+                uint32_t glow_color = packPen(
                     (int)(lightning_glow_r * intensity_factor * 0.6f),
                     (int)(lightning_glow_g * intensity_factor * 0.6f),
                     (int)(lightning_glow_b * intensity_factor * 0.6f)
                 );
-                graphics->set_pen(glow_color);
                 
-                // Draw glow around main lightning bolt
-                drawThickLine(graphics, branch.x1, branch.y1, branch.x2, branch.y2, 2);
+                // Draw glow around main lightning bolt, added to the sky behind it
+                drawThickLine(graphics, branch.x1, branch.y1, branch.x2, branch.y2, 2, glow_color);
                 
                 // Draw main lightning bolt (bright, thin)
                 uint32_t lightning_color = graphics->create_pen(
@@ -273,7 +273,13 @@ private:
         }
     }
     
-    void drawLine(PicoGraphics* graphics, float x1, float y1, float x2, float y2) {
+    void drawLine(PicoGraphics_PenRGB888* graphics, float x1, float y1, float x2, float y2) {
+        traceLine(x1, y1, x2, y2, [graphics](int x, int y) { graphics->pixel(Point(x, y)); });
+    }
+    
+    // Calls plot(x, y) for each on-screen pixel of the line
+    template <typename Plot>
+    void traceLine(float x1, float y1, float x2, float y2, Plot plot) {
         int ix1 = (int)x1, iy1 = (int)y1, ix2 = (int)x2, iy2 = (int)y2;
         
         int dx = abs(ix2 - ix1);
@@ -284,7 +290,7 @@ private:
         
         while (true) {
             if (ix1 >= 0 && ix1 < 32 && iy1 >= 0 && iy1 < 32) {
-                graphics->pixel(Point(ix1, iy1));
+                plot(ix1, iy1);
             }
             
             if (ix1 == ix2 && iy1 == iy2) break;
@@ -301,11 +307,22 @@ private:
         }
     }
     
-    void drawThickLine(PicoGraphics* graphics, float x1, float y1, float x2, float y2, int thickness) {
-        // Draw multiple lines offset by thickness for glow effect
+    void drawThickLine(PicoGraphics_PenRGB888* graphics, float x1, float y1, float x2, float y2, int thickness, uint32_t glow) {
+        // Mark lines offset by thickness for glow effect, then add the glow
+        // to each marked pixel once: the lines overlap (on a 45 degree bolt
+        // the line one right is the line one up), and a pixel covered twice
+        // would glow twice as bright
+        uint32_t rows[32] = {};
+        auto mark = [&rows](int x, int y) { rows[y] |= 1u << x; };
         for (int offset = -thickness/2; offset <= thickness/2; offset++) {
-            drawLine(graphics, x1 + offset, y1, x2 + offset, y2);
-            drawLine(graphics, x1, y1 + offset, x2, y2 + offset);
+            traceLine(x1 + offset, y1, x2 + offset, y2, mark);
+            traceLine(x1, y1 + offset, x2, y2 + offset, mark);
+        }
+        
+        for (int y = 0; y < 32; y++) {
+            for (uint32_t bits = rows[y]; bits; bits &= bits - 1) {
+                blendPixel(*graphics, __builtin_ctz(bits), y, glow, BlendMode::ADD);
+            }
         }
     }
 };
\ No newline at end of file
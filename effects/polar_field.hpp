@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+#include "../math/fixed.hpp"
+#include "../math/fast_math.hpp"
+
+// Polar coordinates of every panel pixel, generated at compile time, for
+// effects that work in angle and distance from the centre. The panel never
+// changes size, so atan2() and sqrt() per pixel per frame can be table reads.
+//
+// Pixel (x, y) is at index y * POLAR_WIDTH + x and measured from (16, 16),
+// as the effects' cx = x - WIDTH / 2.0f did. Angles are radians in [-pi, pi].
+//
+//   for (int i = 0; i < POLAR_PIXELS; i++) {
+//       float angle = POLAR_FIELD.angle(i);
+//       float ring = RING.at(i, phase);      // sin(distance * k + phase)
+//   }
+//
+// PixelTable holds any other per-pixel term that depends only on position,
+// computed from the exact angle and distance (see PolarPixel).
+
+constexpr int POLAR_WIDTH = 32;
+constexpr int POLAR_HEIGHT = 32;
+constexpr int POLAR_PIXELS = POLAR_WIDTH * POLAR_HEIGHT;
+
+// Exact polar coordinates of pixel index i, for building tables
+struct PolarPixel {
+    double angle = 0;
+    double distance = 0;
+
+    constexpr PolarPixel(int i) {
+        double cx = i % POLAR_WIDTH - POLAR_WIDTH / 2;
+        double cy = i / POLAR_WIDTH - POLAR_HEIGHT / 2;
+        angle = fast_math_detail::seriesAtan2(cy, cx);
+        distance = fast_math_detail::newtonSqrt(cx * cx + cy * cy);
+    }
+};
+
+struct PolarField {
+    fix16 angles[POLAR_PIXELS] = {};
+    fix16 distances[POLAR_PIXELS] = {};
+
+    constexpr PolarField() {
+        for (int i = 0; i < POLAR_PIXELS; i++) {
+            PolarPixel p(i);
+            angles[i] = p.angle;
+            distances[i] = p.distance;
+        }
+    }
+
+    float angle(int i) const { return angles[i].toFloat(); }
+    float distance(int i) const { return distances[i].toFloat(); }
+};
+
+inline constexpr PolarField POLAR_FIELD{};
+
+// One value per pixel from a constexpr function of its PolarPixel:
+//
+//   static constexpr PixelTable<float> SWIRL{[](PolarPixel p) { return p.angle + p.distance * 0.1; }};
+template <typename T>
+struct PixelTable {
+    T values[POLAR_PIXELS] = {};
+
+    template <typename F>
+    constexpr PixelTable(F f) {
+        for (int i = 0; i < POLAR_PIXELS; i++) values[i] = (T)f(PolarPixel(i));
+    }
+
+    constexpr T operator[](int i) const { return values[i]; }
+};
+
+// distance * k per pixel
+struct RadialScale : PixelTable<float> {
+    constexpr RadialScale(double k) : PixelTable<float>([k](PolarPixel p) { return p.distance * k; }) {}
+};
+
+// A ring wave sin(distance * k + phase). The per-pixel sin and cos of
+// distance * k are stored in Q1.14, so with the phase's sin and cos taken
+// once per frame a pixel costs two multiplies:
+//
+//   sin(a + phase) = sin(a) cos(phase) + cos(a) sin(phase)
+//
+// Error against sinf() is under 2e-4.
+struct RadialWave {
+    static constexpr int ONE = 1 << 14;
+
+    int16_t sines[POLAR_PIXELS] = {};
+    int16_t cosines[POLAR_PIXELS] = {};
+
+    struct Phase {
+        int32_t cosine;
+        int32_t sine;
+    };
+
+    constexpr RadialWave(double k) {
+        for (int i = 0; i < POLAR_PIXELS; i++) {
+            double a = PolarPixel(i).distance * k;
+            sines[i] = roundQ14(fast_math_detail::seriesSin(a));
+            cosines[i] = roundQ14(fast_math_detail::seriesSin(a + fast_math_detail::PI / 2));
+        }
+    }
+
+    static Phase phase(float radians) {
+        return {(int32_t)(fastCos(radians) * ONE), (int32_t)(fastSin(radians) * ONE)};
+    }
+
+    float at(int i, Phase p) const {
+        return (float)(sines[i] * p.cosine + cosines[i] * p.sine) * (1.0f / ((float)ONE * ONE));
+    }
+
+    // 0.5 + 0.5 * at() as a level, 0..255
+    uint8_t levelAt(int i, Phase p) const {
+        int32_t wave = sines[i] * p.cosine + cosines[i] * p.sine;  // +-ONE * ONE
+        int32_t level = (wave + ONE * ONE) >> 21;
+        return (uint8_t)(level > 255 ? 255 : (level < 0 ? 0 : level));
+    }
+
+private:
+    static constexpr int16_t roundQ14(double v) {
+        return (int16_t)(v * ONE + (v >= 0 ? 0.5 : -0.5));
+    }
+};
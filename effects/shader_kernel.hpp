@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "../gfx/span_fill.hpp"
+#include "polar_field.hpp"
+
+using namespace pimoroni;
+
+// Full-panel per-pixel effects as kernels. A kernel only says what colour a
+// pixel is; runKernel() owns the loop, so per-frame and per-row terms are
+// worked out once instead of per pixel, and pens go straight into the RGB888
+// framebuffer instead of through set_pen() + pixel(). runKernel() is a
+// template, so each kernel gets its own loop with colour() inlined.
+//
+//   struct Glow : ShaderKernel {
+//       float pulse;
+//       void frame(float t) { pulse = fastSin(t); }             // once a frame
+//       uint32_t colour(int x, int y, int i) const { ... }      // every pixel
+//   };
+//   runKernel(*gfx, glow, t);
+//
+// colour() gets the pixel's index i = y * POLAR_WIDTH + x as well, for the
+// tables in effects/polar_field.hpp. It must only read the kernel, which
+// frame() and row() set up. Pixels are visited row by row, in framebuffer
+// order, within the panel and the clip rectangle.
+
+struct ShaderKernel {
+    // Terms that depend only on the time
+    void frame(float t) {}
+    // Terms that depend only on the row, after frame()
+    void row(int y) {}
+};
+
+template <typename Kernel>
+inline void runKernel(PicoGraphics_PenRGB888& gfx, Kernel& kernel, float t) {
+    int x0 = gfx.clip.x > 0 ? gfx.clip.x : 0;
+    int y0 = gfx.clip.y > 0 ? gfx.clip.y : 0;
+    int x1 = gfx.clip.x + gfx.clip.w < POLAR_WIDTH ? gfx.clip.x + gfx.clip.w : POLAR_WIDTH;
+    int y1 = gfx.clip.y + gfx.clip.h < POLAR_HEIGHT ? gfx.clip.y + gfx.clip.h : POLAR_HEIGHT;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    kernel.frame(t);
+    for (int y = y0; y < y1; y++) {
+        kernel.row(y);
+        int i = y * POLAR_WIDTH;
+        uint32_t* out = spanPointer(gfx, 0, y);
+        for (int x = x0; x < x1; x++) out[x] = kernel.colour(x, y, i + x);
+    }
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include "pico/stdlib.h"
+
+// Per-phase frame timing. Wrap a block in PROFILE_SCOPE("name") and its
+// duration is added to a histogram for the current context (the menu or the
+// game being played). A summary of min/avg/p99/max in microseconds goes out
+// over USB stdio every few seconds. Build with COSMIC_PROFILING=0 and the
+// scopes compile away to nothing.
+#ifndef COSMIC_PROFILING
+#define COSMIC_PROFILING 1
+#endif
+
+#ifndef PROFILER_REPORT_INTERVAL_MS
+#define PROFILER_REPORT_INTERVAL_MS 10000
+#endif
+
+// Microsecond timestamp for measurements. The host build's SDK clock is fake,
+// so measure real elapsed time there instead.
+inline uint32_t profilerNowUs() {
+#if PICO_ON_DEVICE
+    return time_us_32();
+#else
+    return (uint32_t)hostWallTimeUs();
+#endif
+}
+
+// Log-scale histogram: exact below 4 us, then four buckets per power of two
+// (25% resolution) up to ~131 ms. Fixed size, no allocation.
+struct TimingHistogram {
+    static constexpr int NUM_BUCKETS = 64;
+
+    uint16_t buckets[NUM_BUCKETS];
+    uint32_t count;
+    uint32_t total_us;
+    uint32_t min_us;
+    uint32_t max_us;
+
+    TimingHistogram() { clear(); }
+
+    void clear() {
+        for (int i = 0; i < NUM_BUCKETS; i++) buckets[i] = 0;
+        count = 0;
+        total_us = 0;
+        min_us = UINT32_MAX;
+        max_us = 0;
+    }
+
+    static int bucketFor(uint32_t us) {
+        if (us < 4) return (int)us;
+        int exponent = 31 - __builtin_clz(us);
+        int index = (exponent - 1) * 4 + (int)((us >> (exponent - 2)) & 3);
+        return index < NUM_BUCKETS ? index : NUM_BUCKETS - 1;
+    }
+
+    static uint32_t bucketUpperBound(int index) {
+        if (index < 4) return (uint32_t)index;
+        int exponent = index / 4 + 1;
+        uint32_t lower = (uint32_t)(4 + index % 4) << (exponent - 2);
+        return lower + (1u << (exponent - 2)) - 1;
+    }
+
+    void add(uint32_t us) {
+        int index = bucketFor(us);
+        if (buckets[index] < UINT16_MAX) buckets[index]++;
+        count++;
+        total_us += us;
+        if (us < min_us) min_us = us;
+        if (us > max_us) max_us = us;
+    }
+
+    uint32_t average() const {
+        return count ? total_us / count : 0;
+    }
+
+    // Upper edge of the bucket holding the given percentile, capped at the max seen
+    uint32_t percentile(uint32_t pct) const {
+        if (count == 0) return 0;
+        uint32_t target = (count * pct + 99) / 100;
+        uint32_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            seen += buckets[i];
+            if (seen >= target) {
+                uint32_t bound = bucketUpperBound(i);
+                return bound < max_us ? bound : max_us;
+            }
+        }
+        return max_us;
+    }
+
+    void print(const char* context, const char* phase) const {
+        printf("[prof] %s/%s n=%lu min=%lu avg=%lu p99=%lu max=%lu us\n",
+               context, phase, (unsigned long)count, (unsigned long)min_us,
+               (unsigned long)average(), (unsigned long)percentile(99),
+               (unsigned long)max_us);
+    }
+};
+
+#if COSMIC_PROFILING
+
+// Histograms keyed by (context, phase). Keys are compared by pointer, so pass
+// string literals. Only touched from core 0.
+class FrameProfiler {
+public:
+    static constexpr int MAX_SLOTS = 32;
+
+private:
+    struct Slot {
+        const char* context;
+        const char* phase;
+        TimingHistogram histogram;
+    };
+
+    inline static Slot slots[MAX_SLOTS];
+    inline static int used_slots = 0;
+    inline static const char* context = "MENU";
+    inline static uint32_t dropped_samples = 0;
+    inline static uint32_t last_report_ms = 0;
+
+    static Slot* findSlot(const char* phase) {
+        for (int i = 0; i < used_slots; i++) {
+            if (slots[i].phase == phase && slots[i].context == context) {
+                return &slots[i];
+            }
+        }
+        if (used_slots == MAX_SLOTS) return nullptr;
+
+        Slot& slot = slots[used_slots++];
+        slot.context = context;
+        slot.phase = phase;
+        slot.histogram.clear();
+        return &slot;
+    }
+
+public:
+    // Name of whatever is running now, e.g. "MENU" or the game's menu name
+    static void setContext(const char* name) {
+        context = name;
+    }
+
+    static void record(const char* phase, uint32_t us) {
+        Slot* slot = findSlot(phase);
+        if (slot) {
+            slot->histogram.add(us);
+        } else {
+            dropped_samples++;
+        }
+    }
+
+    // Print every histogram with samples since the last report, then start
+    // afresh. Slots that saw nothing (e.g. a game that has since exited) are
+    // given back so the table never fills up.
+    static void report() {
+        int kept = 0;
+        for (int i = 0; i < used_slots; i++) {
+            if (slots[i].histogram.count == 0) continue;
+            slots[i].histogram.print(slots[i].context, slots[i].phase);
+            slots[i].histogram.clear();
+            if (kept != i) slots[kept] = slots[i];
+            kept++;
+        }
+        used_slots = kept;
+        if (dropped_samples > 0) {
+            printf("[prof] %lu samples dropped (no free slot)\n", (unsigned long)dropped_samples);
+            dropped_samples = 0;
+        }
+    }
+
+    static bool reportIfDue() {
+        uint32_t now = to_ms_since_boot(get_absolute_time());
+        if (now - last_report_ms < PROFILER_REPORT_INTERVAL_MS) return false;
+        last_report_ms = now;
+        report();
+        return true;
+    }
+};
+
+struct ProfileScope {
+    const char* phase;
+    uint32_t start_us;
+
+    explicit ProfileScope(const char* name) : phase(name), start_us(profilerNowUs()) {}
+
+    ~ProfileScope() {
+        FrameProfiler::record(phase, profilerNowUs() - start_us);
+    }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(phase)
+
+#else
+
+class FrameProfiler {
+public:
+    static void setContext(const char*) {}
+    static void record(const char*, uint32_t) {}
+    static void report() {}
+    static bool reportIfDue() { return false; }
+};
+
+#define PROFILE_SCOPE(phase) do {} while (0)
+
+#endif
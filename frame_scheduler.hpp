@@ -0,0 +1,237 @@
+#pragma once
+
+#include <stdint.h>
+#include "pico/stdlib.h"
+
+// Clock used on the device: microseconds since boot and a real sleep
+struct PicoFrameClock {
+    uint64_t now_us() const {
+        return time_us_64();
+    }
+
+    void sleep_until_us(uint64_t deadline_us) {
+        sleep_until(from_us_since_boot(deadline_us));
+    }
+};
+
+// Manually driven clock for host builds. Sleeping simply jumps time forward,
+// and advance_us() stands in for the cost of a frame, so pacing and the
+// catch-up policy can be exercised without hardware or real waits.
+struct FakeFrameClock {
+    uint64_t now = 0;
+
+    uint64_t now_us() const {
+        return now;
+    }
+
+    void sleep_until_us(uint64_t deadline_us) {
+        if (deadline_us > now) now = deadline_us;
+    }
+
+    void advance_us(uint64_t us) {
+        now += us;
+    }
+};
+
+struct FrameStats {
+    uint32_t ticks = 0;            // Times waitForNextFrame() returned
+    uint32_t updates = 0;          // Simulation updates handed out
+    uint32_t renders = 0;          // Frames actually rendered
+    uint32_t skipped_renders = 0;  // Render deadlines passed without a render
+    uint32_t dropped_updates = 0;  // Updates abandoned beyond the catch-up limit
+    uint32_t overruns = 0;         // Frames that finished after the next deadline
+    uint32_t last_overrun_us = 0;
+    uint32_t max_overrun_us = 0;
+    uint32_t rate_reductions = 0;  // Times the render or update rate was lowered under load
+};
+
+// Preferred and lowest acceptable rates, in Hz. Renders never run faster
+// than updates, since a frame with no update in between would be identical.
+struct FrameRates {
+    uint16_t update_hz;
+    uint16_t min_update_hz;
+    uint16_t render_hz;
+    uint16_t min_render_hz;
+};
+
+// Deadline-driven frame pacing. Deadlines are absolute (start + n * period),
+// so a frame that is a little late does not push every later frame back.
+// Updates and renders have separate rates: each tick runs the updates that
+// are owed and renders only if a render deadline has also passed. When a
+// frame overruns by whole periods, the missed updates are still run (up to
+// max_catch_up) but only one render is done for all of them.
+//
+// Under sustained load the render rate is lowered step by step to its
+// minimum, then the update rate to its minimum; once frames fit again for a
+// couple of seconds the rates are raised back the same way in reverse.
+template <typename Clock>
+class FrameScheduler {
+private:
+    static constexpr uint32_t LATE_TICKS_BEFORE_SLOWING = 3;
+    static constexpr uint32_t ON_TIME_US_BEFORE_SPEEDING_UP = 2000000;
+
+    Clock& clock;
+    uint32_t update_period_us;
+    uint32_t preferred_update_period_us;
+    uint32_t longest_update_period_us;
+    uint32_t render_period_us;
+    uint32_t preferred_render_period_us;
+    uint32_t longest_render_period_us;
+    uint32_t max_catch_up;
+    uint64_t next_deadline_us;
+    uint64_t next_render_deadline_us;
+    bool started;
+    bool render_due;
+    uint32_t late_ticks;
+    uint64_t on_time_us;
+    FrameStats stats;
+
+    static uint32_t periodFor(uint32_t hz) {
+        return 1000000 / (hz > 0 ? hz : 1);
+    }
+
+    // Lengthen a period by a quarter, up to limit; true if it changed
+    static bool slowDown(uint32_t& period_us, uint32_t limit_us) {
+        if (period_us >= limit_us) return false;
+        period_us += period_us / 4;
+        if (period_us > limit_us) period_us = limit_us;
+        return true;
+    }
+
+    static bool speedUp(uint32_t& period_us, uint32_t preferred_us) {
+        if (period_us <= preferred_us) return false;
+        period_us -= period_us / 8;
+        if (period_us < preferred_us) period_us = preferred_us;
+        return true;
+    }
+
+    void clampRenderPeriod() {
+        if (render_period_us < update_period_us) render_period_us = update_period_us;
+    }
+
+public:
+    explicit FrameScheduler(Clock& frame_clock, uint32_t target_fps = 20, uint32_t catch_up_limit = 4)
+        : clock(frame_clock), max_catch_up(catch_up_limit > 0 ? catch_up_limit : 1),
+          next_deadline_us(0), next_render_deadline_us(0), started(false), render_due(false),
+          late_ticks(0), on_time_us(0) {
+        setTargetFps(target_fps);
+    }
+
+    // Fixed rate: update and render at fps, never lowered
+    void setTargetFps(uint32_t fps) {
+        uint16_t hz = (uint16_t)(fps > 0 ? fps : 1);
+        setRates({hz, hz, hz, hz});
+    }
+
+    // Change the rates; the next deadlines are re-based on the current time
+    // so switching rates never triggers a burst of catch-up updates
+    void setRates(const FrameRates& rates) {
+        preferred_update_period_us = periodFor(rates.update_hz);
+        longest_update_period_us = periodFor(rates.min_update_hz < rates.update_hz ? rates.min_update_hz : rates.update_hz);
+        preferred_render_period_us = periodFor(rates.render_hz);
+        longest_render_period_us = periodFor(rates.min_render_hz < rates.render_hz ? rates.min_render_hz : rates.render_hz);
+        update_period_us = preferred_update_period_us;
+        render_period_us = preferred_render_period_us;
+        clampRenderPeriod();
+        late_ticks = 0;
+        on_time_us = 0;
+
+        if (started) {
+            uint64_t now = clock.now_us();
+            next_deadline_us = now + update_period_us;
+            next_render_deadline_us = now + update_period_us;
+        }
+    }
+
+    // Period of the current update rate, i.e. the game time each update covers
+    uint32_t getUpdatePeriodUs() const { return update_period_us; }
+    uint32_t getRenderPeriodUs() const { return render_period_us; }
+    uint32_t getUpdateFps() const { return 1000000 / update_period_us; }
+    uint32_t getRenderFps() const { return 1000000 / render_period_us; }
+
+    void setMaxCatchUp(uint32_t limit) { max_catch_up = limit > 0 ? limit : 1; }
+
+    // Sleep until the next update deadline (or return straight away if it has
+    // already passed) and return how many updates to run; render afterwards
+    // only if renderDue()
+    uint32_t waitForNextFrame() {
+        uint64_t now = clock.now_us();
+
+        if (!started) {
+            started = true;
+            next_deadline_us = now;
+            next_render_deadline_us = now;
+        }
+
+        if (now < next_deadline_us) {
+            clock.sleep_until_us(next_deadline_us);
+            now = next_deadline_us;
+        }
+
+        // Every deadline at or before now is owed one update
+        uint64_t behind = (now - next_deadline_us) / update_period_us + 1;
+        uint32_t updates = behind > max_catch_up ? max_catch_up : (uint32_t)behind;
+
+        if (behind > max_catch_up) {
+            // Too far behind to catch up - drop the rest and re-base on now
+            stats.dropped_updates += (uint32_t)(behind - max_catch_up);
+            next_deadline_us = now + update_period_us;
+        } else {
+            next_deadline_us += behind * update_period_us;
+        }
+
+        // Renders never catch up; a late one just moves the next deadline on
+        render_due = now >= next_render_deadline_us;
+        if (render_due) {
+            uint64_t missed = (now - next_render_deadline_us) / render_period_us;
+            stats.skipped_renders += (uint32_t)missed;
+            next_render_deadline_us += (missed + 1) * render_period_us;
+            stats.renders++;
+        }
+
+        stats.ticks++;
+        stats.updates += updates;
+
+        return updates;
+    }
+
+    bool renderDue() const { return render_due; }
+
+    // Call once the tick's work is done to record whether it ran past the
+    // following deadline, and to adjust the rates to the load
+    void endFrame() {
+        uint64_t now = clock.now_us();
+        if (now > next_deadline_us) {
+            uint64_t late = now - next_deadline_us;
+            stats.overruns++;
+            stats.last_overrun_us = late > UINT32_MAX ? UINT32_MAX : (uint32_t)late;
+            if (stats.last_overrun_us > stats.max_overrun_us) {
+                stats.max_overrun_us = stats.last_overrun_us;
+            }
+
+            on_time_us = 0;
+            if (++late_ticks >= LATE_TICKS_BEFORE_SLOWING) {
+                late_ticks = 0;
+                // Shed renders first; game time per update grows only as a last resort
+                if (slowDown(render_period_us, longest_render_period_us) ||
+                    slowDown(update_period_us, longest_update_period_us)) {
+                    clampRenderPeriod();
+                    stats.rate_reductions++;
+                }
+            }
+        } else {
+            late_ticks = 0;
+            on_time_us += update_period_us;
+            if (on_time_us >= ON_TIME_US_BEFORE_SPEEDING_UP) {
+                on_time_us = 0;
+                if (!speedUp(update_period_us, preferred_update_period_us)) {
+                    speedUp(render_period_us, preferred_render_period_us);
+                }
+                clampRenderPeriod();
+            }
+        }
+    }
+
+    const FrameStats& getStats() const { return stats; }
+    void resetStats() { stats = FrameStats(); }
+};
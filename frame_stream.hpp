@@ -0,0 +1,355 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Presented frames as a compact stream, for watching the panel from a
+// desktop (live over USB stdio, or captured and turned into images).
+//
+// Stream layout (little-endian):
+//   header  "CLFS", u8 version, u8 width, u8 height
+//   records u8 kind (FRAME_KEY or FRAME_DELTA),
+//           varint frame number (every frame offered, so gaps show drops),
+//           varint microseconds since the previous record,
+//           varint payload length, payload
+//
+// The payload is ops over the pixels in row-major order, each op one byte
+// with the kind in the top two bits and count - 1 in the low six:
+//   SKIP  count pixels unchanged
+//   FILL  count pixels of the colour in the next three bytes (r, g, b)
+//   COPY  count pixels, three bytes each
+// A delta is against the last frame sent; a key frame is against black.
+// Pixels after the last op are unchanged, so a Tetris frame where one piece
+// moved is a few dozen bytes and a frame that didn't change isn't sent.
+//
+// Encoding is one compare pass over the frame. Records go out whole, so
+// with a byte budget the encoder sheds frames (the next delta is against
+// the last frame sent) rather than stalling the frame loop on the link.
+
+static constexpr uint8_t FRAME_STREAM_VERSION = 1;
+static constexpr size_t FRAME_STREAM_HEADER_SIZE = 7;
+
+static constexpr uint8_t FRAME_KEY = 1;
+static constexpr uint8_t FRAME_DELTA = 2;
+
+class FrameStreamEncoder {
+public:
+    typedef void (*Sink)(const uint8_t* data, size_t length, void* context);
+
+    static constexpr int WIDTH = 32;
+    static constexpr int HEIGHT = 32;
+    static constexpr int PIXELS = WIDTH * HEIGHT;
+
+    // A key frame at least this often, so a dropped line heals
+    static constexpr uint32_t KEY_INTERVAL = 100;
+
+    // Kind, frame number, clock and payload length at their longest
+    static constexpr size_t RECORD_HEADER_ROOM = 1 + 5 + 10 + 3;
+    // Every pixel a one-pixel COPY, plus the record header
+    static constexpr size_t MAX_RECORD_SIZE = RECORD_HEADER_ROOM + PIXELS * 4;
+
+private:
+    enum Op : uint8_t {
+        OP_SKIP = 0x00,
+        OP_FILL = 0x40,
+        OP_COPY = 0x80
+    };
+    static constexpr int MAX_OP_COUNT = 64;
+
+    uint32_t sent[PIXELS];              // What the decoder holds (black before a key frame)
+    uint8_t record[MAX_RECORD_SIZE];    // Header packed up against the payload
+    Sink sink = nullptr;
+    void* sink_context = nullptr;
+    uint32_t bytes_per_second = 0;
+    uint64_t credit = 0;                // Budget available, in bytes * 1000000
+    uint64_t last_clock_us = 0;
+    uint64_t last_sent_us = 0;
+    uint32_t frame_number = 0;
+    uint32_t since_key = 0;
+    uint32_t records = 0;
+    uint32_t shed = 0;
+    uint64_t bytes = 0;
+    bool need_key = true;
+    bool streaming = false;
+
+    static size_t putVarint(uint8_t* out, uint64_t value) {
+        size_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = (uint8_t)(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = (uint8_t)value;
+        return n;
+    }
+
+    static size_t putPen(uint8_t* out, uint32_t pen) {
+        out[0] = (uint8_t)(pen >> 16);
+        out[1] = (uint8_t)(pen >> 8);
+        out[2] = (uint8_t)pen;
+        return 3;
+    }
+
+    static size_t putSkip(uint8_t* out, int count) {
+        size_t n = 0;
+        for (; count > MAX_OP_COUNT; count -= MAX_OP_COUNT) out[n++] = OP_SKIP | (MAX_OP_COUNT - 1);
+        if (count > 0) out[n++] = (uint8_t)(OP_SKIP | (count - 1));
+        return n;
+    }
+
+    // Ops turning previous into frame; returns the length
+    static size_t encodePayload(const uint32_t* frame, const uint32_t* previous, uint8_t* out) {
+        size_t n = 0;
+        int skip = 0;
+        int i = 0;
+        while (i < PIXELS) {
+            // Unchanged rows in one compare, then pixel by pixel
+            if (i % WIDTH == 0 && memcmp(frame + i, previous + i, WIDTH * sizeof(uint32_t)) == 0) {
+                skip += WIDTH;
+                i += WIDTH;
+                continue;
+            }
+            uint32_t pen = frame[i];
+            if (pen == previous[i]) {
+                skip++;
+                i++;
+                continue;
+            }
+            n += putSkip(out + n, skip);
+            skip = 0;
+
+            int run = 1;
+            while (i + run < PIXELS && run < MAX_OP_COUNT && frame[i + run] == pen) run++;
+            if (run > 1) {
+                out[n++] = (uint8_t)(OP_FILL | (run - 1));
+                n += putPen(out + n, pen);
+                i += run;
+                continue;
+            }
+
+            // Changed pixels up to an unchanged one or the start of a run
+            size_t op = n++;
+            int count = 0;
+            while (i < PIXELS && count < MAX_OP_COUNT && frame[i] != previous[i]) {
+                if (count > 0 && i + 1 < PIXELS && frame[i + 1] == frame[i]) break;
+                n += putPen(out + n, frame[i]);
+                count++;
+                i++;
+            }
+            out[op] = (uint8_t)(OP_COPY | (count - 1));
+        }
+        return n;  // Trailing unchanged pixels need no op
+    }
+
+public:
+    // bytes_per_second caps the average rate (bursts up to one full record);
+    // 0 sends every changed frame
+    void begin(Sink output, void* context = nullptr, uint32_t budget_bytes_per_second = 0) {
+        sink = output;
+        sink_context = context;
+        bytes_per_second = budget_bytes_per_second;
+        credit = (uint64_t)MAX_RECORD_SIZE * 1000000;
+        last_clock_us = 0;
+        last_sent_us = 0;
+        frame_number = 0;
+        since_key = 0;
+        records = 0;
+        shed = 0;
+        bytes = 0;
+        need_key = true;
+        streaming = true;
+
+        uint8_t header[FRAME_STREAM_HEADER_SIZE] = {'C', 'L', 'F', 'S', FRAME_STREAM_VERSION, WIDTH, HEIGHT};
+        sink(header, sizeof(header), sink_context);
+        bytes += sizeof(header);
+    }
+
+    // Offer a finished frame (RGB888, WIDTH x HEIGHT); sent if it changed
+    // and the budget allows
+    void encodeFrame(const uint32_t* frame, uint64_t clock_us) {
+        if (!streaming) return;
+        frame_number++;
+
+        if (bytes_per_second > 0) {
+            uint64_t elapsed = clock_us >= last_clock_us ? clock_us - last_clock_us : 0;
+            credit += elapsed * bytes_per_second;
+            if (credit > (uint64_t)MAX_RECORD_SIZE * 1000000) credit = (uint64_t)MAX_RECORD_SIZE * 1000000;
+        }
+        last_clock_us = clock_us;
+
+        // Until a key frame goes out every attempt is a key frame, so sent
+        // can be cleared even if this one is shed
+        bool key = need_key || since_key >= KEY_INTERVAL;
+        if (key) memset(sent, 0, sizeof(sent));
+        uint8_t* payload = record + RECORD_HEADER_ROOM;
+        size_t payload_length = encodePayload(frame, sent, payload);
+        if (!key && payload_length == 0) return;
+
+        uint8_t header[RECORD_HEADER_ROOM];
+        size_t header_length = 0;
+        header[header_length++] = key ? FRAME_KEY : FRAME_DELTA;
+        header_length += putVarint(header + header_length, frame_number);
+        header_length += putVarint(header + header_length, clock_us >= last_sent_us ? clock_us - last_sent_us : 0);
+        header_length += putVarint(header + header_length, payload_length);
+        size_t n = header_length + payload_length;
+
+        if (bytes_per_second > 0) {
+            uint64_t cost = (uint64_t)n * 1000000;
+            if (credit < cost) {
+                shed++;
+                return;
+            }
+            credit -= cost;
+        }
+
+        memcpy(payload - header_length, header, header_length);
+        sink(payload - header_length, n, sink_context);
+
+        memcpy(sent, frame, sizeof(sent));
+        last_sent_us = clock_us;
+        since_key = key ? 1 : since_key + 1;
+        need_key = false;
+        records++;
+        bytes += n;
+    }
+
+    // The next record is a key frame (e.g. a viewer just connected)
+    void requestKeyFrame() { need_key = true; }
+
+    void end() { streaming = false; }
+
+    bool isStreaming() const { return streaming; }
+    uint32_t getFrameCount() const { return frame_number; }
+    uint32_t getRecordCount() const { return records; }
+    uint32_t getShedCount() const { return shed; }
+    uint64_t getByteCount() const { return bytes; }
+};
+
+// Walks a complete stream held in memory, rebuilding each frame it sent
+class FrameStreamDecoder {
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t position = 0;
+    int width = 0;
+    int height = 0;
+    uint64_t clock_us = 0;
+    bool active = false;
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; position < length && shift < 64; shift += 7) {
+            uint8_t byte = data[position++];
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+public:
+    struct Frame {
+        uint32_t number;
+        uint64_t clock_us;   // Since the stream began
+        bool key;
+        size_t size;         // Bytes the record took
+    };
+
+    // Returns false if the data isn't a stream this build understands
+    bool begin(const uint8_t* stream, size_t stream_length) {
+        active = false;
+        if (stream_length < FRAME_STREAM_HEADER_SIZE || memcmp(stream, "CLFS", 4) != 0 ||
+            stream[4] != FRAME_STREAM_VERSION) {
+            return false;
+        }
+
+        data = stream;
+        length = stream_length;
+        width = stream[5];
+        height = stream[6];
+        position = FRAME_STREAM_HEADER_SIZE;
+        clock_us = 0;
+        active = true;
+        return true;
+    }
+
+    // Applies the next record to pixels (width * height, kept between
+    // calls); false at the end of the stream or on a damaged record
+    bool next(uint32_t* pixels, Frame& frame) {
+        if (!active || position >= length) {
+            active = false;
+            return false;
+        }
+
+        size_t start = position;
+        uint8_t kind = data[position++];
+        uint64_t number, delta, payload_length;
+        if ((kind != FRAME_KEY && kind != FRAME_DELTA) || !readVarint(number) || !readVarint(delta) ||
+            !readVarint(payload_length) || payload_length > length - position) {
+            active = false;
+            return false;
+        }
+
+        int count = width * height;
+        if (kind == FRAME_KEY) {
+            for (int i = 0; i < count; i++) pixels[i] = 0;
+        }
+
+        const uint8_t* p = data + position;
+        const uint8_t* end = p + payload_length;
+        int i = 0;
+        while (p < end) {
+            uint8_t op = *p++;
+            int run = (op & 0x3f) + 1;
+            if (i + run > count) break;
+            switch (op & 0xc0) {
+                case 0x00:
+                    break;
+                case 0x40: {
+                    if (end - p < 3) break;
+                    uint32_t pen = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+                    p += 3;
+                    for (int j = 0; j < run; j++) pixels[i + j] = pen;
+                    break;
+                }
+                case 0x80:
+                    if (end - p < run * 3) break;
+                    for (int j = 0; j < run; j++, p += 3) {
+                        pixels[i + j] = ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+                    }
+                    break;
+                default:
+                    break;
+            }
+            i += run;
+        }
+
+        position += payload_length;
+        clock_us += delta;
+        frame = {(uint32_t)number, clock_us, kind == FRAME_KEY, position - start};
+        return true;
+    }
+
+    bool isActive() const { return active; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+};
+
+// Sink for the board: records go out over USB stdio as hex lines prefixed
+// "FRM ", which `grep '^FRM' | cut -c5- | xxd -r -p` turns back into a
+// binary stream for cosmic_stream_decode
+inline void frameStreamHexSink(const uint8_t* data, size_t length, void*) {
+    static const char HEX[] = "0123456789abcdef";
+    char line[2 * 64 + 1];
+    while (length > 0) {
+        size_t chunk = length < 64 ? length : 64;
+        for (size_t i = 0; i < chunk; i++) {
+            line[i * 2] = HEX[data[i] >> 4];
+            line[i * 2 + 1] = HEX[data[i] & 15];
+        }
+        line[chunk * 2] = '\0';
+        printf("FRM %s\n", line);
+        data += chunk;
+        length -= chunk;
+    }
+}
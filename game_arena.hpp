@@ -0,0 +1,211 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+
+// Per-session memory arena for games. The launcher activates it just before a
+// game is constructed and resets it in one go once the game has been
+// destroyed, so whatever a game allocates (and however it churns) can never
+// fragment the heap the menu and the next game will use.
+//
+// Memory is bump-allocated from a fixed buffer. Small blocks are rounded up
+// to a power of two and recycled through per-size free lists, so containers
+// that reallocate every frame (Frogger's lane strings, Qix's flood fill) reuse
+// their old blocks instead of marching through the buffer. Larger blocks are
+// recycled by first fit. If the arena runs out, allocation falls back to
+// malloc and is counted as an overflow.
+class GameArena {
+public:
+    static constexpr size_t ALIGNMENT = 8;
+    static constexpr size_t MIN_CLASS_SHIFT = 4;   // 16 bytes
+    static constexpr size_t MAX_CLASS_SHIFT = 12;  // 4096 bytes
+    static constexpr size_t NUM_CLASSES = MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1;
+
+private:
+    // Sits in front of every block; keeps the payload 8-byte aligned
+    struct BlockHeader {
+        uint32_t size;      // Payload size the block was carved with
+        uint32_t reserved;
+    };
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    uint8_t* base;
+    size_t capacity;
+    size_t used;            // Bump offset - also the high-water mark for the session
+    size_t live_bytes;
+    size_t peak_live_bytes;
+    uint32_t overflow_count;
+    bool active;
+    FreeBlock* free_lists[NUM_CLASSES];
+    FreeBlock* large_free;
+
+    inline static GameArena* instance = nullptr;  // The launcher's arena, active or not
+
+    static size_t classIndex(size_t size) {
+        size_t shift = MIN_CLASS_SHIFT;
+        while (((size_t)1 << shift) < size) shift++;
+        return shift - MIN_CLASS_SHIFT;
+    }
+
+    static BlockHeader* headerOf(void* p) {
+        return (BlockHeader*)((uint8_t*)p - sizeof(BlockHeader));
+    }
+
+    void* carve(size_t size) {
+        size_t needed = sizeof(BlockHeader) + size;
+        if (capacity - used < needed) return nullptr;
+
+        BlockHeader* header = (BlockHeader*)(base + used);
+        header->size = (uint32_t)size;
+        used += needed;
+        return header + 1;
+    }
+
+public:
+    GameArena(void* buffer, size_t size)
+        : base((uint8_t*)buffer), capacity(size & ~(ALIGNMENT - 1)) {
+        reset();
+        instance = this;
+    }
+
+    // Route game allocations here until deactivate()
+    void activate() {
+        active = true;
+    }
+
+    void deactivate() {
+        active = false;
+    }
+
+    bool isActive() const { return active; }
+
+    // Forget every allocation at once. Only call when nothing allocated from
+    // the arena is still alive (i.e. after the game has been destroyed).
+    void reset() {
+        used = 0;
+        live_bytes = 0;
+        peak_live_bytes = 0;
+        overflow_count = 0;
+        active = false;
+        for (size_t i = 0; i < NUM_CLASSES; i++) free_lists[i] = nullptr;
+        large_free = nullptr;
+    }
+
+    bool owns(const void* p) const {
+        return (const uint8_t*)p >= base && (const uint8_t*)p < base + capacity;
+    }
+
+    // Returns nullptr when the arena is full
+    void* allocate(size_t size) {
+        if (size == 0) size = 1;
+        size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+        void* p = nullptr;
+        if (size <= ((size_t)1 << MAX_CLASS_SHIFT)) {
+            size_t index = classIndex(size);
+            size = (size_t)1 << (index + MIN_CLASS_SHIFT);
+            if (free_lists[index]) {
+                FreeBlock* block = free_lists[index];
+                free_lists[index] = block->next;
+                p = block;
+            } else {
+                p = carve(size);
+            }
+        } else {
+            // First fit among freed large blocks
+            FreeBlock** link = &large_free;
+            while (*link) {
+                if (headerOf(*link)->size >= size) {
+                    p = *link;
+                    *link = (*link)->next;
+                    size = headerOf(p)->size;
+                    break;
+                }
+                link = &(*link)->next;
+            }
+            if (!p) p = carve(size);
+        }
+
+        if (!p) {
+            overflow_count++;
+            return nullptr;
+        }
+
+        live_bytes += size;
+        if (live_bytes > peak_live_bytes) peak_live_bytes = live_bytes;
+        return p;
+    }
+
+    void deallocate(void* p) {
+        // Blocks from a session that has already been reset are just dropped
+        if (!p || !active) return;
+
+        BlockHeader* header = headerOf(p);
+        FreeBlock* block = (FreeBlock*)p;
+        live_bytes -= header->size;
+
+        if (header->size <= ((size_t)1 << MAX_CLASS_SHIFT)) {
+            size_t index = classIndex(header->size);
+            block->next = free_lists[index];
+            free_lists[index] = block;
+        } else {
+            block->next = large_free;
+            large_free = block;
+        }
+    }
+
+    size_t getCapacity() const { return capacity; }
+    size_t getHighWaterMark() const { return used; }
+    size_t getPeakLiveBytes() const { return peak_live_bytes; }
+    uint32_t getOverflowCount() const { return overflow_count; }
+
+    // Used by the global operator new/delete: the arena while a game session
+    // is active and it has room, otherwise the normal heap
+    static void* allocateOrMalloc(size_t size) {
+        if (instance && instance->active) {
+            void* p = instance->allocate(size);
+            if (p) return p;
+        }
+        return malloc(size ? size : 1);
+    }
+
+    static void freeAny(void* p) {
+        if (!p) return;
+        if (instance && instance->owns(p)) {
+            instance->deallocate(p);
+        } else {
+            free(p);
+        }
+    }
+};
+
+// Standard allocator drawing from the game arena while a session is active.
+// The launcher's operator new already sends default-allocated containers
+// there; this is for code that names the arena explicitly, such as builds
+// without that operator new (benchmarks and host tools).
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return (T*)GameArena::allocateOrMalloc(n * sizeof(T));
+    }
+
+    void deallocate(T* p, size_t) {
+        GameArena::freeAny(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
@@ -3,6 +3,8 @@
 #include "pico/stdlib.h"
 #include "libraries/pico_graphics/pico_graphics.hpp"
 #include "cosmic_unicorn.hpp"
+#include "frame_scheduler.hpp"
+#include "input_state.hpp"
 
 using namespace pimoroni;
 
@@ -20,32 +22,41 @@ public:
     virtual const char* getName() const = 0;
     virtual const char* getDescription() const = 0;
     
+    // Distinct modes a game cycles through on its own (scenes, themes,
+    // effects). Tools like the host benchmark select each one in turn and
+    // expect the game to stay on it.
+    virtual int getVariantCount() const { return 1; }
+    virtual const char* getVariantName(int index) const { return getName(); }
+    virtual void selectVariant(int index) {}
+    
+    // Rates the launcher should run this game at while it is selected. The
+    // default suits games that move a fixed amount per update(): their update
+    // rate is never lowered, but renders may drop to 10 fps under load.
+    virtual FrameRates getFrameRates() const { return {20, 20, 20, 10}; }
+    
+    // Game time covered by the coming update(), set by the launcher from the
+    // scheduler's current update rate
+    void setFrameTime(float seconds) { frame_dt = seconds; }
+    
+    // This update's buttons, set by the launcher before handleInput() and
+    // update(). Games read input from here rather than polling the switches.
+    void setInput(const InputState& state) { input = state; }
+    
     // Input handling
-    virtual void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                            bool button_vol_up, bool button_vol_down, 
-                            bool button_bright_up, bool button_bright_down) {}
+    virtual void handleInput(const InputState& state) {}
     
     // Check if the exit button combination is pressed (D button long press)
-    bool checkExitCondition(bool button_d) {
-        static uint32_t d_press_start = 0;
-        static bool d_was_pressed = false;
-        
-        if (button_d && !d_was_pressed) {
-            d_press_start = to_ms_since_boot(get_absolute_time());
-            d_was_pressed = true;
-        } else if (!button_d && d_was_pressed) {
-            d_was_pressed = false;
-        } else if (button_d && d_was_pressed) {
-            uint32_t press_duration = to_ms_since_boot(get_absolute_time()) - d_press_start;
-            if (press_duration > 1000) {  // 1 second long press
-                return true;
-            }
-        }
-        
-        return false;
+    bool checkExitCondition() const {
+        return input.heldMs(BUTTON_D) > 1000;  // 1 second long press
     }
 
 protected:
     PicoGraphics_PenRGB888* gfx = nullptr;
     CosmicUnicorn* cosmic = nullptr;
+    float frame_dt = 0.05f;  // Seconds per update()
+    InputState input;
+    
+    // Per-update amounts in the games were tuned at 20 updates a second;
+    // multiply them by this to keep the same speed at any rate
+    float frameScale() const { return frame_dt * 20.0f; }
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "pico/time.h"
 #include <vector>
 #include <cmath>
+#include "../gfx/blend.hpp"
 
 using namespace pimoroni;
 
@@ -556,29 +557,27 @@ private:
         
         // Enhanced glow effect - scale with eye openness and global phase
         float glow_intensity = config.glow_intensity * (0.7f + 0.3f * sin(global_glow_phase * 3.0f + eye_index * 1.5f)) * eye_openness;
-        Pen glow_pen = gfx->create_pen(
+        uint32_t glow = packPen(
             (uint8_t)(config.r * glow_intensity), 
             (uint8_t)(config.g * glow_intensity), 
             (uint8_t)(config.b * glow_intensity)
         );
-        gfx->set_pen(glow_pen);
-        
-        // Draw glow around the eye (skip for POINT type as it handles its own color)
         
+        // Draw glow around the eye (skip for POINT type as it handles its own color).
+        // Glows are added to whatever is behind them, so trees and mist show through.
         if (actualType != POINT) {
             // Draw glow around the eye
-            drawGlow(config, effective_radiusY, glow_intensity);
+            drawGlow(config, effective_radiusY, glow);
             
             // Outer glow for more dramatic effect
-            Pen outer_glow = gfx->create_pen(
+            uint32_t outer_glow = packPen(
                 (uint8_t)(config.r * glow_intensity * 0.3f), 
                 (uint8_t)(config.g * glow_intensity * 0.3f), 
                 (uint8_t)(config.b * glow_intensity * 0.3f)
             );
-            gfx->set_pen(outer_glow);
             
             // Wider outer glow
-            drawOuterGlow(config, effective_radiusY);
+            drawOuterGlow(config, effective_radiusY, outer_glow);
         }
     }
     
@@ -671,41 +670,41 @@ private:
         }
     }
     
-    void drawGlow(const EyeConfig& config, float effective_radiusY, float glow_intensity) {
+    void drawGlow(const EyeConfig& config, float effective_radiusY, uint32_t glow) {
         int center_x = (int)config.x;
         int center_y = (int)config.y;
         
         if (config.is_triangle) {
             // Triangle glow pattern from original
-            gfx->pixel({center_x - 1, center_y});
-            gfx->pixel({center_x + 3, center_y});
-            gfx->pixel({center_x + 1, center_y - 2});
-            gfx->pixel({center_x + 1, center_y + 2});
+            blendPixel(*gfx, center_x - 1, center_y, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 3, center_y, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 1, center_y - 2, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 1, center_y + 2, glow, BlendMode::ADD);
         } else {
             // Round eye glow pattern from original
-            gfx->pixel({center_x - 1, center_y});
-            gfx->pixel({center_x - 1, center_y + 1});
-            gfx->pixel({center_x + 3, center_y});
-            gfx->pixel({center_x + 3, center_y + 1});
-            gfx->pixel({center_x, center_y - 1});
-            gfx->pixel({center_x + 1, center_y - 1});
-            gfx->pixel({center_x + 2, center_y - 1});
-            gfx->pixel({center_x, center_y + 2});
-            gfx->pixel({center_x + 1, center_y + 2});
-            gfx->pixel({center_x + 2, center_y + 2});
+            blendPixel(*gfx, center_x - 1, center_y, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x - 1, center_y + 1, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 3, center_y, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 3, center_y + 1, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x, center_y - 1, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 1, center_y - 1, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 2, center_y - 1, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x, center_y + 2, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 1, center_y + 2, glow, BlendMode::ADD);
+            blendPixel(*gfx, center_x + 2, center_y + 2, glow, BlendMode::ADD);
         }
     }
     
-    void drawOuterGlow(const EyeConfig& config, float effective_radiusY) {
+    void drawOuterGlow(const EyeConfig& config, float effective_radiusY, uint32_t glow) {
         int center_x = (int)config.x;
         int center_y = (int)config.y;
         
         // Wider outer glow from original
-        gfx->pixel({center_x - 2, center_y});
-        gfx->pixel({center_x - 2, center_y + 1});
-        gfx->pixel({center_x + 4, center_y});
-        gfx->pixel({center_x + 4, center_y + 1});
-        gfx->pixel({center_x + 1, center_y - 2});
-        gfx->pixel({center_x + 1, center_y + 3});
+        blendPixel(*gfx, center_x - 2, center_y, glow, BlendMode::ADD);
+        blendPixel(*gfx, center_x - 2, center_y + 1, glow, BlendMode::ADD);
+        blendPixel(*gfx, center_x + 4, center_y, glow, BlendMode::ADD);
+        blendPixel(*gfx, center_x + 4, center_y + 1, glow, BlendMode::ADD);
+        blendPixel(*gfx, center_x + 1, center_y - 2, glow, BlendMode::ADD);
+        blendPixel(*gfx, center_x + 1, center_y + 3, glow, BlendMode::ADD);
     }
 };
\ No newline at end of file
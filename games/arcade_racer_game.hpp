@@ -10,6 +10,13 @@
 
 #include "pico/stdlib.h"
 #include "../game_base.hpp"
+#include "../frame_profiler.hpp"
+#include "../gfx/span_fill.hpp"
+#include "../gfx/compositor.hpp"
+#include "../gfx/sprite_atlas.hpp"
+#include "../gfx/deep_frame.hpp"
+#include "../math/fixed.hpp"
+#include "../math/fast_math.hpp"
 
 using namespace pimoroni;
 
@@ -53,7 +60,7 @@ public:
         }
     }
     
-    void draw(PicoGraphics& gfx, Pen& pen, float w = 0) {
+    void draw(PicoGraphics_PenRGB888& gfx, Pen& pen, float w = 0) {
         wind = w;
         gfx.set_pen(pen);
         gfx.pixel(Point((int)x, (int)y));
@@ -81,30 +88,37 @@ public:
         }
     }
     
-    void draw(PicoGraphics& gfx, Pen& pen) {
+    void draw(PicoGraphics_PenRGB888& gfx, Pen& pen) {
         for (auto& drop : raindrops) {
             drop.draw(gfx, pen, wind);
         }
     }
 };
 
+// Rolling hills behind the road, kept as one ridge height per column and
+// drawn column by column: outline, shading and fill in one pass
 class Mountain {
 private:
-    PicoGraphics& gfx;
+    static constexpr int MAX_WIDTH = 32;
+    
+    PicoGraphics_PenRGB888& gfx;
     float pCurve, waveMod, currentHillHeight;
     int w, h, yoffset;
-    std::vector<Point> pointCloud;
-    Point lastPoint;
+    int8_t ridge[MAX_WIDTH] = {};  // Top of the hills in each column
+    int peakY;                     // Top of the highest hill, on screen or not
+    
+    int ridgeY(float s) const {
+        return s <= 0 ? (int)s + yoffset : (int)(-s * 0.8f) + yoffset;
+    }
     
 public:
     std::vector<Pen> greens;
     
-    Mountain(PicoGraphics& graphics, float waveM = 4, int width = 32, int height = 32) 
+    Mountain(PicoGraphics_PenRGB888& graphics, float waveM = 4, int width = 32, int height = 32) 
         : gfx(graphics), pCurve(-1), waveMod(waveM), currentHillHeight(0),
-          w(width), h(height), yoffset(12) {
-        lastPoint = Point(0, 16);
+          w(width < MAX_WIDTH ? width : MAX_WIDTH), h(height), yoffset(12), peakY(12) {
         createPalette();
-        generatePointCloud();
+        updateRidge();
     }
     
     void createPalette() {
@@ -125,7 +139,8 @@ public:
         }
     }
     
-    void generatePointCloud(float pCurv = 0, float waveM = 4, int yoff = 12) {
+    // Only recomputes when the curve or the hill height has moved
+    void updateRidge(float pCurv = 0, float waveM = 4, int yoff = 12) {
         if (pCurv == pCurve && waveM == waveMod) return;
         
         waveMod = waveM;
@@ -134,50 +149,29 @@ public:
         if (waveMod < currentHillHeight) currentHillHeight -= 0.01f;
         
         yoffset = yoff;
-        pointCloud.clear();
-        pointCloud.push_back(Point(-1, yoffset));
         pCurve = pCurv;
         
-        for (int j = 0; j < w * 2; j++) {
-            float s = cos(pCurve * 0.001f + j * 0.1f) * currentHillHeight;
-            if (s <= 0) {
-                lastPoint = Point(j, (int)s + yoffset);
-            } else {
-                lastPoint = Point(j, (int)(-s * 0.8f) + yoffset);
-            }
-            pointCloud.push_back(lastPoint);
+        for (int x = 0; x < w; x++) {
+            ridge[x] = (int8_t)ridgeY(fastCos(pCurve * 0.001f + x * 0.1f) * currentHillHeight);
         }
-        pointCloud.push_back(Point(w, yoffset));
+        
+        // One hill is 2pi / 0.1 columns wide, so the full height is reached
+        // somewhere along the ridge even when it's off screen
+        peakY = currentHillHeight > 0 ? ridgeY(currentHillHeight) : yoffset;
     }
     
     void drawMountains(Pen& pen) {
-        gfx.set_pen(pen);
-        
-        // Draw filled polygon
-        std::vector<Point> points = pointCloud;
-        points.push_back(Point(w, h));
-        points.push_back(Point(0, h));
-        gfx.polygon(points);
-        
-        // Draw outline and shading
-        int minY = 100, maxY = -100;
-        for (const auto& point : pointCloud) {
-            gfx.set_pen(greens[0]);
-            gfx.pixel(point);
-            if (point.y < minY) minY = point.y;
-            if (point.y > maxY) maxY = point.y;
-        }
-        
-        // Add shading
-        for (const auto& point : pointCloud) {
-            if (point.y > minY + 1) {
-                gfx.set_pen(greens[3]);
-                gfx.pixel(point);
-            }
-            if (point.y == minY && point.y < 12) {
-                gfx.set_pen(greens[1]);
-                gfx.pixel(Point(point.x, point.y + 1));
+        for (int x = 0; x < w; x++) {
+            int top = ridge[x];
+            
+            // Outline, darker away from the peaks, with a highlight just
+            // under the summit
+            fillSpanV(gfx, x, top, 1, top > peakY + 1 ? greens[3] : greens[0]);
+            int fillTop = top + 1;
+            if (top == peakY && top < 12) {
+                fillSpanV(gfx, x, fillTop++, 1, greens[1]);
             }
+            fillSpanV(gfx, x, fillTop, h - fillTop, pen);
         }
     }
 };
@@ -185,6 +179,45 @@ public:
 // Forward declaration
 class Road;
 
+// Every scenery type pre-drawn at SCALE_STEPS scales from 0.2 to 1.0 (the
+// perspective range) when the road is created; objects blit the nearest one
+class SceneryAtlas {
+public:
+    static constexpr int TYPE_COUNT = 22;
+    static constexpr int SCALE_STEPS = 17;
+
+    void build(PicoGraphics_PenRGB888& gfx);  // Defined after SceneryObject
+
+    static int scaleStep(float scale) {
+        int step = (int)((scale - 0.2f) * (SCALE_STEPS - 1) / 0.8f + 0.5f);
+        return step < 0 ? 0 : (step >= SCALE_STEPS ? SCALE_STEPS - 1 : step);
+    }
+
+    static float stepScale(int step) { return 0.2f + 0.8f * step / (SCALE_STEPS - 1); }
+
+    // -1 when there's no sprite: tunnels, or before build().
+    // Street lights lean towards the road, so each side has its own.
+    int spriteFor(int type, int step, bool right_side) const {
+        return built ? sprite_table[type][step][right_side ? 1 : 0] : -1;
+    }
+
+    void blit(PicoGraphics_PenRGB888& gfx, int sprite, int x, int y, int shade) const {
+        sprites.blit(gfx, sprite, x, y, shade);
+    }
+
+    const SpriteAtlas& getSprites() const { return sprites; }
+
+private:
+    // Where shapes are drawn while capturing; left of 16 for the left side
+    static constexpr int LEFT_ANCHOR_X = 12;
+    static constexpr int RIGHT_ANCHOR_X = 20;
+    static constexpr int ANCHOR_Y = 28;
+
+    SpriteAtlas sprites;
+    int16_t sprite_table[TYPE_COUNT][SCALE_STEPS][2] = {};
+    bool built = false;
+};
+
 class SceneryObject {
 private:
     Pen tree1, tree2, bushCol, lamppost, streetlamp, cactus_green, palm_trunk, palm_leaves, metal_grey, tower_red, billboard_white, pyramid_sand, pyramid_shadow, volcano_dark, lava_red, lava_orange;
@@ -199,7 +232,7 @@ public:
     
     SceneryObject(Type obj_type = TREE) : type(obj_type), trackPosition(0), roadY(0), active(false) {}
     
-    void createPens(PicoGraphics& gfx) {
+    void createPens(PicoGraphics_PenRGB888& gfx) {
         if (!pens_created) {
             tree1 = gfx.create_pen(34, 139, 34);     // Forest green
             tree2 = gfx.create_pen(0, 100, 0);       // Dark green
@@ -249,20 +282,18 @@ public:
         }
     }
     
-    void draw(PicoGraphics& gfx, int w, int h, float road_curve, float road_hill) {
+    void draw(PicoGraphics_PenRGB888& gfx, int w, int h, float road_curve, float road_hill, const SceneryAtlas* atlas = nullptr) {
         if (!active) return;
         if (roadY >= h / 2) return;  // Don't draw if object has reached player
         if (roadY <= 1) return;  // Don't draw if object is too far in distance
         
-        createPens(gfx);
-        
         // Calculate perspective and screen position
         float perspective = roadY / (h/2);
         if (perspective > 1.0f) perspective = 1.0f;
         
         // Screen coordinates with perspective scaling
-        float middlepoint = 0.5f + (road_curve/10.0f) * pow(1-perspective, 3);
-        float hillpoint = (road_hill/4.0f) * pow(1-perspective, 2);
+        float middlepoint = 0.5f + (road_curve/10.0f) * cubed(1-perspective);
+        float hillpoint = (road_hill/4.0f) * squared(1-perspective);
         
         int screen_x = (int)(w * (middlepoint + trackPosition * 0.7f * perspective));
         int screen_y = (int)(h - h/2 + roadY + hillpoint);
@@ -273,6 +304,28 @@ public:
         // Skip if off screen
         if (screen_x < -10 || screen_x > w + 10 || screen_y < 0 || screen_y > h) return;
         
+        int sprite = atlas ? atlas->spriteFor(type, SceneryAtlas::scaleStep(scale), screen_x >= 16) : -1;
+        if (sprite >= 0) {
+            // Distant objects fade: shade 4 of 8 far away up to full
+            atlas->blit(gfx, sprite, screen_x, screen_y, 4 + (int)(perspective * 3.99f));
+        } else {
+            drawShape(gfx, screen_x, screen_y, scale);
+        }
+    }
+    
+    // A fixed one-in-three pick for lit windows and lava. The shapes are
+    // captured into the atlas twice (once to size it), so they must come out
+    // the same each time, and must leave the game's rand() sequence alone.
+    static bool scatter(int a, int b) {
+        uint32_t hash = (uint32_t)a * 73856093u ^ (uint32_t)b * 19349663u;
+        return (hash >> 4) % 3 == 0;
+    }
+    
+    // The object drawn from geometry at (screen_x, screen_y), also used to
+    // fill the atlas
+    void drawShape(PicoGraphics_PenRGB888& gfx, int screen_x, int screen_y, float scale) {
+        createPens(gfx);
+        
         switch (type) {
             case TREE:
                 drawTree(gfx, screen_x, screen_y, scale);
@@ -342,7 +395,7 @@ public:
     }
     
 private:
-    void drawTree(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawTree(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         // Tree trunk
         gfx.set_pen(gfx.create_pen(139, 69, 19)); // Saddle brown
         int trunk_height = std::max(1, (int)(4 * scale));
@@ -360,7 +413,7 @@ private:
         }
     }
     
-    void drawBush(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawBush(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         gfx.set_pen(bushCol);
         int bush_size = std::max(1, (int)(2 * scale));
         for (int dx = -bush_size; dx <= bush_size; dx++) {
@@ -372,7 +425,7 @@ private:
         }
     }
     
-    void drawStreetLight(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawStreetLight(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         // Light pole
         gfx.set_pen(lamppost);
         int pole_height = std::max(2, (int)(6 * scale));
@@ -394,7 +447,7 @@ private:
         }
     }
     
-    void drawSkyscraper(PicoGraphics& gfx, int x, int y, float scale, Pen concrete_pen, Pen glass_pen) {
+    void drawSkyscraper(PicoGraphics_PenRGB888& gfx, int x, int y, float scale, Pen concrete_pen, Pen glass_pen) {
         // Very tall rectangular building with glass windows
         int building_width = std::max(2, (int)(4 * scale));
         int building_height = std::max(5, (int)(20 * scale));  // Much taller
@@ -421,7 +474,7 @@ private:
         }
     }
     
-    void drawBuilding(PicoGraphics& gfx, int x, int y, float scale, Pen concrete_pen, Pen glass_pen) {
+    void drawBuilding(PicoGraphics_PenRGB888& gfx, int x, int y, float scale, Pen concrete_pen, Pen glass_pen) {
         // Medium height building
         int building_width = std::max(2, (int)(5 * scale));
         int building_height = std::max(3, (int)(12 * scale));
@@ -441,7 +494,7 @@ private:
         }
     }
     
-    void drawOfficeTower(PicoGraphics& gfx, int x, int y, float scale, Pen dark_pen, Pen light_pen) {
+    void drawOfficeTower(PicoGraphics_PenRGB888& gfx, int x, int y, float scale, Pen dark_pen, Pen light_pen) {
         // Medium-tall building with lit windows (office lights)
         int building_width = std::max(3, (int)(6 * scale));
         int building_height = std::max(4, (int)(15 * scale));
@@ -456,7 +509,7 @@ private:
             for (int floor = 1; floor < building_height - 1; floor += 2) {
                 for (int window = 1; window < building_width - 1; window += 2) {
                     // Random chance for lit windows (simulating office workers)
-                    if (rand() % 3 == 0) {  // 33% chance of lit window
+                    if (scatter(floor, window)) {  // 33% chance of lit window
                         gfx.pixel(Point(x - building_width/2 + window, y - building_height + floor));
                     }
                 }
@@ -464,7 +517,7 @@ private:
         }
     }
     
-    void drawCactus(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawCactus(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         gfx.set_pen(cactus_green);
         int cactus_height = std::max(3, (int)(8 * scale));
         int cactus_width = std::max(1, (int)(2 * scale));
@@ -484,7 +537,7 @@ private:
         }
     }
     
-    void drawPalmTree(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawPalmTree(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         // Trunk
         gfx.set_pen(palm_trunk);
         int trunk_height = std::max(4, (int)(10 * scale));
@@ -509,7 +562,7 @@ private:
         }
     }
     
-    void drawWindTurbine(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawWindTurbine(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         gfx.set_pen(gfx.create_pen(240, 240, 240)); // Light grey
         int tower_height = std::max(6, (int)(15 * scale));
         
@@ -528,7 +581,7 @@ private:
         }
     }
     
-    void drawRadioTower(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawRadioTower(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         gfx.set_pen(tower_red);
         int tower_height = std::max(8, (int)(20 * scale));
         
@@ -552,7 +605,7 @@ private:
         }
     }
     
-    void drawBillboard(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawBillboard(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int board_width = std::max(3, (int)(8 * scale));
         int board_height = std::max(2, (int)(4 * scale));
         int pole_height = std::max(3, (int)(6 * scale));
@@ -573,7 +626,7 @@ private:
         }
     }
     
-    void drawMonument(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawMonument(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         gfx.set_pen(gfx.create_pen(105, 105, 105)); // Dark grey stone
         int monument_height = std::max(5, (int)(12 * scale));
         int base_width = std::max(3, (int)(6 * scale));
@@ -595,7 +648,7 @@ private:
         }
     }
     
-    void drawWaterTower(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawWaterTower(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int tank_width = std::max(3, (int)(7 * scale));
         int tank_height = std::max(2, (int)(4 * scale));
         int leg_height = std::max(4, (int)(8 * scale));
@@ -615,7 +668,7 @@ private:
         gfx.rectangle(Rect(x - tank_width/2, y - leg_height - tank_height, tank_width, 1));
     }
     
-    void drawFactory(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawFactory(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int building_width = std::max(4, (int)(10 * scale));
         int building_height = std::max(3, (int)(8 * scale));
         
@@ -641,7 +694,7 @@ private:
             gfx.set_pen(gfx.create_pen(255, 255, 0)); // Yellow light
             for (int i = 2; i < building_height - 1; i += 2) {
                 for (int j = 2; j < building_width - 1; j += 3) {
-                    if (rand() % 3 == 0) { // Random lit windows
+                    if (scatter(i, j)) { // Random lit windows
                         gfx.pixel(Point(x - building_width/2 + j, y - building_height + i));
                     }
                 }
@@ -649,7 +702,7 @@ private:
         }
     }
     
-    void drawClockTower(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawClockTower(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int tower_width = std::max(2, (int)(4 * scale));
         int tower_height = std::max(6, (int)(18 * scale));
         
@@ -681,7 +734,7 @@ private:
         }
     }
     
-    void drawChurch(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawChurch(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int church_width = std::max(3, (int)(7 * scale));
         int church_height = std::max(4, (int)(10 * scale));
         
@@ -713,7 +766,7 @@ private:
         }
     }
     
-    void drawBarn(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawBarn(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int barn_width = std::max(4, (int)(9 * scale));
         int barn_height = std::max(3, (int)(7 * scale));
         
@@ -748,7 +801,7 @@ private:
         }
     }
     
-    void drawWindmill(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawWindmill(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int mill_width = std::max(2, (int)(4 * scale));
         int mill_height = std::max(4, (int)(10 * scale));
         
@@ -781,7 +834,7 @@ private:
         }
     }
     
-    void drawPyramid(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawPyramid(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int pyramid_width = std::max(3, (int)(8 * scale));
         int pyramid_height = std::max(2, (int)(6 * scale));
         
@@ -815,7 +868,7 @@ private:
         }
     }
     
-    void drawVolcano(PicoGraphics& gfx, int x, int y, float scale) {
+    void drawVolcano(PicoGraphics_PenRGB888& gfx, int x, int y, float scale) {
         int volcano_width = std::max(4, (int)(10 * scale));
         int volcano_height = std::max(3, (int)(8 * scale));
         
@@ -844,7 +897,7 @@ private:
                 int stream_x = x + (i == 0 ? -volcano_width/3 : volcano_width/3);
                 int stream_length = volcano_height / 2;
                 for (int j = 0; j < stream_length; j++) {
-                    if (rand() % 3 == 0) { // Intermittent lava pixels
+                    if (scatter(i, j)) { // Intermittent lava pixels
                         gfx.pixel(Point(stream_x, y - volcano_height + j + 1));
                     }
                 }
@@ -860,10 +913,38 @@ private:
     }
 };
 
+static_assert(SceneryObject::VOLCANO + 1 == SceneryAtlas::TYPE_COUNT, "Atlas covers every scenery type");
+
+inline void SceneryAtlas::build(PicoGraphics_PenRGB888& gfx) {
+    SceneryObject painter;
+    sprites.build([&] {
+        for (int type = 0; type < TYPE_COUNT; type++) {
+            painter.type = (SceneryObject::Type)type;
+            bool tunnel = type == SceneryObject::TUNNEL_INTRO || type == SceneryObject::TUNNEL_OUTRO;
+            for (int step = 0; step < SCALE_STEPS; step++) {
+                int left = -1, right = -1;
+                if (!tunnel) {
+                    float scale = stepScale(step);
+                    left = sprites.capture(gfx, LEFT_ANCHOR_X, ANCHOR_Y, [&](PicoGraphics_PenRGB888& g) {
+                        painter.drawShape(g, LEFT_ANCHOR_X, ANCHOR_Y, scale);
+                    });
+                    right = type != SceneryObject::STREETLIGHT ? left :
+                        sprites.capture(gfx, RIGHT_ANCHOR_X, ANCHOR_Y, [&](PicoGraphics_PenRGB888& g) {
+                            painter.drawShape(g, RIGHT_ANCHOR_X, ANCHOR_Y, scale);
+                        });
+                }
+                sprite_table[type][step][0] = (int16_t)left;
+                sprite_table[type][step][1] = (int16_t)right;
+            }
+        }
+    });
+    built = true;
+}
+
 class OncomingCar {
 public:
-    float trackPosition;    // -1.0 to 1.0, where 0 is center of track
-    float roadY;           // Y position in road coordinates (same as SceneryObject)
+    fix16 trackPosition;    // -1.0 to 1.0, where 0 is center of track
+    fix16 roadY;           // Y position in road coordinates (same as SceneryObject)
     bool active;           // Whether this car is currently active
     int color_index;       // Car color variant
 
@@ -881,7 +962,7 @@ public:
         color_index = rand() % 4;  // 4 car colors
     }
     
-    void createPens(PicoGraphics& gfx) {
+    void createPens(PicoGraphics_PenRGB888& gfx) {
         if (!pens_created) {
             black = gfx.create_pen(0, 0, 0);
             red = gfx.create_pen(255, 0, 0);
@@ -903,14 +984,13 @@ public:
         if (!active) return;
         
         // Move toward player at same rate as scenery for consistency
-        roadY += road_speed * 0.008f;
+        roadY += fix16(road_speed) * 0.008f;
         
         // Apply road curve effects (same as scenery)
-        trackPosition += road_curve * 0.002f;
+        trackPosition += fix16(road_curve) * 0.002f;
         
         // Keep cars roughly on track
-        if (trackPosition > 0.8f) trackPosition = 0.8f;
-        if (trackPosition < -0.8f) trackPosition = -0.8f;
+        trackPosition = fixedClamp(trackPosition, fix16(-0.8f), fix16(0.8f));
         
         // Deactivate when past the player (same as scenery)
         if (roadY >= h / 2) {
@@ -918,7 +998,7 @@ public:
         }
     }
     
-    void draw(PicoGraphics& gfx, int w, int h, float road_curve, float road_hill) {
+    void draw(PicoGraphics_PenRGB888& gfx, int w, int h, float road_curve, float road_hill) {
         if (!active) return;
         if (roadY >= h / 2) return;  // Don't draw if car has reached player
         if (roadY <= 1) return;  // Don't draw if car is too far (same as scenery)
@@ -926,15 +1006,15 @@ public:
         createPens(gfx);
         
         // Use exact same positioning logic as SceneryObject for consistency
-        float perspective = roadY / (h/2);
+        float perspective = roadY.toFloat() / (h/2);
         if (perspective > 1.0f) perspective = 1.0f;
         
         // Screen coordinates with perspective scaling (same as scenery)
-        float middlepoint = 0.5f + (road_curve/10.0f) * pow(1-perspective, 3);
-        float hillpoint = (road_hill/4.0f) * pow(1-perspective, 2);
+        float middlepoint = 0.5f + (road_curve/10.0f) * cubed(1-perspective);
+        float hillpoint = (road_hill/4.0f) * squared(1-perspective);
         
-        int screen_x = (int)(w * (middlepoint + trackPosition * 0.7f * perspective));
-        int screen_y = (int)(h - h/2 + roadY + hillpoint);
+        int screen_x = (int)(w * (middlepoint + trackPosition.toFloat() * 0.7f * perspective));
+        int screen_y = (int)(h - h/2 + roadY.toFloat() + hillpoint);
         
         // Scale based on perspective (same as scenery)
         float scale = 0.2f + 0.8f * perspective;
@@ -981,12 +1061,12 @@ public:
     }
     
     // Simple collision detection - check if car is near player position and close enough
-    bool checkCollisionWithPlayer(float player_track_pos) {
+    bool checkCollisionWithPlayer(fix16 player_track_pos) {
         if (!active) return false;
         
         // Check if car is close to player (in the collision zone)
-        bool close_enough = (roadY >= 10.0f && roadY <= 18.0f);  // Collision zone near player
-        bool positions_overlap = std::abs(trackPosition - player_track_pos) < 0.4f;  // Track position overlap
+        bool close_enough = (roadY >= 10 && roadY <= 18);  // Collision zone near player
+        bool positions_overlap = fixedAbs(trackPosition - player_track_pos) < 0.4f;  // Track position overlap
         
         return close_enough && positions_overlap;
     }
@@ -996,44 +1076,49 @@ public:
         if (!active || !other.active || this == &other) return false;
         
         // Check if cars are at similar distances and positions
-        bool same_distance = std::abs(roadY - other.roadY) < 2.0f;
-        bool same_position = std::abs(trackPosition - other.trackPosition) < 0.3f;
+        bool same_distance = fixedAbs(roadY - other.roadY) < 2;
+        bool same_position = fixedAbs(trackPosition - other.trackPosition) < 0.3f;
         
         return same_distance && same_position;
     }
     
     // Apply collision effects
-    void applyCollisionBounce(float bounce_direction) {
-        trackPosition += bounce_direction * 0.2f;  // Bounce sideways
+    void applyCollisionBounce(int bounce_direction) {
+        trackPosition += bounce_direction * fix16(0.2f);  // Bounce sideways
         
         // Keep on track
-        if (trackPosition > 0.8f) trackPosition = 0.8f;
-        if (trackPosition < -0.8f) trackPosition = -0.8f;
+        trackPosition = fixedClamp(trackPosition, fix16(-0.8f), fix16(0.8f));
     }
 };
 
 class Car {
 public:
-    float velocity = 0.0f;    // Current steering velocity (-1 left, +1 right)
-    float position = 0.0f;    // Track position (-1 left edge, +1 right edge)
-    float speed = 20.0f;      // Forward speed
+    fix16 velocity = 0.0f;    // Current steering velocity (-1 left, +1 right)
+    fix16 position = 0.0f;    // Track position (-1 left edge, +1 right edge)
+    fix16 speed = 20.0f;      // Forward speed
     bool autoAccelEnabled = true;
     
 private:
     Pen carCol, black, grey, red, white;
     bool pens_created = false;
     
-    // Physics constants
-    const float STEER_POWER = 0.05f;     // How quickly steering input affects velocity
-    const float FRICTION = 0.85f;        // How quickly velocity decays (0-1, lower = more friction)
-    const float MAX_VELOCITY = 0.1f;     // Maximum steering velocity
-    const float AUTO_ACCEL_RATE = 0.3f;  // How fast auto-acceleration works
-    const float AUTO_ACCEL_TARGET = 60.0f; // Target speed for auto-acceleration
+    // Physics constants (fixed point: the RP2040 has no FPU), per update at
+    // 20 fps. The handling was tuned with two physics steps per update, so
+    // these are two of those steps folded into one.
+    static constexpr fix16 STEER_POWER = 0.22f;     // How quickly steering input affects velocity
+    static constexpr fix16 FRICTION = 0.72f;        // How quickly velocity decays (0-1, lower = more friction)
+    static constexpr fix16 MAX_VELOCITY = 0.2f;     // Maximum steering velocity
+    static constexpr fix16 AUTO_ACCEL_RATE = 0.6f;  // How fast auto-acceleration works
+    static constexpr fix16 AUTO_ACCEL_TARGET = 60.0f; // Target speed for auto-acceleration
+    
+    // The constants scaled to the update rate, worked out when it changes
+    float frame_scale = 0;
+    fix16 scale = 1, friction = FRICTION;
     
 public:
     Car() {}
     
-    void createPens(PicoGraphics& gfx) {
+    void createPens(PicoGraphics_PenRGB888& gfx) {
         if (!pens_created) {
             carCol = gfx.create_pen(255, 0, 0);    // Red car
             black = gfx.create_pen(0, 0, 0);       // Black windows
@@ -1044,22 +1129,30 @@ public:
         }
     }
     
-    void update(float leftInput, float rightInput) {
+    // frameScale is GameBase::frameScale(): 1 at 20 fps
+    void setFrameScale(float frameScale) {
+        if (frameScale == frame_scale) return;
+        frame_scale = frameScale;
+        scale = frameScale;
+        friction = powf(FRICTION.toFloat(), frameScale);
+    }
+    
+    void update(fix16 leftInput, fix16 rightInput) {
         // Update steering physics
-        float steerInput = rightInput - leftInput;  // -1 left, +1 right
+        fix16 steerInput = rightInput - leftInput;  // -1 left, +1 right
         
         // Apply steering input to velocity
-        velocity += steerInput * STEER_POWER;
+        velocity += steerInput * STEER_POWER * scale;
         
         // Apply friction to velocity
-        velocity *= FRICTION;
+        velocity *= friction;
         
         // Clamp velocity to maximum
         if (velocity > MAX_VELOCITY) velocity = MAX_VELOCITY;
         if (velocity < -MAX_VELOCITY) velocity = -MAX_VELOCITY;
         
         // Update position based on velocity
-        position += velocity;
+        position += velocity * scale;
         
         // Keep car on track (with some tolerance for off-road feeling)
         if (position > 1.2f) {
@@ -1073,14 +1166,14 @@ public:
         
         // Auto-acceleration when enabled
         if (autoAccelEnabled && speed < AUTO_ACCEL_TARGET) {
-            speed += AUTO_ACCEL_RATE;
+            speed += AUTO_ACCEL_RATE * scale;
             if (speed > AUTO_ACCEL_TARGET) {
                 speed = AUTO_ACCEL_TARGET;
             }
         }
     }
     
-    void draw(PicoGraphics& gfx) {
+    void draw(PicoGraphics_PenRGB888& gfx) {
         createPens(gfx);
         
         int w = gfx.bounds.w;
@@ -1129,14 +1222,14 @@ public:
         gfx.rectangle(Rect(carpos + 6, cary, 2, 1));
     }
     
-    float getTrackPosition() const {
+    fix16 getTrackPosition() const {
         return position;
     }
 };
 
 class Road {
 private:
-    PicoGraphics& gfx;
+    PicoGraphics_PenRGB888& gfx;
     int w, h;
     int frameCount = 0;
     
@@ -1183,11 +1276,20 @@ private:
     int sunSizeMod = 0;
     Pen moonColour, white;
     
+    // Sky, sun and stars only change with the theme and the sun's position,
+    // so they're drawn into a cached layer
+    Layer skyLayer{"drawSky"};
+    int skySunPosition = -1;
+    
+    // The night skies' gradients at 16 bits, dithered into the sky layer
+    DeepFrame skyDeep;
+    
     // Scenery and objects
     std::unique_ptr<Mountain> mountain;
     std::unique_ptr<Rain> rainSystem;
     std::vector<SceneryObject> sceneryObjects;
     std::vector<OncomingCar> oncomingCars;
+    SceneryAtlas sceneryAtlas;
     
     // Tunnel system
     bool inTunnel = false;
@@ -1200,15 +1302,18 @@ private:
     uint32_t lastCarSpawn = 0;
     
     // Auto theme changing
+    bool autoThemeChange = true;
     uint32_t lastThemeChange = 0;
     float distanceSinceThemeChange = 0.0f;
     const float AUTO_THEME_DISTANCE = 1500.0f;  
     
 public:
+    static const int THEME_COUNT = 14;
+    
     float speed = 20.0f;  // Current road speed (synchronized with car speed)
     
-    Road(PicoGraphics& graphics, int width, int height) 
-        : gfx(graphics), w(width), h(height) {
+    Road(PicoGraphics_PenRGB888& graphics, int width, int height) 
+        : gfx(graphics), w(width), h(height), skyDeep(width, height / 2) {
         
         // Initialize road pattern
         roadPattern.resize(w);
@@ -1226,6 +1331,11 @@ public:
         sceneryObjects.resize(20);  // Pool of 20 scenery objects
         oncomingCars.resize(5);     // Pool of 5 oncoming cars
         
+        skyLayer.setDraw([this](PicoGraphics_PenRGB888&) { drawSky(); });
+        
+        // Pre-draw every scenery type at every scale
+        sceneryAtlas.build(gfx);
+        
         // Set initial theme
         initPalette();
         setTheme(currentTheme);
@@ -1253,6 +1363,7 @@ public:
     
     void setTheme(Theme theme) {
         currentTheme = theme;
+        skyLayer.invalidate();
         
         // Clear rain when switching themes (except where rain is intended)
         if (theme != NIGHT && theme != STARRYNIGHT) {
@@ -1736,7 +1847,23 @@ public:
         setTheme((Theme)current);
     }
     
+    // Switch to a theme and keep it (no automatic theme changes)
+    void holdTheme(int theme) {
+        autoThemeChange = false;
+        setTheme((Theme)theme);
+    }
+    
+    static const char* themeName(int theme) {
+        static const char* const names[THEME_COUNT] = {
+            "CITYSCAPE", "NIGHT", "VICE", "DESERT", "STARRYNIGHT", "DAYTOO", "SNOW",
+            "F32", "RED", "CYBER", "SUNSET", "OCEAN", "NEON", "DAY"
+        };
+        return theme >= 0 && theme < THEME_COUNT ? names[theme] : "";
+    }
+    
     void updateAutoThemeChange() {
+        if (!autoThemeChange) return;
+        
         // Track distance traveled since last theme change
         distanceSinceThemeChange += speed * elapsedTime;
         
@@ -2003,8 +2130,8 @@ public:
         sectionDistance += speed * elapsedTime;
         
         // Generate curves using sine waves like original
-        roadcurve = sin(frameCount * 0.02f) * 2.0f;
-        roadhill = sin(frameCount * 0.015f) * 1.5f;
+        roadcurve = fastSin(frameCount * 0.02f) * 2.0f;
+        roadhill = fastSin(frameCount * 0.015f) * 1.5f;
         
         // Update curvature tracking like original
         float ftrackcurvediff = (roadcurve - pCurvature) * elapsedTime;
@@ -2025,7 +2152,7 @@ public:
         updateAutoThemeChange();
         
         // Update mountain/hills using original pattern
-        mountain->generatePointCloud(-tCurvature, hillHeight, 15);
+        mountain->updateRidge(-tCurvature, hillHeight, 15);
         
         // Spawn and update scenery
         spawnScenery();
@@ -2053,7 +2180,7 @@ public:
     }
     
     bool checkCollisions(const Car& player_car) {
-        float player_pos = player_car.getTrackPosition();
+        fix16 player_pos = player_car.getTrackPosition();
         
         // Check player-car collisions
         for (auto& car : oncomingCars) {
@@ -2067,7 +2194,7 @@ public:
             for (size_t j = i + 1; j < oncomingCars.size(); j++) {
                 if (oncomingCars[i].checkCollisionWithCar(oncomingCars[j])) {
                     // Apply bounce effects to both cars
-                    float bounce_direction = (oncomingCars[i].trackPosition < oncomingCars[j].trackPosition) ? -1.0f : 1.0f;
+                    int bounce_direction = (oncomingCars[i].trackPosition < oncomingCars[j].trackPosition) ? -1 : 1;
                     oncomingCars[i].applyCollisionBounce(bounce_direction);
                     oncomingCars[j].applyCollisionBounce(-bounce_direction);
                 }
@@ -2078,12 +2205,14 @@ public:
     }
     
     void draw(const Car& player_car) {
-        // Clear screen
-        gfx.set_pen(0, 0, 0);
-        gfx.clear();
-        
-        // Draw sky gradient
-        drawSky();
+        // Sky gradient over a black screen, from the cache unless the sun
+        // has moved
+        int sunpos = sunPosition();
+        if (sunpos != skySunPosition) {
+            skySunPosition = sunpos;
+            skyLayer.invalidate();
+        }
+        skyLayer.render(gfx);
         
         // Draw mountains/hills (behind road)
         if (!mountain->greens.empty()) {
@@ -2095,7 +2224,7 @@ public:
         
         // Draw scenery objects
         for (auto& obj : sceneryObjects) {
-            obj.draw(gfx, w, h, roadcurve, roadhill);
+            obj.draw(gfx, w, h, roadcurve, roadhill, &sceneryAtlas);
         }
         
         // Draw oncoming cars
@@ -2116,6 +2245,12 @@ public:
     }
     
 private:
+    // Sun and moon x: drifts as the road curves
+    int sunPosition() const {
+        int sunpos = abs(w / 3 - (int)(round(-tCurvature * 0.01f) + w));
+        return (sunpos % 48) - 8;
+    }
+    
     void drawSky() {
         if (SCL.empty()) return;
         
@@ -2123,18 +2258,25 @@ private:
         int skyHeight = h / 2;
         int bandsPerColor = std::max(1, skyHeight / (int)SCL.size());
         
-        for (int y = 0; y < skyHeight; y++) {
-            int colorIndex = std::min((int)SCL.size() - 1, y / bandsPerColor);
-            gfx.set_pen(SCL[colorIndex]);
-            
-            for (int x = 0; x < w; x++) {
-                gfx.pixel(Point(x, y));
+        if (currentTheme == NIGHT || currentTheme == STARRYNIGHT) {
+            // Dark enough to band, so each colour fades smoothly into the next
+            int colours = (int)SCL.size();
+            for (int i = 0; i < colours; i++) {
+                int top = i * bandsPerColor;
+                int rows = i + 1 < colours ? bandsPerColor : skyHeight - top;
+                uint32_t next = SCL[i + 1 < colours ? i + 1 : i];
+                skyDeep.fillGradientV(top, rows, deepFromPen(SCL[i]), deepFromPen(next));
+            }
+            skyDeep.present(gfx, 0, 0);
+        } else {
+            for (int y = 0; y < skyHeight; y++) {
+                int colorIndex = std::min((int)SCL.size() - 1, y / bandsPerColor);
+                fillSpanH(gfx, 0, y, w, SCL[colorIndex]);
             }
         }
         
         // Draw sun/moon
-        int sunpos = abs(w / 3 - (int)(round(-tCurvature * 0.01f) + w));
-        sunpos = (sunpos % 48) - 8;
+        int sunpos = sunPosition();
         
         if (bSun) {
             int suny = h / 3;
@@ -2188,6 +2330,8 @@ private:
     }
     
     void drawRoad() {
+        PROFILE_SCOPE("drawRoad");
+        
         // Draw road from middle of screen to bottom
         int roadStartY = h / 2;
         
@@ -2195,8 +2339,8 @@ private:
             float perspective = (float)(y - roadStartY) / (h/2);
             
             // Road curvature and hills - using original calculation
-            float middlepoint = 0.5f + (roadcurve/10.0f) * pow(1-perspective, 3);
-            float hillpoint = (roadhill/4.0f) * pow(1-perspective, 2);
+            float middlepoint = 0.5f + (roadcurve/10.0f) * cubed(1-perspective);
+            float hillpoint = (roadhill/4.0f) * squared(1-perspective);
             
             // Road width varies with perspective
             float roadwidth = 0.1f + perspective * 0.8f;
@@ -2276,29 +2420,18 @@ private:
             Pen darkGrass2 = createDarkenedPen(grass2_r, grass2_g, grass2_b, brightness);
             
             // Alternating grass pattern with speed-responsive movement like original
-            float grass_frequency = 20.0f * pow(1.0f - perspective, 3);
+            float grass_frequency = 20.0f * cubed(1.0f - perspective);
             float grass_movement = distance * 0.01f * (1.0f + speed * 0.02f);
-            bool useGrass1 = sin(grass_frequency + grass_movement) > 0;
+            bool useGrass1 = fastSin(grass_frequency + grass_movement) > 0;
             Pen grassPen = useGrass1 ? darkGrass1 : darkGrass2;
             
-            gfx.set_pen(grassPen);
-            
-            // Left grass
-            for (int x = 0; x < left_x; x++) {
-                gfx.pixel(Point(x, adjusted_y));
-            }
-            
-            // Right grass  
-            for (int x = right_x; x < w; x++) {
-                gfx.pixel(Point(x, adjusted_y));
-            }
+            // Left and right grass
+            fillSpanH(gfx, 0, adjusted_y, left_x, grassPen);
+            fillSpanH(gfx, right_x, adjusted_y, w - right_x, grassPen);
             
             // Draw road surface (grey)
             Pen roadPen = gfx.create_pen((int)(50 * brightness), (int)(50 * brightness), (int)(50 * brightness));
-            gfx.set_pen(roadPen);
-            for (int x = left_x; x < right_x; x++) {
-                gfx.pixel(Point(x, adjusted_y));
-            }
+            fillSpanH(gfx, left_x, adjusted_y, right_x - left_x, roadPen);
             
             // Draw road edges with depth lighting
             uint8_t edge1_r = 255, edge1_g = 255, edge1_b = 255; // Default white
@@ -2434,7 +2567,7 @@ private:
         //top half 
         for (int y = 0; y < h / 2; y++) {
             float perspective = (float)y / (h / 2);
-            float hillpoint = (roadhill / 4.0f) * pow(1 - perspective, 2);
+            float hillpoint = (roadhill / 4.0f) * squared(1 - perspective);
             
             int nrow = h / 2 + y + (int)hillpoint;
             if (nrow < 0 || nrow >= h) continue;
@@ -2445,12 +2578,12 @@ private:
             Pen darkened_black = createTunnelDarkenedPen(0, 0, 0, perspective);
             
             // Calculate stripe movement based on speed and distance - more realistic
-            float stripe_frequency = 2.0f * pow(1.0f - perspective, 3);
+            float stripe_frequency = 2.0f * cubed(1.0f - perspective);
             float speed_multiplier = speed * 0.02f; // Speed affects how fast stripes move
             float stripe_position = stripe_frequency + distance * speed_multiplier;
             
             // Different stripe patterns for different speeds
-            Pen roadmarker = (sin(stripe_position * 0.3f) > 0.9f) ? darkened_yellow : darkened_black;
+            Pen roadmarker = (fastSin(stripe_position * 0.3f) > 0.9f) ? darkened_yellow : darkened_black;
             
             gfx.set_pen(roadmarker);
         }
@@ -2458,8 +2591,8 @@ private:
         //bottom half 
         for (int y = 0; y < h / 2; y++) {
             float perspective = (float)y / (h / 2);
-            float middlepoint = 0.5f + (roadcurve / 10.0f) * pow(1 - perspective, 3);
-            float hillpoint = (roadhill / 4.0f) * pow(1 - perspective, 2);
+            float middlepoint = 0.5f + (roadcurve / 10.0f) * cubed(1 - perspective);
+            float hillpoint = (roadhill / 4.0f) * squared(1 - perspective);
             float roadwidth = 0.1f + perspective * 0.80f;
             float clipwidth = roadwidth * 0.3f;
             roadwidth *= 0.6f;
@@ -2469,7 +2602,7 @@ private:
             int rightclip = (int)((middlepoint + roadwidth) * w);
             int rightgrass = (int)((middlepoint + roadwidth + clipwidth) * w);
 
-            bool bBush = sin(20 * pow(1.0f - perspective, 3) + distance * 0.01f) > 0;
+            bool bBush = fastSin(20 * cubed(1.0f - perspective) + distance * 0.01f) > 0;
             
             // Apply tunnel lighting effect - darken colors based on perspective
             Pen grassCol, edgeC;
@@ -2483,7 +2616,7 @@ private:
             
             // Apply proper edge pattern like main road rendering
             float edgeClipMod = (float)w;
-            bool edge_pattern = sin(edgeClipMod * pow(1.0f - perspective, 3) + distance * 0.1f) > 0;
+            bool edge_pattern = fastSin(edgeClipMod * cubed(1.0f - perspective) + distance * 0.1f) > 0;
             if (edge_pattern) {
                 edgeC = createDarkenedPenFromTheme(edgeCol, perspective, false, true);
             } else {
@@ -2524,11 +2657,11 @@ private:
             Pen darkened_yellow = createTunnelDarkenedPen(255, 255, 0, perspective);
 
             // Calculate stripe movement based on speed and distance - more realistic
-            float stripe_frequency = 100.0f * pow(1.0f - perspective, 3);
+            float stripe_frequency = 100.0f * cubed(1.0f - perspective);
             float speed_multiplier = speed * 0.002f; // Speed affects how fast stripes move
             float stripe_position = stripe_frequency + distance * speed_multiplier;
 
-            Pen roadmarker = (sin(stripe_position) > 0.8f) ? darkened_yellow : edgeC;
+            Pen roadmarker = (fastSin(stripe_position) > 0.8f) ? darkened_yellow : edgeC;
 
             gfx.set_pen(roadmarker);
             int m = (rightgrass - leftgrass) / 4;
@@ -2669,8 +2802,6 @@ class ArcadeRacerGame : public GameBase {
 private:
     Car car;
     std::unique_ptr<Road> road;
-    uint32_t last_button_time = 0;
-    const uint32_t DEBOUNCE_MS = 200;
     bool collision_detected = false;
     uint32_t collision_time = 0;
     const uint32_t COLLISION_FLASH_DURATION = 500000; // 0.5 seconds in microseconds
@@ -2688,104 +2819,60 @@ public:
         
         road = std::make_unique<Road>(graphics, CosmicUnicorn::WIDTH, CosmicUnicorn::HEIGHT);
         
-        srand(time_us_64());
-    }
-    
-    bool debounce(uint32_t current_time) {
-        if (current_time - last_button_time > DEBOUNCE_MS * 1000) {
-            last_button_time = current_time;
-            return true;
-        }
-        return false;
+        // The RNG is seeded once by the launcher so runs can be replayed
     }
     
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
-        uint32_t current_time = time_us_64();
-        
-        if (button_bright_up) {
-            cosmic->adjust_brightness(0.1f);
-        }
-        
-        if (button_bright_down) {
-            cosmic->adjust_brightness(-0.1f);
-        }
-        
+    void handleInput(const InputState& state) override {
         // Simple steering input - pass button states to car
-        float leftInput = button_a ? 1.0f : 0.0f;
-        float rightInput = button_vol_up ? 1.0f : 0.0f;
+        fix16 leftInput = state.isHeld(BUTTON_A) ? 1 : 0;
+        fix16 rightInput = state.isHeld(BUTTON_VOLUME_UP) ? 1 : 0;
+        bool braking = state.isHeld(BUTTON_B);
+        // Button C accelerates (more intuitive than Volume Down, which is
+        // kept for backward compatibility)
+        bool accelerating = state.isHeld(BUTTON_C) || state.isHeld(BUTTON_VOLUME_DOWN);
         
         // Update car physics
+        car.setFrameScale(frameScale());
         car.update(leftInput, rightInput);
         
         // Gradual speed control - much smaller increments per frame
-        // Button B: Brake
-        if (button_b) {
-            if (car.speed > 0) {
-                car.speed -= 0.8f;  // Gradual braking
-                if (car.speed < 0) {
-                    car.speed = 0;
-                }
-                car.autoAccelEnabled = false;  // Disable auto-acceleration when braking
+        fix16 scale = frameScale();
+        if (braking && car.speed > 0) {
+            car.speed -= fix16(1.6f) * scale;  // Gradual braking
+            if (car.speed < 0) {
+                car.speed = 0;
             }
+            car.autoAccelEnabled = false;  // Disable auto-acceleration when braking
         }
         
-        // Button C: Accelerate (more intuitive than Volume Down)
-        if (button_c) {
-            if (car.speed < 100) {
-                car.speed += 0.5f;  // Gradual acceleration
-                if (car.speed > 100) {
-                    car.speed = 100;
-                }
-                car.autoAccelEnabled = true;  // Re-enable auto-acceleration when manually accelerating
-            }
-        }
-        
-        // Volume Down: Alternative acceleration (keep for backward compatibility)
-        if (button_vol_down) {
-            if (car.speed < 100) {
-                car.speed += 0.5f;  // Gradual acceleration
-                if (car.speed > 100) {
-                    car.speed = 100;
-                }
-                car.autoAccelEnabled = true;  // Re-enable auto-acceleration when manually accelerating
+        if (accelerating && car.speed < 100) {
+            car.speed += fix16(1.0f) * scale;  // Gradual acceleration
+            if (car.speed > 100) {
+                car.speed = 100;
             }
+            car.autoAccelEnabled = true;  // Re-enable auto-acceleration when manually accelerating
         }
         
-        // Theme switching (but not for exit - that's handled by GameBase)
-        if (button_d && debounce(current_time)) {
-            auto themes = road->getThemes();
+        // Theme switching on a short D press (a long press exits, handled by GameBase)
+        if (state.wasReleased(BUTTON_D) && state.heldMs(BUTTON_D) <= 1000) {
             road->nextTheme();
         }
         
         // Manual tunnel trigger: A + B buttons pressed together
-        if (button_a && button_b && debounce(current_time)) {
+        if (state.isHeld(BUTTON_A) && state.isHeld(BUTTON_B) &&
+            (state.wasPressed(BUTTON_A) || state.wasPressed(BUTTON_B))) {
             road->triggerTunnel();
         }
     }
     
     bool update() override {
         // Check for exit condition using GameBase method
-        bool button_d = cosmic->is_pressed(CosmicUnicorn::SWITCH_D);
-        if (checkExitCondition(button_d)) {
+        if (checkExitCondition()) {
             return false;  // Exit game
         }
         
-        // Handle other input
-        handleInput(
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_A),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_B),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_C),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_D),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN)
-        );
-        
         // Sync speed between car and road
-        road->speed = car.speed;
+        road->speed = car.speed.toFloat();
         
         // Update the road (this was missing - the road needs to update to move scenery and spawn objects!)
         road->update();
@@ -2799,7 +2886,7 @@ public:
                 
                 // Collision effects - slow down and add bounce
                 car.speed *= 0.5f;  // Reduce speed by half
-                car.velocity += (rand() % 2 == 0 ? 0.1f : -0.1f);  // Random bounce left/right
+                car.velocity += (rand() % 2 == 0 ? fix16(0.2f) : fix16(-0.2f));  // Random bounce left/right
             }
         }
         
@@ -2849,4 +2936,16 @@ public:
     const char* getDescription() const override {
         return "3D racing game with multiple themes and oncoming cars";
     }
+    
+    int getVariantCount() const override {
+        return Road::THEME_COUNT;
+    }
+    
+    const char* getVariantName(int index) const override {
+        return Road::themeName(index);
+    }
+    
+    void selectVariant(int index) override {
+        if (road && index >= 0 && index < Road::THEME_COUNT) road->holdTheme(index);
+    }
 };
@@ -233,7 +233,6 @@ private:
     // Game state
     uint32_t start_time;
     uint32_t frame_count = 0;
-    uint32_t last_action = 0;
     
     // Game objects
     std::vector<Lane> lanes;
@@ -246,7 +245,7 @@ private:
     const uint32_t DEBOUNCE_DURATION = 200;
     
 public:
-    FroggerGame() : start_time(0), frame_count(0), last_action(0) {}
+    FroggerGame() : start_time(0), frame_count(0) {}
     
     virtual ~FroggerGame() = default;
     
@@ -457,64 +456,31 @@ public:
         }
     }
     
-    bool debounce(uint32_t duration = 200) {
-        uint32_t now = to_ms_since_boot(get_absolute_time());
-        if (now - last_action > duration) {
-            last_action = now;
-            return true;
-        }
-        return false;
-    }
-    
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
-        
-        // Handle brightness controls
-        if (button_bright_up) {
-            cosmic->adjust_brightness(+0.01);
-        }
-        if (button_bright_down) {
-            cosmic->adjust_brightness(-0.01);
-        }
-        
-        // Handle movement controls
-        if (button_a && debounce()) {
+    void handleInput(const InputState& state) override {
+        // Handle movement controls - one hop per press, repeating while held
+        if (state.wasRepeated(BUTTON_A)) {
             player.move(0, -2);  // Move up (toward bridge)
         }
         
-        if (button_b && debounce()) {
+        if (state.wasRepeated(BUTTON_B)) {
             player.move(0, 2);   // Move down (toward start)
         }
         
-        if (button_vol_up && debounce()) {
+        if (state.wasRepeated(BUTTON_VOLUME_UP)) {
             player.move(1, 0);   // Move right
         }
         
-        if (button_vol_down && debounce()) {
+        if (state.wasRepeated(BUTTON_VOLUME_DOWN)) {
             player.move(-1, 0);  // Move left
         }
     }
     
     bool update() override {
         // Check for exit condition using GameBase method
-        bool button_d = cosmic->is_pressed(CosmicUnicorn::SWITCH_D);
-        if (checkExitCondition(button_d)) {
+        if (checkExitCondition()) {
             return false;  // Exit game
         }
         
-        // Handle other input
-        handleInput(
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_A),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_B),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_C),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_D),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN)
-        );
-        
         // Update game logic
         gameUpdate();
         
@@ -564,4 +530,9 @@ public:
     const char* getDescription() const override {
         return "Navigate the frog across roads and rivers to reach the bridge";
     }
+    
+    // Lanes step a whole cell on their own timers; input is still read at 20 Hz
+    FrameRates getFrameRates() const override {
+        return {20, 20, 10, 5};
+    }
 };
\ No newline at end of file
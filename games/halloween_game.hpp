@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../game_base.hpp"
+#include "../gfx/color.hpp"
+#include "../gfx/compositor.hpp"
+#include "../math/fixed.hpp"
 #include "animated_eyes.hpp"
 #include "halloween_scenes/woodland_path_scene.hpp"
 #include "halloween_scenes/stormy_night_scene.hpp"
@@ -9,6 +12,15 @@
 
 class HalloweenGame : public GameBase {
 private:
+    // Candle flame colours by heat band, coolest first
+    static constexpr uint32_t CANDLE_FLAME_PENS[] = {
+        packPen(100, 20, 0),    // Dark red
+        packPen(200, 50, 0),    // Red
+        packPen(255, 100, 0),   // Orange
+        packPen(255, 200, 0),   // Bright yellow
+        packPen(255, 255, 180)  // Hot white/yellow
+    };
+    
     enum HalloweenScene {
         CREEPY_EYES,
         STORMY_NIGHT,
@@ -33,6 +45,7 @@ private:
     uint32_t animation_timer;
     bool in_transition;  // Track if we're in a WOODLAND_PATH transition
     HalloweenScene next_target_scene; // The scene we'll transition to after WOODLAND_PATH
+    bool scene_locked;   // Stay on the current scene (set by selectVariant)
     
     // Animation states
     
@@ -68,10 +81,10 @@ private:
     
     // Boids system for BAT_FLOCK scene
     struct Boid {
-        float x, y;           // Position
-        float vx, vy;         // Velocity
-        float max_speed;
-        float max_force;
+        fix16 x, y;           // Position
+        fix16 vx, vy;         // Velocity
+        fix16 max_speed;
+        fix16 max_force;
         float wing_phase;     // For wing animation
         
         Boid(float start_x, float start_y) : x(start_x), y(start_y), 
@@ -104,6 +117,8 @@ private:
     
     // Background animation
     float background_phase;
+    // The nebula drifts slowly enough to redraw every few frames
+    Layer nebula_layer{"spookyNebula", LayerRefresh::EVERY_N, 4};
     
     // Creepy eyes regeneration timer
     uint32_t eyes_regen_timer;
@@ -112,32 +127,6 @@ private:
     bool is_paused;
     uint32_t pause_blink_timer;
     
-    void hsv_to_rgb(float h, float s, float v, uint8_t &r, uint8_t &g, uint8_t &b) {
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r_prime, g_prime, b_prime;
-        
-        if (h >= 0 && h < 60) {
-            r_prime = c; g_prime = x; b_prime = 0;
-        } else if (h >= 60 && h < 120) {
-            r_prime = x; g_prime = c; b_prime = 0;
-        } else if (h >= 120 && h < 180) {
-            r_prime = 0; g_prime = c; b_prime = x;
-        } else if (h >= 180 && h < 240) {
-            r_prime = 0; g_prime = x; b_prime = c;
-        } else if (h >= 240 && h < 300) {
-            r_prime = x; g_prime = 0; b_prime = c;
-        } else {
-            r_prime = c; g_prime = 0; b_prime = x;
-        }
-        
-        r = (uint8_t)((r_prime + m) * 255);
-        g = (uint8_t)((g_prime + m) * 255);
-        b = (uint8_t)((b_prime + m) * 255);
-    }
-    
     // Flame effect helper functions
     void setFlameHeat(int x, int y, float v) {
         if (x >= 0 && x < 32 && y >= 0 && y < 35) {
@@ -170,8 +159,8 @@ private:
         return flame_face_heat[x + y * 32];
     }
     
-    void drawSpookyBackground() {
-        // Nebula-like spooky background with animation
+    // Nebula-like spooky background with animation; drawn into nebula_layer
+    void drawNebula() {
         for (int y = 0; y < 32; y++) {
             for (int x = 0; x < 32; x++) {
                 // Multi-layered noise for rich nebula effect
@@ -210,7 +199,10 @@ private:
                 gfx->pixel({x, y});
             }
         }
-        
+    }
+    
+    void drawSpookyBackground() {
+        nebula_layer.render(*gfx);
         
         // Always draw bats flying across in background (behind all other scenes)
         for (size_t i = 0; i < bat_positions.size(); i++) {
@@ -841,11 +833,8 @@ private:
             int sparkle_y = center_y - 8 + (int)(sin(angle) * (8 + cos(witch_sparkle_phase * 2) * 2));
             
             if (sparkle_x >= 0 && sparkle_x < 32 && sparkle_y >= 0 && sparkle_y < 32) {
-                uint8_t r, g, b;
-                hsv_to_rgb(fmod(witch_sparkle_phase * 60 + i * 45, 360), 1.0f, 
-                          0.5f + sin(witch_sparkle_phase * 3 + i) * 0.5f, r, g, b);
-                Pen sparkle_pen = gfx->create_pen(r, g, b);
-                gfx->set_pen(sparkle_pen);
+                gfx->set_pen(hsvPen(hueFromDegrees(witch_sparkle_phase * 60 + i * 45), 255,
+                                    unitToByte(0.5f + sin(witch_sparkle_phase * 3 + i) * 0.5f)));
                 gfx->pixel({sparkle_x, sparkle_y});
             }
         }
@@ -870,8 +859,7 @@ private:
         int candle_bottom = 28;
         
         // Candle body (wax)
-        Pen candle_pen = gfx->create_pen(200, 180, 120);
-        gfx->set_pen(candle_pen);
+        gfx->set_pen(packPen(200, 180, 120));
         for (int y = candle_bottom; y >= candle_bottom - 8; y--) {
             for (int x = candle_x - 2; x <= candle_x + 2; x++) {
                 gfx->pixel({x, y});
@@ -879,8 +867,7 @@ private:
         }
         
         // Candle wick
-        Pen wick_pen = gfx->create_pen(60, 40, 20);
-        gfx->set_pen(wick_pen);
+        gfx->set_pen(packPen(60, 40, 20));
         gfx->pixel({candle_x, candle_bottom - 9});
         gfx->pixel({candle_x, candle_bottom - 10});
         
@@ -919,19 +906,11 @@ private:
             for (int x = 0; x < 32; x++) {
                 float heat_value = getFlameHeat(x, y + 3); // Offset for display
                 
-                if (heat_value > 0.5f) {
-                    gfx->set_pen(gfx->create_pen(255, 255, 180)); // Hot white/yellow
-                } else if (heat_value > 0.4f) {
-                    gfx->set_pen(gfx->create_pen(255, 200, 0)); // Bright yellow
-                } else if (heat_value > 0.3f) {
-                    gfx->set_pen(gfx->create_pen(255, 100, 0)); // Orange
-                } else if (heat_value > 0.2f) {
-                    gfx->set_pen(gfx->create_pen(200, 50, 0)); // Red
-                } else if (heat_value > 0.1f) {
-                    gfx->set_pen(gfx->create_pen(100, 20, 0)); // Dark red
-                }
-                
-                if (heat_value > 0.1f) {
+                // Which 0.1 heat band above 0.1 this is, capped at the hottest
+                int band = (heat_value > 0.1f) + (heat_value > 0.2f) + (heat_value > 0.3f) +
+                           (heat_value > 0.4f) + (heat_value > 0.5f);
+                if (band > 0) {
+                    gfx->set_pen(CANDLE_FLAME_PENS[band - 1]);
                     gfx->pixel({x, y});
                 }
             }
@@ -1782,7 +1761,7 @@ private:
             boid.vy += sep.second + ali.second + coh.second + bounds.second;
             
             // Limit velocity
-            float speed = sqrt(boid.vx * boid.vx + boid.vy * boid.vy);
+            fix16 speed = fixedSqrt(boid.vx * boid.vx + boid.vy * boid.vy);
             if (speed > boid.max_speed) {
                 boid.vx = (boid.vx / speed) * boid.max_speed;
                 boid.vy = (boid.vy / speed) * boid.max_speed;
@@ -1797,22 +1776,24 @@ private:
         }
     }
     
-    std::pair<float, float> separate(const Boid& boid) {
-        float desired_separation = 3.0f;
-        float steer_x = 0, steer_y = 0;
+    std::pair<fix16, fix16> separate(const Boid& boid) {
+        fix16 desired_separation = 3.0f;
+        fix16 steer_x = 0, steer_y = 0;
         int count = 0;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float dist = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 dist = fixedSqrt(dx * dx + dy * dy);
             
             if (dist > 0 && dist < desired_separation) {
-                // Normalize and weight by distance
+                // Normalize and weight by distance, capped so the fixed
+                // point sums can't overflow for bats on top of each other
                 dx /= dist;
                 dy /= dist;
-                dx /= dist; // Weight by distance
-                dy /= dist;
+                fix16 weight_dist = fixedMax(dist, fix16(0.25f));
+                dx /= weight_dist; // Weight by distance
+                dy /= weight_dist;
                 
                 steer_x += dx;
                 steer_y += dy;
@@ -1825,7 +1806,7 @@ private:
             steer_y /= count;
             
             // Normalize to max force
-            float mag = sqrt(steer_x * steer_x + steer_y * steer_y);
+            fix16 mag = fixedSqrt(steer_x * steer_x + steer_y * steer_y);
             if (mag > 0) {
                 steer_x = (steer_x / mag) * boid.max_force;
                 steer_y = (steer_y / mag) * boid.max_force;
@@ -1835,15 +1816,15 @@ private:
         return {steer_x, steer_y};
     }
     
-    std::pair<float, float> align(const Boid& boid) {
-        float neighbor_dist = 8.0f;
-        float sum_vx = 0, sum_vy = 0;
+    std::pair<fix16, fix16> align(const Boid& boid) {
+        fix16 neighbor_dist = 8.0f;
+        fix16 sum_vx = 0, sum_vy = 0;
         int count = 0;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float dist = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 dist = fixedSqrt(dx * dx + dy * dy);
             
             if (dist > 0 && dist < neighbor_dist) {
                 sum_vx += other.vx;
@@ -1857,7 +1838,7 @@ private:
             sum_vy /= count;
             
             // Normalize to max force
-            float mag = sqrt(sum_vx * sum_vx + sum_vy * sum_vy);
+            fix16 mag = fixedSqrt(sum_vx * sum_vx + sum_vy * sum_vy);
             if (mag > 0) {
                 sum_vx = (sum_vx / mag) * boid.max_force;
                 sum_vy = (sum_vy / mag) * boid.max_force;
@@ -1867,15 +1848,15 @@ private:
         return {sum_vx, sum_vy};
     }
     
-    std::pair<float, float> cohesion(const Boid& boid) {
-        float neighbor_dist = 8.0f;
-        float sum_x = 0, sum_y = 0;
+    std::pair<fix16, fix16> cohesion(const Boid& boid) {
+        fix16 neighbor_dist = 8.0f;
+        fix16 sum_x = 0, sum_y = 0;
         int count = 0;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float dist = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 dist = fixedSqrt(dx * dx + dy * dy);
             
             if (dist > 0 && dist < neighbor_dist) {
                 sum_x += other.x;
@@ -1889,11 +1870,11 @@ private:
             sum_y /= count;
             
             // Seek towards average position
-            float seek_x = sum_x - boid.x;
-            float seek_y = sum_y - boid.y;
+            fix16 seek_x = sum_x - boid.x;
+            fix16 seek_y = sum_y - boid.y;
             
             // Normalize to max force
-            float mag = sqrt(seek_x * seek_x + seek_y * seek_y);
+            fix16 mag = fixedSqrt(seek_x * seek_x + seek_y * seek_y);
             if (mag > 0) {
                 seek_x = (seek_x / mag) * boid.max_force;
                 seek_y = (seek_y / mag) * boid.max_force;
@@ -1905,9 +1886,9 @@ private:
         return {0, 0};
     }
     
-    std::pair<float, float> boundaryForce(const Boid& boid) {
-        float force_x = 0, force_y = 0;
-        float boundary_distance = 4.0f;
+    std::pair<fix16, fix16> boundaryForce(const Boid& boid) {
+        fix16 force_x = 0, force_y = 0;
+        fix16 boundary_distance = 4.0f;
         
         // Left boundary
         if (boid.x < boundary_distance) {
@@ -2025,6 +2006,29 @@ public:
         return "Halloween spookiness";
     }
     
+    int getVariantCount() const override {
+        return SCENE_COUNT;
+    }
+    
+    const char* getVariantName(int index) const override {
+        static const char* const names[SCENE_COUNT] = {
+            "CREEPY_EYES", "STORMY_NIGHT", "WOLF_HOWLING", "BAT_FLOCK", "CANDLE_FLAME",
+            "PUMPKIN", "FLAME_FACE", "GHOSTLY_SPIRITS", "HAUNTED_TREE", "SKULL_CROSSBONES",
+            "CASTLE", "WOODLAND_PATH", "FLYING_BATS", "WITCH_HAT"
+        };
+        return index >= 0 && index < SCENE_COUNT ? names[index] : getName();
+    }
+    
+    // Jump to a scene and stay there instead of auto-advancing
+    void selectVariant(int index) override {
+        if (index < 0 || index >= SCENE_COUNT) return;
+        current_scene = (HalloweenScene)index;
+        scene_start_time = to_ms_since_boot(get_absolute_time());
+        in_transition = false;
+        scene_locked = true;
+        resetSceneState();
+    }
+    
     void init(PicoGraphics_PenRGB888& graphics, CosmicUnicorn& cosmic_unicorn) override {
         gfx = &graphics;
         cosmic = &cosmic_unicorn;
@@ -2042,6 +2046,7 @@ public:
         animation_timer = 0;
         in_transition = false;
         next_target_scene = PUMPKIN;  // First transition will be to PUMPKIN
+        scene_locked = false;
         eyes_regen_timer = to_ms_since_boot(get_absolute_time());
         
         // Initialize animation states and generate random eyes
@@ -2053,6 +2058,7 @@ public:
         pumpkin_glow_phase = 0;
         witch_sparkle_phase = 0;
         background_phase = 0;
+        nebula_layer.setDraw([this](PicoGraphics_PenRGB888&) { drawNebula(); });
         
         // Initialize pause state
         is_paused = false;
@@ -2115,8 +2121,7 @@ public:
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
         animation_timer = current_time;
        
-        bool button_d = cosmic->is_pressed(CosmicUnicorn::SWITCH_D);
-        if (checkExitCondition(button_d)) {
+        if (checkExitCondition()) {
             return false;  // Exit game
         }
         
@@ -2146,7 +2151,7 @@ public:
             current_scene_duration = scene_duration;
         }
         // Only auto-advance scenes if not paused
-        if (!is_paused && current_time - scene_start_time > current_scene_duration) {
+        if (!is_paused && !scene_locked && current_time - scene_start_time > current_scene_duration) {
             current_scene = getNextScene(current_scene);
             scene_start_time = current_time;
             
@@ -2265,11 +2270,11 @@ public:
                 break;
                 
             case WOODLAND_PATH:
-                woodland_path.update(cosmic);
+                woodland_path.update(&input);
                 break;
                 
             case STORMY_NIGHT:
-                stormy_night.update(cosmic);
+                stormy_night.update(&input);
                 break;
                 
             case SCENE_COUNT:
@@ -2357,80 +2362,68 @@ public:
         }
     }
     
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
+    // Reset scene-specific states when entering a scene
+    void resetSceneState() {
+        if (current_scene == FLYING_BATS) {
+            for (size_t i = 0; i < bat_positions.size(); i++) {
+                bat_positions[i] = -10 - i * 15;
+            }
+        } else if (current_scene == BAT_FLOCK || current_scene == CASTLE) {
+            // Reset boids to random positions
+            boids.clear();
+            for (int i = 0; i < 12; i++) {
+                float x = 8 + (rand() % 16);  
+                float y = 8 + (rand() % 16);  
+                boids.emplace_back(x, y);
+            }
+        } else if (current_scene == CREEPY_EYES) {
+            // Generate new random eye configuration
+            generateRandomEyes();
+            eyes_regen_timer = to_ms_since_boot(get_absolute_time());
+        } else if (current_scene == SKULL_CROSSBONES) {
+            // Setup skull eyes
+            setupSkullEyes();
+        } else if (current_scene == HAUNTED_TREE) {
+            // Setup tree eyes
+            setupTreeEyes();
+        } else if (current_scene == CANDLE_FLAME) {
+            // Reset flame heat map
+            for (int i = 0; i < 32 * 35; i++) {
+                flame_heat[i] = 0.0f;
+            }
+            candle_flicker_phase = 0;
+        } else if (current_scene == FLAME_FACE) {
+            // Reset flame face heat map and animations
+            for (int i = 0; i < 32 * 35; i++) {
+                flame_face_heat[i] = 0.0f;
+            }
+            candle_flicker_phase = 0;
+            face_eye_blink_timer = 0;
+            face_left_eye_open = true;
+            face_right_eye_open = true;
+            face_mouth_anim_phase = 0;
+        } else if (current_scene == GHOSTLY_SPIRITS) {
+            // Reset ghosts
+            for (auto& ghost : ghosts) {
+                ghost.x = rand() % 32;
+                ghost.y = rand() % 32;
+                ghost.phase = rand() % 100 * 0.1f;
+            }
+        }
+    }
+    
+    void handleInput(const InputState& state) override {
         // Allow manual scene switching with A button
-        static bool a_pressed = false;
-        if (button_a && !a_pressed) {
+        if (state.wasPressed(BUTTON_A)) {
             current_scene = getNextScene(current_scene);
             scene_start_time = to_ms_since_boot(get_absolute_time());
-            a_pressed = true;
-            
-            // Reset scene-specific states when manually entering scenes
-            if (current_scene == FLYING_BATS) {
-                for (size_t i = 0; i < bat_positions.size(); i++) {
-                    bat_positions[i] = -10 - i * 15;
-                }
-            } else if (current_scene == BAT_FLOCK || current_scene == CASTLE) {
-                // Reset boids to random positions
-                boids.clear();
-                for (int i = 0; i < 12; i++) {
-                    float x = 8 + (rand() % 16);  
-                    float y = 8 + (rand() % 16);  
-                    boids.emplace_back(x, y);
-                }
-            } else if (current_scene == CREEPY_EYES) {
-                // Generate new random eye configuration
-                generateRandomEyes();
-                eyes_regen_timer = to_ms_since_boot(get_absolute_time());
-            } else if (current_scene == SKULL_CROSSBONES) {
-                // Setup skull eyes
-                setupSkullEyes();
-            } else if (current_scene == HAUNTED_TREE) {
-                // Setup tree eyes
-                setupTreeEyes();
-            } else if (current_scene == CANDLE_FLAME) {
-                // Reset flame heat map
-                for (int i = 0; i < 32 * 35; i++) {
-                    flame_heat[i] = 0.0f;
-                }
-                candle_flicker_phase = 0;
-            } else if (current_scene == FLAME_FACE) {
-                // Reset flame face heat map and animations
-                for (int i = 0; i < 32 * 35; i++) {
-                    flame_face_heat[i] = 0.0f;
-                }
-                candle_flicker_phase = 0;
-                face_eye_blink_timer = 0;
-                face_left_eye_open = true;
-                face_right_eye_open = true;
-                face_mouth_anim_phase = 0;
-            } else if (current_scene == GHOSTLY_SPIRITS) {
-                // Reset ghosts
-                for (auto& ghost : ghosts) {
-                    ghost.x = rand() % 32;
-                    ghost.y = rand() % 32;
-                    ghost.phase = rand() % 100 * 0.1f;
-                }
-            }
-        } else if (!button_a) {
-            a_pressed = false;
+            resetSceneState();
         }
         
         // Handle pause/unpause with B button
-        static bool b_pressed = false;
-        if (button_b && !b_pressed) {
+        if (state.wasPressed(BUTTON_B)) {
             is_paused = !is_paused;
             pause_blink_timer = to_ms_since_boot(get_absolute_time());
-            b_pressed = true;
-        } else if (!button_b) {
-            b_pressed = false;
-        }
-        
-        // Check for exit
-        if (checkExitCondition(button_d)) {
-            // Game will exit
         }
     }
 };
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../../game_base.hpp"
+#include "../../gfx/palette.hpp"
+#include "../../gfx/blend.hpp"
+#include "../../gfx/deep_frame.hpp"
 #include <cmath>
 #include <vector>
 #include <random>
@@ -16,6 +19,7 @@ struct LightningBranch {
 
 struct CloudParticle {
     float x, y, z;
+    uint8_t shade;  // Ramp index for z
     float velocity_x, velocity_y;
     float density;
     float noise_offset;
@@ -60,6 +64,15 @@ private:
     int current_theme_index;
     StormTheme current_theme;
     
+    // Cloud pens for the current theme, dimmer for distant particles
+    static constexpr int CLOUD_SHADES = 16;
+    PenRamp<CLOUD_SHADES> cloud_dark_pens;
+    PenRamp<CLOUD_SHADES> cloud_light_pens;
+    
+    // The sky is dark enough to band at 8 bits, so it's dithered down, once
+    // per theme
+    CachedGradientV sky{32};
+    
     float time_accumulator;
     float lightning_timer;
     float thunder_flash_timer;
@@ -67,14 +80,13 @@ private:
     float cloud_animation_time;
     float theme_timer;
     uint32_t last_update_time;
-    bool last_c_pressed;
     
     // Perlin noise implementation for smooth cloud movement
     static constexpr int NOISE_SIZE = 256;
     float noise_table[NOISE_SIZE];
     
 public:
-    void init(PicoGraphics* graphics) {
+    void init(PicoGraphics_PenRGB888* graphics) {
         lightning_branches.clear();
         lightning_branches.reserve(MAX_LIGHTNING_BRANCHES);
         cloud_particles.clear();
@@ -90,34 +102,29 @@ public:
         theme_timer = 0.0f;
         current_theme_index = 0;
 
-        size_t random_index = std::rand() % themes.size();
-        current_theme_index = random_index;
-
-        last_c_pressed = false;
         last_update_time = to_ms_since_boot(get_absolute_time());
         
         initializeNoiseTable();
         initializeThemes();
+
+        // Pick the starting theme once the list exists (it was empty here
+        // before, a modulo by zero)
+        setTheme(std::rand() % themes.size());
         initializeCloudParticles();
         initializeRain();
     }
     
-    void update(CosmicUnicorn* cosmic = nullptr) {
+    // input is null when the scene is just a background (the menu)
+    void update(const InputState* input = nullptr) {
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
         float dt = (current_time - last_update_time) / 1000.0f;
         last_update_time = current_time;
         
         // Check for manual theme change with C button
-        bool c_pressed = false;
-        if (cosmic) {
-            c_pressed = cosmic->is_pressed(CosmicUnicorn::SWITCH_C);
-            if (c_pressed && !last_c_pressed && !themes.empty()) {
-                current_theme_index = (current_theme_index + 1) % themes.size();
-                current_theme = themes[current_theme_index];
-                theme_timer = 0.0f;
-            }
+        if (input && input->wasPressed(BUTTON_C) && !themes.empty()) {
+            setTheme((current_theme_index + 1) % themes.size());
+            theme_timer = 0.0f;
         }
-        last_c_pressed = c_pressed;
         
         time_accumulator += dt;
         lightning_timer += dt;
@@ -129,8 +136,7 @@ public:
         // Update theme periodically
         if (theme_timer >= THEME_CHANGE_TIME && !themes.empty()) {
             theme_timer = 0.0f;
-            current_theme_index = (current_theme_index + 1) % themes.size();
-            current_theme = themes[current_theme_index];
+            setTheme((current_theme_index + 1) % themes.size());
         }
        */ 
         // Update thunder flash
@@ -151,7 +157,7 @@ public:
         updateRain(dt);
     }
     
-    void render(PicoGraphics* graphics) {
+    void render(PicoGraphics_PenRGB888* graphics) {
         drawStormySky(graphics);
         drawClouds(graphics);
         drawRain(graphics);
@@ -163,18 +169,18 @@ public:
             float flash_intensity = thunder_flash_timer / 0.2f; // 0.2 second flash
             if (flash_intensity > 1.0f) flash_intensity = 1.0f;
             
-            uint32_t flash_color = graphics->create_pen(
+            uint32_t flash_color = packPen(
                 (int)(255 * flash_intensity * 0.3f),
                 (int)(255 * flash_intensity * 0.4f),
                 (int)(255 * flash_intensity * 0.7f)
             );
-            graphics->set_pen(flash_color);
             
-            // Random flash pixels across the screen
+            // The whole scene brightens a little, with random brighter flecks
+            blendRect(*graphics, 0, 0, 32, 32, dimPen(flash_color, 48), BlendMode::ADD);
             for (int i = 0; i < (int)(flash_intensity * 20); i++) {
                 int x = rand() % 32;
                 int y = rand() % 32;
-                graphics->pixel(Point(x, y));
+                blendPixel(*graphics, x, y, flash_color, BlendMode::ADD);
             }
         }
     }
@@ -234,7 +240,21 @@ private:
         purple_nightmare.name = "Purple Nightmare";
         themes.push_back(purple_nightmare);
         
-        current_theme = themes[0];
+        setTheme(0);
+    }
+    
+    void setTheme(int index) {
+        current_theme_index = index;
+        current_theme = themes[index];
+        
+        // Depth-based fade for moderate visibility: 50% for the farthest
+        // particles up to 90% for the nearest
+        cloud_dark_pens.build(current_theme.cloud_dark_r, current_theme.cloud_dark_g,
+                              current_theme.cloud_dark_b, 0.5f, 0.9f);
+        cloud_light_pens.build(current_theme.cloud_light_r, current_theme.cloud_light_g,
+                               current_theme.cloud_light_b, 0.5f, 0.9f);
+        sky.set(deepColor(current_theme.sky_top_r, current_theme.sky_top_g, current_theme.sky_top_b),
+                deepColor(current_theme.sky_bottom_r, current_theme.sky_bottom_g, current_theme.sky_bottom_b));
     }
     
     void initializeCloudParticles() {
@@ -245,6 +265,7 @@ private:
             particle.x = (float)(rand() % 64 - 16); // -16 to 48 for wrapping
             particle.y = (float)(rand() % 20);      // Top 20 rows
             particle.z = (float)(rand() % 100) / 100.0f; // Depth for layering
+            particle.shade = cloud_dark_pens.indexFor(particle.z);
             particle.velocity_x = 0.5f + (float)(rand() % 100) / 200.0f; // 0.5 to 1.0
             particle.velocity_y = (float)(rand() % 40 - 20) / 100.0f;   // Slight vertical drift
             particle.density = 0.3f + (float)(rand() % 70) / 100.0f;    // 0.3 to 1.0
@@ -387,25 +408,12 @@ private:
         }
     }
     
-    void drawStormySky(PicoGraphics* graphics) {
+    void drawStormySky(PicoGraphics_PenRGB888* graphics) {
         // Draw gradient stormy sky
-        for (int y = 0; y < 32; y++) {
-            float gradient_factor = (float)y / 32.0f;
-            
-            uint8_t r = current_theme.sky_top_r + (current_theme.sky_bottom_r - current_theme.sky_top_r) * gradient_factor;
-            uint8_t g = current_theme.sky_top_g + (current_theme.sky_bottom_g - current_theme.sky_top_g) * gradient_factor;
-            uint8_t b = current_theme.sky_top_b + (current_theme.sky_bottom_b - current_theme.sky_top_b) * gradient_factor;
-            
-            uint32_t sky_color = graphics->create_pen(r, g, b);
-            graphics->set_pen(sky_color);
-            
-            for (int x = 0; x < 32; x++) {
-                graphics->pixel(Point(x, y));
-            }
-        }
+        sky.draw(*graphics);
     }
     
-    void drawClouds(PicoGraphics* graphics) {
+    void drawClouds(PicoGraphics_PenRGB888* graphics) {
         // Draw clouds using particle system
         for (const auto& particle : cloud_particles) {
             if (particle.x >= 0 && particle.x < 32 && particle.y >= 0 && particle.y < 32) {
@@ -414,28 +422,10 @@ private:
                                           particle.y * 0.3f + cloud_animation_time * 0.08f);
                 
                 if (noise_density > 0.35f) { // Threshold for cloud visibility - moderate increase
-                    // Choose cloud color based on density and depth
-                    uint8_t cloud_r, cloud_g, cloud_b;
-                    if (particle.density > 0.7f) {
-                        // Dense cloud - darker
-                        cloud_r = current_theme.cloud_dark_r;
-                        cloud_g = current_theme.cloud_dark_g;
-                        cloud_b = current_theme.cloud_dark_b;
-                    } else {
-                        // Lighter cloud
-                        cloud_r = current_theme.cloud_light_r;
-                        cloud_g = current_theme.cloud_light_g;
-                        cloud_b = current_theme.cloud_light_b;
-                    }
-                    
-                    // Apply depth-based alpha blending effect - moderate visibility
-                    float depth_factor = 0.5f + particle.z * 0.4f;
-                    cloud_r = (uint8_t)(cloud_r * depth_factor);
-                    cloud_g = (uint8_t)(cloud_g * depth_factor);
-                    cloud_b = (uint8_t)(cloud_b * depth_factor);
-                    
-                    uint32_t cloud_color = graphics->create_pen(cloud_r, cloud_g, cloud_b);
-                    graphics->set_pen(cloud_color);
+                    // Choose cloud color based on density (dense clouds are
+                    // darker), shaded by depth
+                    const PenRamp<CLOUD_SHADES>& ramp = particle.density > 0.7f ? cloud_dark_pens : cloud_light_pens;
+                    graphics->set_pen(ramp[particle.shade]);
                     graphics->pixel(Point((int)particle.x, (int)particle.y));
                     
                     // Add some cloud spread for larger appearance - selective threshold
@@ -453,7 +443,7 @@ private:
         }
     }
     
-    void drawRain(PicoGraphics* graphics) {
+    void drawRain(PicoGraphics_PenRGB888* graphics) {
         uint32_t rain_color = graphics->create_pen(current_theme.rain_r, current_theme.rain_g, current_theme.rain_b);
         graphics->set_pen(rain_color);
         
@@ -472,22 +462,21 @@ private:
         }
     }
     
-    void drawLightning(PicoGraphics* graphics) {
+    void drawLightning(PicoGraphics_PenRGB888* graphics) {
         for (const auto& branch : lightning_branches) {
             if (branch.active) {
                 // Calculate intensity-based color
                 float intensity_factor = branch.intensity;
                 
                 // Draw lightning glow first (wider, dimmer)
-                uint32_t glow_color = graphics->create_pen(
+                uint32_t glow_color = packPen(
                     (int)(current_theme.lightning_glow_r * intensity_factor * 0.6f),
                     (int)(current_theme.lightning_glow_g * intensity_factor * 0.6f),
                     (int)(current_theme.lightning_glow_b * intensity_factor * 0.6f)
                 );
-                graphics->set_pen(glow_color);
                 
-                // Draw glow around main lightning bolt
-                drawThickLine(graphics, branch.x1, branch.y1, branch.x2, branch.y2, 2);
+                // Draw glow around main lightning bolt, added to the sky behind it
+                drawThickLine(graphics, branch.x1, branch.y1, branch.x2, branch.y2, 2, glow_color);
                 
                 // Draw main lightning bolt (bright, thin)
                 uint32_t lightning_color = graphics->create_pen(
@@ -502,7 +491,7 @@ private:
         }
     }
     
-    void drawGround(PicoGraphics* graphics) {
+    void drawGround(PicoGraphics_PenRGB888* graphics) {
         // Draw ground at bottom of screen
         uint32_t ground_color = graphics->create_pen(current_theme.ground_r, current_theme.ground_g, current_theme.ground_b);
         graphics->set_pen(ground_color);
@@ -518,7 +507,13 @@ private:
         }
     }
     
-    void drawLine(PicoGraphics* graphics, float x1, float y1, float x2, float y2) {
+    void drawLine(PicoGraphics_PenRGB888* graphics, float x1, float y1, float x2, float y2) {
+        traceLine(x1, y1, x2, y2, [graphics](int x, int y) { graphics->pixel(Point(x, y)); });
+    }
+    
+    // Calls plot(x, y) for each on-screen pixel of the line
+    template <typename Plot>
+    void traceLine(float x1, float y1, float x2, float y2, Plot plot) {
         int ix1 = (int)x1, iy1 = (int)y1, ix2 = (int)x2, iy2 = (int)y2;
         
         int dx = abs(ix2 - ix1);
@@ -529,7 +524,7 @@ private:
         
         while (true) {
             if (ix1 >= 0 && ix1 < 32 && iy1 >= 0 && iy1 < 32) {
-                graphics->pixel(Point(ix1, iy1));
+                plot(ix1, iy1);
             }
             
             if (ix1 == ix2 && iy1 == iy2) break;
@@ -546,11 +541,22 @@ private:
         }
     }
     
-    void drawThickLine(PicoGraphics* graphics, float x1, float y1, float x2, float y2, int thickness) {
-        // Draw multiple lines offset by thickness for glow effect
+    void drawThickLine(PicoGraphics_PenRGB888* graphics, float x1, float y1, float x2, float y2, int thickness, uint32_t glow) {
+        // Mark lines offset by thickness for glow effect, then add the glow
+        // to each marked pixel once: the lines overlap (on a 45 degree bolt
+        // the line one right is the line one up), and a pixel covered twice
+        // would glow twice as bright
+        uint32_t rows[32] = {};
+        auto mark = [&rows](int x, int y) { rows[y] |= 1u << x; };
         for (int offset = -thickness/2; offset <= thickness/2; offset++) {
-            drawLine(graphics, x1 + offset, y1, x2 + offset, y2);
-            drawLine(graphics, x1, y1 + offset, x2, y2 + offset);
+            traceLine(x1 + offset, y1, x2 + offset, y2, mark);
+            traceLine(x1, y1 + offset, x2, y2 + offset, mark);
+        }
+        
+        for (int y = 0; y < 32; y++) {
+            for (uint32_t bits = rows[y]; bits; bits &= bits - 1) {
+                blendPixel(*graphics, __builtin_ctz(bits), y, glow, BlendMode::ADD);
+            }
         }
     }
 };
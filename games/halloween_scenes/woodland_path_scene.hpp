@@ -2,7 +2,9 @@
 
 #include "../../game_base.hpp"
 #include "../animated_eyes.hpp"
+#include "../../gfx/deep_frame.hpp"
 #include "../../effects/lightning.hpp"
+#include "../../math/fixed.hpp"
 #include <cmath>
 #include <vector>
 #include <fstream>
@@ -17,11 +19,11 @@ struct TreeNode {
 };
 
 struct Boid {
-    float x, y;
-    float vx, vy;
+    fix16 x, y;
+    fix16 vx, vy;
     float wing_phase;
-    float max_speed = 1.2f;
-    float max_force = 0.03f;
+    fix16 max_speed = 1.2f;
+    fix16 max_force = 0.03f;
     
     Boid(float start_x, float start_y) : x(start_x), y(start_y), 
          vx((rand() % 100 - 50) / 100.0f), vy((rand() % 100 - 50) / 100.0f), wing_phase(0) {}
@@ -66,7 +68,6 @@ private:
     std::vector<Theme> themes;
     int current_theme_index;
     float theme_timer;
-    bool last_c_pressed;
     
     float distance;           // Total distance traveled
     float road_curve;         // Current road curve amount
@@ -90,8 +91,6 @@ private:
     
     // Tree angle adjustment system
     float tree_angle_offset;
-    bool last_volume_up_pressed;
-    bool last_volume_down_pressed;
     static constexpr float ANGLE_STEP = 5.0f;  // Degrees to adjust per button press
     static constexpr float MIN_ANGLE = 10.0f;  // Minimum branch angle
     static constexpr float MAX_ANGLE = 45.0f;  // Maximum branch angle
@@ -103,6 +102,11 @@ private:
     static constexpr float EYES_APPEAR_CHANCE = 0.3f;  // 30% chance when stopped
     static constexpr float EYES_DISPLAY_TIME = 3.0f;   // Show eyes for 3 seconds
     
+    // The sky above the horizon, dithered down once per theme so its
+    // gradient doesn't band
+    static constexpr int HORIZON_Y = 14;
+    CachedGradientV sky{HORIZON_Y};
+    
     // Lightning system
     Lightning lightning;
     float tree_flash_timer;
@@ -115,7 +119,7 @@ private:
     Theme current_theme;
     
 public:
-    void init(PicoGraphics* graphics) {
+    void init(PicoGraphics_PenRGB888* graphics) {
         trees.clear();
         trees.reserve(MAX_TREES);
         boids.clear();
@@ -125,7 +129,6 @@ public:
         animation_phase = 0.0f;
         theme_timer = 0.0f;
         current_theme_index = 0;
-        last_c_pressed = false;
         last_update_time = to_ms_since_boot(get_absolute_time());
         
         // Initialize spreading behavior
@@ -139,8 +142,6 @@ public:
         
         // Initialize tree angle system
         tree_angle_offset = 0.0f;  // Start with default angle
-        last_volume_up_pressed = false;
-        last_volume_down_pressed = false;
         
         // Initialize eyes system
         tree_eyes.init(static_cast<PicoGraphics_PenRGB888&>(*graphics));
@@ -173,38 +174,23 @@ public:
         generateInitialTrees();
     }
     
-    void update(CosmicUnicorn* cosmic = nullptr) {
+    void update(const InputState* input = nullptr) {
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
         float dt = (current_time - last_update_time) / 1000.0f;
         last_update_time = current_time;
         
         // Check for manual theme change with C button
-        bool c_pressed = false;
-        if (cosmic) {
-            c_pressed = cosmic->is_pressed(CosmicUnicorn::SWITCH_C);
-            if (c_pressed && !last_c_pressed && !themes.empty()) {
-                current_theme_index = (current_theme_index + 1) % themes.size();
-                current_theme = themes[current_theme_index];
-                theme_timer = 0.0f; // Reset automatic timer when manually changed
-            }
+        if (input && input->wasPressed(BUTTON_C) && !themes.empty()) {
+            setTheme((current_theme_index + 1) % themes.size());
+            theme_timer = 0.0f; // Reset automatic timer when manually changed
         }
-        last_c_pressed = c_pressed;
         
         // Check for tree angle adjustment with volume buttons
-        if (cosmic) {
-            bool volume_up_pressed = cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP);
-            bool volume_down_pressed = cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN);
-            
-            if (volume_up_pressed && !last_volume_up_pressed) {
-                tree_angle_offset = std::min(tree_angle_offset + ANGLE_STEP, MAX_ANGLE - 25.0f);
-            }
-            
-            if (volume_down_pressed && !last_volume_down_pressed) {
-                tree_angle_offset = std::max(tree_angle_offset - ANGLE_STEP, MIN_ANGLE - 25.0f);
-            }
-            
-            last_volume_up_pressed = volume_up_pressed;
-            last_volume_down_pressed = volume_down_pressed;
+        if (input && input->wasPressed(BUTTON_VOLUME_UP)) {
+            tree_angle_offset = std::min(tree_angle_offset + ANGLE_STEP, MAX_ANGLE - 25.0f);
+        }
+        if (input && input->wasPressed(BUTTON_VOLUME_DOWN)) {
+            tree_angle_offset = std::max(tree_angle_offset - ANGLE_STEP, MIN_ANGLE - 25.0f);
         }
         
         // Update speed state system
@@ -233,8 +219,7 @@ public:
         // Update theme periodically (automatic cycling)
         if (theme_timer >= THEME_CHANGE_TIME && !themes.empty()) {
             theme_timer = 0.0f;
-            current_theme_index = (current_theme_index + 1) % themes.size();
-            current_theme = themes[current_theme_index];
+            setTheme((current_theme_index + 1) % themes.size());
         }
         
         // Update spreading behavior cycle
@@ -280,7 +265,7 @@ public:
         }
     }
     
-    void render(PicoGraphics* graphics) {
+    void render(PicoGraphics_PenRGB888* graphics) {
         drawGradientSky(graphics);
         drawLandscape(graphics);
         drawMoon(graphics);
@@ -293,7 +278,7 @@ public:
     
 private:
     // Helper function to create darkened pen based on distance (like arcade racer)
-    uint32_t createDarkenedPen(PicoGraphics* graphics, uint8_t r, uint8_t g, uint8_t b, float perspective) {
+    uint32_t createDarkenedPen(PicoGraphics_PenRGB888* graphics, uint8_t r, uint8_t g, uint8_t b, float perspective) {
         // Same brightness formula as arcade racer: darker at horizon, brighter in foreground
         float brightness = 0.2f + 0.8f * perspective;
         
@@ -304,7 +289,7 @@ private:
         return graphics->create_pen(dark_r, dark_g, dark_b);
     }
 
-    void loadThemes(PicoGraphics* graphics) {
+    void loadThemes(PicoGraphics_PenRGB888* graphics) {
         themes.clear();
         
         // Hardcode themes for now to test functionality
@@ -449,7 +434,14 @@ private:
         gothic_mist.name = "Gothic Mist";
         themes.push_back(gothic_mist);
         
-        current_theme = themes[1];
+        setTheme(1);
+    }
+    
+    void setTheme(int index) {
+        current_theme_index = index;
+        current_theme = themes[index];
+        sky.set(deepColor(current_theme.sky_top_r, current_theme.sky_top_g, current_theme.sky_top_b),
+                deepColor(current_theme.sky_bottom_r, current_theme.sky_bottom_g, current_theme.sky_bottom_b));
     }
     
     std::vector<int> parseRGB(const std::string& line) {
@@ -499,7 +491,7 @@ private:
             }
             
             // Limit speed
-            float speed = sqrt(boid.vx * boid.vx + boid.vy * boid.vy);
+            fix16 speed = fixedSqrt(boid.vx * boid.vx + boid.vy * boid.vy);
             if (speed > boid.max_speed) {
                 boid.vx = (boid.vx / speed) * boid.max_speed;
                 boid.vy = (boid.vy / speed) * boid.max_speed;
@@ -514,29 +506,32 @@ private:
         }
     }
     
-    std::pair<float, float> separate(const Boid& boid) {
-        float desired_separation = 4.0f;
-        float steer_x = 0, steer_y = 0;
+    std::pair<fix16, fix16> separate(const Boid& boid) {
+        fix16 desired_separation = 4.0f;
+        fix16 steer_x = 0, steer_y = 0;
         int count = 0;
         
         // Add occasional stronger repulsion to help spread out clustered boids
-        float repulsion_chance = 0.02f; // 2% chance per frame
-        float repulsion_multiplier = (rand() % 100) < (repulsion_chance * 100) ? 3.0f : 1.0f;
+        fix16 repulsion_chance = 0.02f; // 2% chance per frame
+        fix16 repulsion_multiplier = (rand() % 100) < (repulsion_chance * 100) ? 3.0f : 1.0f;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float distance = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 distance = fixedSqrt(dx * dx + dy * dy);
             
             // Use larger separation distance when applying repulsion
-            float current_separation = desired_separation * repulsion_multiplier;
+            fix16 current_separation = desired_separation * repulsion_multiplier;
             
             if (distance > 0 && distance < current_separation) {
                 // Calculate steering force away from neighbor
-                float norm_x = dx / distance;
-                float norm_y = dy / distance;
-                norm_x /= distance; // Weight by distance
-                norm_y /= distance;
+                fix16 norm_x = dx / distance;
+                fix16 norm_y = dy / distance;
+                // Weight by distance, capped so the fixed point sums can't
+                // overflow for bats on top of each other
+                fix16 weight_distance = fixedMax(distance, fix16(0.25f));
+                norm_x /= weight_distance;
+                norm_y /= weight_distance;
                 steer_x += norm_x * repulsion_multiplier;
                 steer_y += norm_y * repulsion_multiplier;
                 count++;
@@ -548,7 +543,7 @@ private:
             steer_y /= count;
             
             // Normalize and scale
-            float mag = sqrt(steer_x * steer_x + steer_y * steer_y);
+            fix16 mag = fixedSqrt(steer_x * steer_x + steer_y * steer_y);
             if (mag > 0) {
                 steer_x = (steer_x / mag) * boid.max_force * repulsion_multiplier;
                 steer_y = (steer_y / mag) * boid.max_force * repulsion_multiplier;
@@ -558,15 +553,15 @@ private:
         return {steer_x, steer_y};
     }
     
-    std::pair<float, float> align(const Boid& boid) {
-        float neighbor_radius = 8.0f;
-        float sum_vx = 0, sum_vy = 0;
+    std::pair<fix16, fix16> align(const Boid& boid) {
+        fix16 neighbor_radius = 8.0f;
+        fix16 sum_vx = 0, sum_vy = 0;
         int count = 0;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float distance = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 distance = fixedSqrt(dx * dx + dy * dy);
             
             if (distance > 0 && distance < neighbor_radius) {
                 sum_vx += other.vx;
@@ -580,7 +575,7 @@ private:
             sum_vy /= count;
             
             // Normalize and scale
-            float mag = sqrt(sum_vx * sum_vx + sum_vy * sum_vy);
+            fix16 mag = fixedSqrt(sum_vx * sum_vx + sum_vy * sum_vy);
             if (mag > 0) {
                 sum_vx = (sum_vx / mag) * boid.max_force;
                 sum_vy = (sum_vy / mag) * boid.max_force;
@@ -590,15 +585,15 @@ private:
         return {sum_vx, sum_vy};
     }
     
-    std::pair<float, float> cohesion(const Boid& boid) {
-        float neighbor_radius = 8.0f;
-        float sum_x = 0, sum_y = 0;
+    std::pair<fix16, fix16> cohesion(const Boid& boid) {
+        fix16 neighbor_radius = 8.0f;
+        fix16 sum_x = 0, sum_y = 0;
         int count = 0;
         
         for (const auto& other : boids) {
-            float dx = boid.x - other.x;
-            float dy = boid.y - other.y;
-            float distance = sqrt(dx * dx + dy * dy);
+            fix16 dx = boid.x - other.x;
+            fix16 dy = boid.y - other.y;
+            fix16 distance = fixedSqrt(dx * dx + dy * dy);
             
             if (distance > 0 && distance < neighbor_radius) {
                 sum_x += other.x;
@@ -612,11 +607,11 @@ private:
             sum_y /= count;
             
             // Seek towards center
-            float seek_x = sum_x - boid.x;
-            float seek_y = sum_y - boid.y;
+            fix16 seek_x = sum_x - boid.x;
+            fix16 seek_y = sum_y - boid.y;
             
             // Normalize and scale
-            float mag = sqrt(seek_x * seek_x + seek_y * seek_y);
+            fix16 mag = fixedSqrt(seek_x * seek_x + seek_y * seek_y);
             if (mag > 0) {
                 seek_x = (seek_x / mag) * boid.max_force;
                 seek_y = (seek_y / mag) * boid.max_force;
@@ -628,15 +623,15 @@ private:
         return {0, 0};
     }
     
-    std::pair<float, float> boundaryForce(const Boid& boid) {
-        float boundary_distance = 8.0f;
-        float force_x = 0, force_y = 0;
+    std::pair<fix16, fix16> boundaryForce(const Boid& boid) {
+        fix16 boundary_distance = 8.0f;
+        fix16 force_x = 0, force_y = 0;
         
         // Expanded flight area: -10 to 42 horizontally, -5 to 12 vertically
-        float left_boundary = -10.0f;
-        float right_boundary = 42.0f;
-        float top_boundary = -5.0f;
-        float bottom_boundary = 12.0f; // Keep above horizon
+        fix16 left_boundary = -10.0f;
+        fix16 right_boundary = 42.0f;
+        fix16 top_boundary = -5.0f;
+        fix16 bottom_boundary = 12.0f; // Keep above horizon
         
         // Apply boundary forces when approaching edges
         if (boid.x < left_boundary + boundary_distance) {
@@ -658,28 +653,12 @@ private:
         return {force_x, force_y};
     }
     
-    void drawGradientSky(PicoGraphics* graphics) {
-        const int horizon_y = 14;
-        
+    void drawGradientSky(PicoGraphics_PenRGB888* graphics) {
         // Draw gradient sky from top to horizon
-        for (int y = 0; y < horizon_y; y++) {
-            float gradient_factor = (float)y / (float)horizon_y;
-            
-            // Interpolate between sky_top and sky_bottom colors
-            uint8_t r = current_theme.sky_top_r + (current_theme.sky_bottom_r - current_theme.sky_top_r) * gradient_factor;
-            uint8_t g = current_theme.sky_top_g + (current_theme.sky_bottom_g - current_theme.sky_top_g) * gradient_factor;
-            uint8_t b = current_theme.sky_top_b + (current_theme.sky_bottom_b - current_theme.sky_top_b) * gradient_factor;
-            
-            uint32_t gradient_color = graphics->create_pen(r, g, b);
-            graphics->set_pen(gradient_color);
-            
-            for (int x = 0; x < 32; x++) {
-                graphics->pixel(Point(x, y));
-            }
-        }
+        sky.draw(*graphics);
     }
     
-    void drawBats(PicoGraphics* graphics) {
+    void drawBats(PicoGraphics_PenRGB888* graphics) {
         uint32_t bat_color = graphics->create_pen(current_theme.bat_color_r, current_theme.bat_color_g, current_theme.bat_color_b);
         graphics->set_pen(bat_color);
         
@@ -820,7 +799,7 @@ private:
                  new_length, depth + 1, max_depth, scale);
     }
     
-    void drawLandscape(PicoGraphics* graphics) {
+    void drawLandscape(PicoGraphics_PenRGB888* graphics) {
         const int horizon_y = 14;
         
         // Draw landscape with moving stripes similar to arcade racer
@@ -863,7 +842,7 @@ private:
         }
     }
     
-    void drawPath(PicoGraphics* graphics) {
+    void drawPath(PicoGraphics_PenRGB888* graphics) {
         const int horizon_y = 14; // Horizon line - road starts here
         
         // Draw road using arcade racer perspective, starting from horizon
@@ -893,7 +872,7 @@ private:
         }
     }
     
-    void drawTrees(PicoGraphics* graphics) {
+    void drawTrees(PicoGraphics_PenRGB888* graphics) {
         for (const auto& tree : trees) {
             if (!tree.active) continue;
             
@@ -980,7 +959,7 @@ private:
         }
     }
     
-    void drawMoon(PicoGraphics* graphics) {
+    void drawMoon(PicoGraphics_PenRGB888* graphics) {
         float moon_x = 26.0f;
         float moon_y = 5.0f;
         float moon_radius = 2.5f;
@@ -1011,7 +990,7 @@ private:
         }
     }
     
-    void drawLine(PicoGraphics* graphics, float x1, float y1, float x2, float y2) {
+    void drawLine(PicoGraphics_PenRGB888* graphics, float x1, float y1, float x2, float y2) {
         int ix1 = (int)x1, iy1 = (int)y1, ix2 = (int)x2, iy2 = (int)y2;
         
         int dx = abs(ix2 - ix1);
@@ -1174,7 +1153,7 @@ private:
         tree_eyes.disableRepositioning(); // Keep eyes in one spot
     }
     
-    void drawEyes(PicoGraphics* graphics) {
+    void drawEyes(PicoGraphics_PenRGB888* graphics) {
         if (eyes_visible) {
             tree_eyes.draw(animation_phase);
         }
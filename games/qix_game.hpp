@@ -10,6 +10,11 @@
 
 #include "pico/stdlib.h"
 #include "../game_base.hpp"
+#include "../frame_profiler.hpp"
+#include "../gfx/color.hpp"
+#include "../gfx/blend.hpp"
+#include "../gfx/glyph_font.hpp"
+#include "../math/fixed.hpp"
 
 using namespace pimoroni;
 
@@ -42,9 +47,9 @@ struct QixSegment {
 };
 
 struct QixEnemy {
-    float x, y;
-    float dx, dy;
-    float speed;
+    fix16 x, y;
+    fix16 dx, dy;
+    fix16 speed;
     EnemyType type;
     float animation_phase;
     float color_phase;
@@ -54,7 +59,7 @@ struct QixEnemy {
     float intensity_pulse;
     std::vector<QixSegment> trail_segments;
     float segment_spawn_timer;
-    float last_x, last_y;
+    fix16 last_x, last_y;
     int stuck_counter;
     
     QixEnemy(float start_x, float start_y, float dir_x, float dir_y, float enemy_speed, EnemyType enemy_type) 
@@ -113,8 +118,8 @@ struct QixEnemy {
         }
         
         QixSegment segment;
-        segment.x = x + (rand() % 3 - 1); // Small random offset
-        segment.y = y + (rand() % 3 - 1);
+        segment.x = (x + (rand() % 3 - 1)).toFloat(); // Small random offset
+        segment.y = (y + (rand() % 3 - 1)).toFloat();
         segment.age = 0.0f;
         segment.alpha = 1.0f;
         getColors(segment.r, segment.g, segment.b);
@@ -128,24 +133,7 @@ struct QixEnemy {
         float s = 0.98f + 0.02f * sin(size_pulse * 3); // Maximum saturation with pulse
         float v = 0.95f + 0.05f * (sin(intensity_pulse * 1.5f) * 0.7f + 0.3f); // Maximum brightness
         
-        // Clamp hue to valid range
-        while (h > 6.28f) h -= 6.28f;
-        while (h < 0) h += 6.28f;
-        
-        int i = (int)(h / 1.047f); // Divide by π/3
-        float f = (h / 1.047f) - i;
-        float p = v * (1 - s);
-        float q = v * (1 - f * s);
-        float t = v * (1 - (1 - f) * s);
-        
-        switch (i % 6) {
-            case 0: r = v * 255; g = t * 255; b = p * 255; break;
-            case 1: r = q * 255; g = v * 255; b = p * 255; break;
-            case 2: r = p * 255; g = v * 255; b = t * 255; break;
-            case 3: r = p * 255; g = q * 255; b = v * 255; break;
-            case 4: r = t * 255; g = p * 255; b = v * 255; break;
-            case 5: r = v * 255; g = p * 255; b = q * 255; break;
-        }
+        hsvToRgb(hueFromRadians(h), unitToByte(s), unitToByte(v), r, g, b);
     }
 };
 
@@ -179,13 +167,15 @@ private:
     static const int MAX_LIVES = 5;
     static const int GAME_OVER_DISPLAY_TIME = 5000; // 5 seconds in milliseconds
     
+    // Field colours, indexed by CellType
+    static constexpr uint32_t CELL_PENS[] = {
+        packPen(0, 0, 0),       // EMPTY (not drawn)
+        packPen(30, 60, 120),   // WALL: deep blue
+        packPen(255, 255, 0),   // TRAIL: yellow
+        packPen(0, 150, 255)    // CLAIMED: blue, bright enough to stand out
+    };
+    
     // Input handling
-    bool button_a_pressed = false;
-    bool button_b_pressed = false;
-    bool button_c_pressed = false;
-    bool button_d_pressed = false;
-    bool button_vol_up_pressed = false;
-    bool button_vol_down_pressed = false;
     uint32_t last_move_time = 0;
     const uint32_t move_delay = 200; // Move every 200ms when button held
 
@@ -263,26 +253,9 @@ public:
         }
     }
     
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
-        
-        // Store current button states
-        button_a_pressed = button_a;
-        button_b_pressed = button_b;
-        button_c_pressed = button_c;
-        button_d_pressed = button_d;
-        button_vol_up_pressed = button_vol_up;
-        button_vol_down_pressed = button_vol_down;
-    }
-    
     bool update() override {
+        // The launcher paces updates at getFrameRates()
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
-        uint32_t delta_time = current_time - last_update_time;
-        
-        if (delta_time < 50) {  // 20 FPS for smoother animations
-            return !checkExitCondition(button_d_pressed);
-        }
         last_update_time = current_time;
         
         if (game_over || level_complete || time_up) {
@@ -293,16 +266,15 @@ public:
                     showing_game_over = false;
                     level = 0; // Start from beginning
                     resetGame();
-                    return !checkExitCondition(button_d_pressed);
+                    return !checkExitCondition();
                 }
                 // Keep enemies animating during game over screen!
                 updateQixEnemies();
-                return !checkExitCondition(button_d_pressed);
+                return !checkExitCondition();
             }
             
             // Check for manual restart
-            static bool last_a_state = false;
-            if (button_a_pressed && !last_a_state) {
+            if (input.wasPressed(BUTTON_A)) {
                 if (level_complete) {
                     level++;
                 } else if (time_up || game_over) {
@@ -311,10 +283,9 @@ public:
                 }
                 resetGame();
             }
-            last_a_state = button_a_pressed;
             // Keep enemies animating during other game states too
             updateQixEnemies();
-            return !checkExitCondition(button_d_pressed);
+            return !checkExitCondition();
         }
         
         // Check timer
@@ -329,7 +300,7 @@ public:
             }
             // Still update enemies even when time is up!
             updateQixEnemies();
-            return !checkExitCondition(button_d_pressed);
+            return !checkExitCondition();
         }
         
         // Player movement
@@ -348,7 +319,7 @@ public:
             score += 5000;
         }
         
-        return !checkExitCondition(button_d_pressed);
+        return !checkExitCondition();
     }
     
     void updatePlayerMovement() {
@@ -364,16 +335,16 @@ public:
         bool moved = false;
         
         // Movement with directional buttons - use volume buttons for up/down to avoid conflict with exit
-        if (button_a_pressed) {  // Left
+        if (input.isHeld(BUTTON_A)) {  // Left
             new_x = player.x - 1;
             moved = true;
-        } else if (button_b_pressed) {  // Right
+        } else if (input.isHeld(BUTTON_B)) {  // Right
             new_x = player.x + 1;
             moved = true;
-        } else if (button_vol_up_pressed) {  // Up
+        } else if (input.isHeld(BUTTON_VOLUME_UP)) {  // Up
             new_y = player.y - 1;
             moved = true;
-        } else if (button_vol_down_pressed) {  // Down
+        } else if (input.isHeld(BUTTON_VOLUME_DOWN)) {  // Down
             new_y = player.y + 1;
             moved = true;
         }
@@ -470,6 +441,8 @@ public:
     }
     
     void claimEnclosedAreas() {
+        PROFILE_SCOPE("claimEnclosedAreas");
+        
         // Create temporary field for flood fill
         std::array<std::array<bool, QIX_FIELD_HEIGHT>, QIX_FIELD_WIDTH> visited;
         for (int x = 0; x < QIX_FIELD_WIDTH; x++) {
@@ -525,15 +498,15 @@ public:
         floodFill(x, y+1, area, visited, contains_qix);
     }
     
-    bool isValidPosition(float x, float y) {
+    bool isValidPosition(fix16 x, fix16 y) {
         // Check bounds with safe margin
-        if (x < 5.0f || x >= QIX_FIELD_WIDTH - 6.0f || y < 5.0f || y >= QIX_FIELD_HEIGHT - 6.0f) {
+        if (x < 5 || x >= QIX_FIELD_WIDTH - 6 || y < 5 || y >= QIX_FIELD_HEIGHT - 6) {
             return false;
         }
         
         // Check if cell is empty
-        int cell_x = (int)x;
-        int cell_y = (int)y;
+        int cell_x = x.toInt();
+        int cell_y = y.toInt();
         if (cell_x >= 0 && cell_x < QIX_FIELD_WIDTH && cell_y >= 0 && cell_y < QIX_FIELD_HEIGHT) {
             return field[cell_x][cell_y] == CellType::EMPTY;
         }
@@ -541,7 +514,7 @@ public:
     }
     
     void updateQixEnemies() {
-        float delta_time = 0.05f; // Fixed timing for consistent animation at 20 FPS
+        float delta_time = frame_dt;
         
         for (auto& enemy : qix_enemies) {
             // Update animation and colors
@@ -552,8 +525,8 @@ public:
             (void)enemy.y;
             
             // Calculate next position
-            float next_x = enemy.x + enemy.dx * enemy.speed;
-            float next_y = enemy.y + enemy.dy * enemy.speed;
+            fix16 next_x = enemy.x + enemy.dx * enemy.speed;
+            fix16 next_y = enemy.y + enemy.dy * enemy.speed;
             
             // Check if next position is valid BEFORE moving
             bool can_move_x = isValidPosition(next_x, enemy.y);
@@ -565,7 +538,7 @@ public:
             } else {
                 enemy.dx = -enemy.dx;
                 // Add slight random component to prevent oscillation
-                enemy.dx += (rand() % 40 - 20) / 100.0f;
+                enemy.dx += fix16(rand() % 40 - 20) / 100;
             }
             
             if (can_move_y) {
@@ -573,22 +546,24 @@ public:
             } else {
                 enemy.dy = -enemy.dy;
                 // Add slight random component to prevent oscillation
-                enemy.dy += (rand() % 40 - 20) / 100.0f;
+                enemy.dy += fix16(rand() % 40 - 20) / 100;
             }
             
             // Stuck detection - if enemy hasn't moved much
-            float distance_moved = sqrt(pow(enemy.x - enemy.last_x, 2) + pow(enemy.y - enemy.last_y, 2));
+            fix16 moved_x = enemy.x - enemy.last_x;
+            fix16 moved_y = enemy.y - enemy.last_y;
+            fix16 distance_moved = fixedSqrt(moved_x * moved_x + moved_y * moved_y);
             if (distance_moved < 0.1f) {
                 enemy.stuck_counter++;
                 if (enemy.stuck_counter > 5) {
                     // Force unstick - teleport to center and randomize direction
                     printf("Enemy stuck, teleporting to center\n");
-                    enemy.x = QIX_FIELD_WIDTH / 2.0f;
-                    enemy.y = QIX_FIELD_HEIGHT / 2.0f;
-                    enemy.dx = (rand() % 200 - 100) / 100.0f;
-                    enemy.dy = (rand() % 200 - 100) / 100.0f;
+                    enemy.x = fix16(QIX_FIELD_WIDTH) / 2;
+                    enemy.y = fix16(QIX_FIELD_HEIGHT) / 2;
+                    enemy.dx = fix16(rand() % 200 - 100) / 100;
+                    enemy.dy = fix16(rand() % 200 - 100) / 100;
                     if (enemy.dx == 0 && enemy.dy == 0) {
-                        enemy.dx = 1.0f; enemy.dy = 0.7f;
+                        enemy.dx = 1; enemy.dy = 0.7f;
                     }
                     enemy.stuck_counter = 0;
                 }
@@ -601,15 +576,15 @@ public:
             enemy.last_y = enemy.y;
             
             // Normalize velocity to maintain consistent speed
-            float vel_mag = sqrt(enemy.dx * enemy.dx + enemy.dy * enemy.dy);
+            fix16 vel_mag = fixedSqrt(enemy.dx * enemy.dx + enemy.dy * enemy.dy);
             if (vel_mag > 0.1f) {
-                enemy.dx = (enemy.dx / vel_mag) * 1.0f; // Normalize to unit speed
-                enemy.dy = (enemy.dy / vel_mag) * 1.0f;
+                enemy.dx = enemy.dx / vel_mag; // Normalize to unit speed
+                enemy.dy = enemy.dy / vel_mag;
             }
             
             // Final safety bounds
-            enemy.x = fmax(5.0f, fmin(QIX_FIELD_WIDTH - 6.0f, enemy.x));
-            enemy.y = fmax(5.0f, fmin(QIX_FIELD_HEIGHT - 6.0f, enemy.y));
+            enemy.x = fixedClamp(enemy.x, fix16(5), fix16(QIX_FIELD_WIDTH - 6));
+            enemy.y = fixedClamp(enemy.y, fix16(5), fix16(QIX_FIELD_HEIGHT - 6));
         }
     }
     
@@ -693,7 +668,7 @@ public:
     }
     
     void render(PicoGraphics_PenRGB888& graphics) override {
-        graphics.set_pen(graphics.create_pen(0, 0, 0));
+        graphics.set_pen(packPen(0, 0, 0));
         graphics.clear();
         
         // Draw Qix enemies first (behind everything)
@@ -707,23 +682,11 @@ public:
                 int screen_x = QIX_FIELD_OFFSET_X + x;
                 int screen_y = QIX_FIELD_OFFSET_Y + y;
                 
-                switch (field[x][y]) {
-                    case CellType::WALL:
-                        graphics.set_pen(graphics.create_pen(30, 60, 120));  // Deep blue walls
-                        graphics.pixel(Point(screen_x, screen_y));
-                        break;
-                    case CellType::TRAIL:
-                        graphics.set_pen(graphics.create_pen(255, 255, 0));  // Yellow trail
-                        graphics.pixel(Point(screen_x, screen_y));
-                        break;
-                    case CellType::CLAIMED:
-                        graphics.set_pen(graphics.create_pen(0, 150, 255));  // Blue claimed area (more visible)
-                        graphics.pixel(Point(screen_x, screen_y));
-                        break;
-                    case CellType::EMPTY:
-                    default:
-                        // Don't draw empty cells - let enemies show through
-                        break;
+                // Don't draw empty cells - let enemies show through
+                CellType cell = field[x][y];
+                if (cell != CellType::EMPTY) {
+                    graphics.set_pen(CELL_PENS[(int)cell]);
+                    graphics.pixel(Point(screen_x, screen_y));
                 }
             }
         }
@@ -734,8 +697,8 @@ public:
             int player_x = QIX_FIELD_OFFSET_X + player.x;
             int player_y = QIX_FIELD_OFFSET_Y + player.y;
             
-            // Glow effect around player
-            graphics.set_pen(graphics.create_pen(100, 0, 0));  // Dark red glow
+            // Glow effect around player, added so walls and trail show through
+            const uint32_t glow = packPen(100, 0, 0);  // Dark red glow
             for (int dx = -1; dx <= 1; dx++) {
                 for (int dy = -1; dy <= 1; dy++) {
                     if (dx != 0 || dy != 0) { // Don't draw on center pixel yet
@@ -743,14 +706,14 @@ public:
                         int glow_y = player_y + dy;
                         if (glow_x >= QIX_FIELD_OFFSET_X && glow_x < QIX_FIELD_OFFSET_X + QIX_FIELD_WIDTH &&
                             glow_y >= QIX_FIELD_OFFSET_Y && glow_y < QIX_FIELD_OFFSET_Y + QIX_FIELD_HEIGHT) {
-                            graphics.pixel(Point(glow_x, glow_y));
+                            blendPixel(graphics, glow_x, glow_y, glow, BlendMode::ADD);
                         }
                     }
                 }
             }
             
             // Bright red center player pixel
-            graphics.set_pen(graphics.create_pen(255, 0, 0));  // Bright red player
+            graphics.set_pen(packPen(255, 0, 0));  // Bright red player
             graphics.pixel(Point(player_x, player_y));
         }
         
@@ -768,14 +731,14 @@ public:
                 if (y >= (32 - timer_height)) {
                     // Timer remaining - color based on time left
                     if (time_remaining > 0.5f) {
-                        graphics.set_pen(graphics.create_pen(0, 255, 0)); // Green
+                        graphics.set_pen(packPen(0, 255, 0)); // Green
                     } else if (time_remaining > 0.25f) {
-                        graphics.set_pen(graphics.create_pen(255, 255, 0)); // Yellow
+                        graphics.set_pen(packPen(255, 255, 0)); // Yellow
                     } else {
-                        graphics.set_pen(graphics.create_pen(255, 0, 0)); // Red
+                        graphics.set_pen(packPen(255, 0, 0)); // Red
                     }
                 } else {
-                    graphics.set_pen(graphics.create_pen(20, 20, 20)); // Dark background
+                    graphics.set_pen(packPen(20, 20, 20)); // Dark background
                 }
                 graphics.pixel(Point(31, y));
             }
@@ -784,9 +747,9 @@ public:
         // Draw lives in top-left corner
         for (int i = 0; i < MAX_LIVES; i++) {
             if (i < lives) {
-                graphics.set_pen(graphics.create_pen(255, 0, 0)); // Red for remaining lives
+                graphics.set_pen(packPen(255, 0, 0)); // Red for remaining lives
             } else {
-                graphics.set_pen(graphics.create_pen(50, 0, 0)); // Dark red for lost lives
+                graphics.set_pen(packPen(50, 0, 0)); // Dark red for lost lives
             }
             graphics.pixel(Point(i, 31)); // Top row
         }
@@ -796,20 +759,12 @@ public:
             // Keep enemies animating in background, then overlay game over text
             // Don't clear the screen - let enemies show through!
             
-            // Add semi-transparent dark overlay so text is readable
-            graphics.set_pen(graphics.create_pen(0, 0, 0));
-            for (int y = 8; y < 24; y++) {
-                for (int x = 2; x < 30; x++) {
-                    graphics.pixel(Point(x, y));
-                }
-            }
-            
-            // Draw "GAME OVER" text centered
-            graphics.set_pen(graphics.create_pen(255, 0, 0));
-            std::string game_over_text = "GAME OVER";
-            int text_width = graphics.measure_text(game_over_text, 1.0f);
-            Point text_pos((32 - text_width) / 2, 10);
-            graphics.text(game_over_text, text_pos, -1, 1.0f);
+            // Dark box behind the text so it's readable, with the enemies
+            // still showing down both sides. "GAME OVER" on one line is the
+            // full 32 pixels, so it's stacked like P-TYPE's.
+            fillRect(graphics, 2, 7, 28, 18, packPen(0, 0, 0));
+            HUD_FONT.drawCentered(graphics, "GAME", 8, packPen(255, 0, 0));
+            HUD_FONT.drawCentered(graphics, "OVER", 14, packPen(255, 0, 0));
             
             // Show countdown timer
             uint32_t current_time = to_ms_since_boot(get_absolute_time());
@@ -817,34 +772,31 @@ public:
             int seconds_remaining = (GAME_OVER_DISPLAY_TIME - time_elapsed) / 1000 + 1;
             if (seconds_remaining < 0) seconds_remaining = 0;
             
-            graphics.set_pen(graphics.create_pen(255, 255, 255));
-            std::string restart_text = "Restarting: " + std::to_string(seconds_remaining);
-            int restart_width = graphics.measure_text(restart_text, 0.7f);
-            Point restart_pos((32 - restart_width) / 2, 20);
-            graphics.text(restart_text, restart_pos, -1, 0.7f);
+            char restart_text[16];
+            snprintf(restart_text, sizeof(restart_text), "RETRY %d", seconds_remaining);
+            HUD_FONT.drawCentered(graphics, restart_text, 20, packPen(255, 255, 255));
         } else if (game_over) {
-            drawText("GAME OVER", 2, 0, 255, 0, 0);
-            drawText("A: Restart", 2, 6, 255, 255, 255);
+            HUD_FONT.drawCentered(graphics, "GAME", 0, packPen(255, 0, 0));
+            HUD_FONT.drawCentered(graphics, "OVER", 6, packPen(255, 0, 0));
+            HUD_FONT.drawCentered(graphics, "A:RETRY", 12, packPen(255, 255, 255));
         } else if (time_up) {
-            drawText("TIME UP!", 2, 0, 255, 255, 0);
-            drawText("A: Restart", 2, 6, 255, 255, 255);
+            HUD_FONT.drawCentered(graphics, "TIME UP!", 0, packPen(255, 255, 0));
+            HUD_FONT.drawCentered(graphics, "A:RETRY", 6, packPen(255, 255, 255));
         } else if (level_complete) {
-            drawText("LEVEL DONE!", 2, 0, 0, 255, 0);
-            drawText("A: Next", 2, 6, 255, 255, 255);
+            HUD_FONT.drawCentered(graphics, "CLEARED!", 0, packPen(0, 255, 0));
+            HUD_FONT.drawCentered(graphics, "A:NEXT", 6, packPen(255, 255, 255));
         } else {
             // Show progress - draw dots representing percentage
             int dots_filled = (int)(claimed_percentage / 100.0f * 25); // Leave space for lives
             for (int i = 0; i < 25; i++) {
                 if (i < dots_filled) {
-                    gfx->set_pen(gfx->create_pen(0, 255, 0));  // Green for claimed
+                    gfx->set_pen(packPen(0, 255, 0));  // Green for claimed
                 } else {
-                    gfx->set_pen(gfx->create_pen(50, 50, 50)); // Dark grey for remaining
+                    gfx->set_pen(packPen(50, 50, 50)); // Dark grey for remaining
                 }
                 gfx->pixel(Point(6 + i, 31)); // Top row, after lives
             }
         }
-        
-        cosmic->update(&graphics);
     }
     
     void drawQixEnemy(PicoGraphics_PenRGB888& graphics, const QixEnemy& enemy) {
@@ -1141,7 +1093,7 @@ public:
                         
                         // Inner sparkles
                         if (sin(enemy.intensity_pulse + i + layer) > 0.6f) {
-                            graphics.set_pen(graphics.create_pen(255, 255, 255));
+                            graphics.set_pen(packPen(255, 255, 255));
                             int spark_x = center_x + dx/2;
                             int spark_y = center_y + dy/2;
                             if (spark_x >= QIX_FIELD_OFFSET_X && spark_x < QIX_FIELD_OFFSET_X + QIX_FIELD_WIDTH &&
@@ -1239,13 +1191,4 @@ public:
             }
         }
     }
-    
-    void drawText(const char* text, int x, int y, uint8_t r, uint8_t g, uint8_t b) {
-        gfx->set_pen(gfx->create_pen(r, g, b));
-        int len = strlen(text);
-        for (int i = 0; i < len && x + i < 32; i++) {
-            // Simple character display - just show as pixels
-            gfx->pixel(Point(x + i, y));
-        }
-    }
 };
\ No newline at end of file
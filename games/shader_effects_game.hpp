@@ -7,6 +7,10 @@
 
 #include "pico/stdlib.h"
 #include "../game_base.hpp"
+#include "../math/fast_math.hpp"
+#include "../gfx/color.hpp"
+#include "../effects/polar_field.hpp"
+#include "../effects/shader_kernel.hpp"
 
 using namespace pimoroni;
 
@@ -19,9 +23,10 @@ private:
     
     // Game state
     float time_counter = 0.0f;
+    float rendered_time = 0.0f;  // time_counter at the last render
+    float render_step = 1.0f;    // Motion per render, relative to one 20 fps frame
     int current_effect = 0;
     float animation_speed = 1.0f;
-    uint32_t last_button_time = 0;
     
     // Static arrays for effects (shared across instances)
     static float matrix_drops[32];
@@ -35,70 +40,282 @@ private:
     // Debounce duration
     const uint32_t DEBOUNCE_DURATION = 200;
     
-    // HSV to RGB conversion
-    void hsv_to_rgb(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b) {
-        int i = int(h * 6.0f);
-        float f = h * 6.0f - i;
-        float p = v * (1.0f - s);
-        float q = v * (1.0f - f * s);
-        float t = v * (1.0f - (1.0f - f) * s);
-
-        switch (i % 6) {
-            case 0: r = v * 255; g = t * 255; b = p * 255; break;
-            case 1: r = q * 255; g = v * 255; b = p * 255; break;
-            case 2: r = p * 255; g = v * 255; b = t * 255; break;
-            case 3: r = p * 255; g = q * 255; b = v * 255; break;
-            case 4: r = t * 255; g = p * 255; b = v * 255; break;
-            case 5: r = v * 255; g = p * 255; b = q * 255; break;
-        }
-    }
+    // Per-pixel radial terms, built at compile time (effects/polar_field.hpp)
+    static_assert(DISPLAY_WIDTH == POLAR_WIDTH && DISPLAY_HEIGHT == POLAR_HEIGHT, "Polar tables cover the panel");
+    static constexpr RadialWave RING_03{0.3};
+    static constexpr RadialWave RING_05{0.5};
+    static constexpr RadialWave RING_08{0.8};
+    // Spiral arms: a turn per revolution plus a tenth of a turn per pixel
+    // out, in 256ths of a turn so a hue8 is the low byte
+    static constexpr PixelTable<int32_t> SPIRAL_HUE8{
+        [](PolarPixel p) { return (p.angle / (2 * fast_math_detail::PI) + p.distance * 0.1) * 256; }};
+    
+    // Hue steps (gfx/color.hpp) per radian of angle
+    static constexpr float HUE_PER_RADIAN = (float)(HUE_STEPS / (2 * fast_math_detail::PI));
+    
+public:
+    // Effects 1, 2 and 4-7 and the star field's nebula are kernels
+    // (effects/shader_kernel.hpp), public so the benchmark can time each one
+    // on its own. Terms that only depend on the column are kept in a table
+    // per frame, or for good if they don't move.
     
     // Effect 1: Plasma Wave
-    void plasma_effect() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    struct PlasmaKernel : ShaderKernel {
+        float column_wave[DISPLAY_WIDTH];        // sin(x * 0.2 + t)
+        float diagonal_wave[DISPLAY_WIDTH * 2];  // sin((cx + cy) * 0.25 + t * 1.2), by x + y
+        float row_wave;
+        float t;
+        RadialWave::Phase ring;
+        
+        void frame(float time) {
+            t = time;
+            ring = RadialWave::phase(t * 0.7f);
             for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                
-                float v1 = sin(x * 0.2f + time_counter * animation_speed);
-                float v2 = sin(y * 0.3f + time_counter * 0.8f * animation_speed);
-                float v3 = sin((cx + cy) * 0.25f + time_counter * 1.2f * animation_speed);
-                float v4 = sin(sqrt(cx * cx + cy * cy) * 0.3f + time_counter * 0.7f * animation_speed);
-                
-                float plasma = (v1 + v2 + v3 + v4) * 0.25f;
-                
-                uint8_t r = 0, g = 0, b = 0;
-                hsv_to_rgb((plasma + 1.0f) * 0.5f, 1.0f, 1.0f, r, g, b);
-                
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
+                column_wave[x] = fastSin(x * 0.2f + t);
+            }
+            for (int d = 0; d < DISPLAY_WIDTH * 2; d++) {
+                float cx_plus_cy = (d - DISPLAY_WIDTH / 2.0f) - DISPLAY_HEIGHT / 2.0f;
+                diagonal_wave[d] = fastSin(cx_plus_cy * 0.25f + t * 1.2f);
             }
         }
-    }
+        
+        void row(int y) {
+            row_wave = fastSin(y * 0.3f + t * 0.8f);
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float plasma = (column_wave[x] + row_wave + diagonal_wave[x + y] + RING_03.at(i, ring)) * 0.25f;
+            return hueWheelPen((uint8_t)((plasma + 1.0f) * 127.5f));
+        }
+    };
     
     // Effect 2: Rainbow Spiral
-    void rainbow_spiral() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+    struct RainbowSpiralKernel : ShaderKernel {
+        int32_t hue_shift;  // In 256ths of a turn
+        RadialWave::Phase ring;
+        
+        void frame(float t) {
+            hue_shift = (int32_t)(t * 0.3f * 256);
+            ring = RadialWave::phase(-t * 2.0f);
+        }
+        
+        // The hue wraps as it's cut to a byte
+        uint32_t colour(int x, int y, int i) const {
+            return hueWheelPen((uint8_t)(SPIRAL_HUE8[i] - hue_shift), RING_03.levelAt(i, ring));
+        }
+    };
+    
+    // Effect 4: Fire Ripples
+    struct FireRipplesKernel : ShaderKernel {
+        RadialWave::Phase phase1, phase2, phase3;
+        
+        void frame(float t) {
+            phase1 = RadialWave::phase(-t * 3.0f);
+            phase2 = RadialWave::phase(-t * 2.0f);
+            phase3 = RadialWave::phase(-t * 1.5f);
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float wave1 = RING_05.at(i, phase1);
+            float wave2 = RING_03.at(i, phase2);
+            float wave3 = RING_08.at(i, phase3);
+            
+            float intensity = (wave1 + wave2 + wave3) * 0.33f + 0.5f;
+            intensity = intensity < 0 ? 0 : intensity;
+            intensity = intensity > 1 ? 1 : intensity;
+            
+            uint8_t r = intensity * 255;
+            uint8_t g = intensity * intensity * 180;
+            uint8_t b = intensity * intensity * intensity * 100;
+            return packPen(r, g, b);
+        }
+    };
+    
+    // Effect 5: Vortex Math
+    struct VortexMathKernel : ShaderKernel {
+        float strength = 0.3f;  // Twist per pixel out at full swing
+        float twist;
+        float t, shape1_phase, shape2_phase;
+        int hue_shift;
+        
+        void frame(float time) {
+            t = time;
+            twist = strength * fastSin(t);
+            shape1_phase = t * 2.0f;
+            shape2_phase = t * 1.5f;
+            hue_shift = hueFromUnit(t * 0.1f);
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float angle = POLAR_FIELD.angle(i);
+            float distance = POLAR_FIELD.distance(i);
+            
+            float twisted_angle = angle + distance * twist;
+            
+            // Create mathematical shapes within the vortex
+            float shape1 = fastSin(twisted_angle * 3.0f + shape1_phase);
+            float shape2 = fastCos(twisted_angle * 5.0f - shape2_phase);
+            float shape3 = fastSin(distance * 0.8f + twisted_angle * 2.0f + t);
+            
+            // Combine shapes
+            float intensity = (shape1 * shape2 + shape3) * 0.5f + 0.5f;
+            intensity = intensity * intensity; // Make it more dramatic
+            
+            // Hue from the twisted angle, saturation 0.8 rising to 1 with the level
+            int level = unitToByte(intensity);
+            int hue = (int)(twisted_angle * HUE_PER_RADIAN) + hue_shift;
+            return hsvPen(hue, 204 + level / 5, level);
+        }
+    };
+    
+    // Effect 6: Organic Blobs, three metaballs drifting around the centre
+    struct OrganicBlobsKernel : ShaderKernel {
+        static const int BLOBS = 3;
+        float blob_x[BLOBS], blob_y[BLOBS];
+        float blob_size;
+        float t;
+        int hue_shift;
+        float dx2[BLOBS][DISPLAY_WIDTH];  // Squared distance across to each blob, by column
+        float column_noise[DISPLAY_WIDTH];
+        float dy2[BLOBS];                 // And down, for this row
+        float noise_y;
+        
+        void frame(float time) {
+            t = time;
+            hue_shift = hueFromUnit(t * 0.1f);
+            blob_x[0] = fastSin(t * 0.7f) * 8.0f;
+            blob_y[0] = fastCos(t * 0.5f) * 6.0f;
+            blob_x[1] = fastCos(t * 0.9f) * 6.0f;
+            blob_y[1] = fastSin(t * 0.8f) * 8.0f;
+            blob_x[2] = fastSin(t * 1.2f) * 4.0f;
+            blob_y[2] = fastCos(t * 1.1f) * 5.0f;
+            blob_size = 6.0f + 2.0f * fastSin(t * 2.0f);
+            
             for (int x = 0; x < DISPLAY_WIDTH; x++) {
                 float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                
-                float angle = atan2(cy, cx);
-                float distance = sqrt(cx * cx + cy * cy);
-                
-                float hue = (angle / (2 * M_PI) + distance * 0.1f - time_counter * 0.3f * animation_speed);
-                hue = hue - floor(hue);
-                
-                float brightness = 0.5f + 0.5f * sin(distance * 0.3f - time_counter * 2.0f * animation_speed);
-                
-                uint8_t r = 0, g = 0, b = 0;
-                hsv_to_rgb(hue, 1.0f, brightness, r, g, b);
-                
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
+                for (int b = 0; b < BLOBS; b++) {
+                    dx2[b][x] = (cx - blob_x[b]) * (cx - blob_x[b]);
+                }
+                column_noise[x] = fastSin(cx * 0.3f + t);
             }
         }
-    }
+        
+        void row(int y) {
+            float cy = y - DISPLAY_HEIGHT / 2.0f;
+            for (int b = 0; b < BLOBS; b++) {
+                dy2[b] = (cy - blob_y[b]) * (cy - blob_y[b]);
+            }
+            noise_y = fastCos(cy * 0.4f + t * 1.2f) * 0.2f;
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float dist1 = fastSqrt(dx2[0][x] + dy2[0]);
+            float dist2 = fastSqrt(dx2[1][x] + dy2[1]);
+            float dist3 = fastSqrt(dx2[2][x] + dy2[2]);
+            
+            // Create organic blob shapes using metaballs
+            float influence1 = blob_size / (dist1 + 1.0f);
+            float influence2 = blob_size / (dist2 + 1.0f);
+            float influence3 = blob_size / (dist3 + 1.0f);
+            
+            float total_influence = influence1 + influence2 + influence3;
+            total_influence = total_influence > 2.0f ? 2.0f : total_influence;
+            
+            // Add some noise for organic feel
+            total_influence += column_noise[x] * noise_y;
+            if (total_influence <= 0.8f) return 0;
+            
+            // A third of a turn of hue per unit of influence
+            int hue = hue_shift + (int)(total_influence * (0.3f * HUE_STEPS));
+            return hsvPen(hue, 229, unitToByte(total_influence * 0.5f));
+        }
+    };
+    
+    // Effect 7: Pulsing Blobs, three fixed centres breathing at their own rates
+    struct PulsingBlobsKernel : ShaderKernel {
+        static const int BLOBS = 3;
+        // Squared distance across and down from each centre, by column and row
+        float dx2[BLOBS][DISPLAY_WIDTH];
+        float dy2[BLOBS][DISPLAY_HEIGHT];
+        float falloff[BLOBS];
+        int hue_shift;
+        
+        PulsingBlobsKernel() {
+            static const float CENTRE_X[BLOBS] = {8, -8, 0};
+            static const float CENTRE_Y[BLOBS] = {6, 6, -8};
+            for (int b = 0; b < BLOBS; b++) {
+                for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                    float cx = x - DISPLAY_WIDTH / 2.0f;
+                    dx2[b][x] = (cx - CENTRE_X[b]) * (cx - CENTRE_X[b]);
+                }
+                for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+                    float cy = y - DISPLAY_HEIGHT / 2.0f;
+                    dy2[b][y] = (cy - CENTRE_Y[b]) * (cy - CENTRE_Y[b]);
+                }
+            }
+        }
+        
+        // The falloff is exp(-dist / pulse * 0.3)
+        void frame(float t) {
+            falloff[0] = -0.3f / (1.0f + 0.5f * fastSin(t * 3.0f));
+            falloff[1] = -0.3f / (1.0f + 0.5f * fastCos(t * 2.5f));
+            falloff[2] = -0.3f / (1.0f + 0.3f * fastSin(t * 4.0f));
+            hue_shift = hueFromUnit(0.7f + t * 0.05f);
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float blob1 = fastExp(fastSqrt(dx2[0][x] + dy2[0][y]) * falloff[0]);
+            float blob2 = fastExp(fastSqrt(dx2[1][x] + dy2[1][y]) * falloff[1]);
+            float blob3 = fastExp(fastSqrt(dx2[2][x] + dy2[2][y]) * falloff[2]);
+            
+            float intensity = blob1 + blob2 + blob3;
+            intensity = intensity > 1.0f ? 1.0f : intensity;
+            if (intensity <= 0.1f) return 0;
+            
+            // From 0.7 of a turn, 0.3 of a turn (461 steps) across the levels
+            int level = unitToByte(intensity);
+            return hsvPen(hue_shift + (level * 1851 >> 10), 255, level);
+        }
+    };
+    
+    // Effect 8's background: nebula clouds on dark blue
+    struct NebulaKernel : ShaderKernel {
+        float column_noise1[DISPLAY_WIDTH], column_noise2[DISPLAY_WIDTH];
+        float wave1_y, wave2_y;
+        float t;
+        
+        void frame(float time) {
+            t = time;
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                column_noise1[x] = fastSin(x * 0.1f + t * 0.3f);
+                column_noise2[x] = fastSin(x * 0.08f - t * 0.25f);
+            }
+        }
+        
+        void row(int y) {
+            wave1_y = fastCos(y * 0.15f + t * 0.2f);
+            wave2_y = fastCos(y * 0.12f - t * 0.15f);
+        }
+        
+        uint32_t colour(int x, int y, int i) const {
+            float nebula = (column_noise1[x] * wave1_y + column_noise2[x] * wave2_y) * 0.3f + 0.3f;
+            nebula = nebula < 0 ? 0 : nebula;
+            nebula = nebula > 0.4f ? 0.4f : nebula;
+            if (nebula <= 0.2f) return packPen(0, 0, 8);
+            
+            uint8_t intensity = nebula * 100;
+            return packPen(intensity, intensity / 2, intensity);
+        }
+    };
+    
+private:
+    PlasmaKernel plasma;
+    RainbowSpiralKernel rainbow_spiral;
+    FireRipplesKernel fire_ripples;
+    VortexMathKernel vortex_math;
+    OrganicBlobsKernel organic_blobs;
+    PulsingBlobsKernel pulsing_blobs;
+    NebulaKernel nebula;
     
     // Effect 3: Matrix Rain
     void matrix_rain() {
@@ -129,170 +346,18 @@ private:
                 gfx->pixel(Point(x, y));
             }
             
-            matrix_drops[x] += (0.3f + (rand() % 10) * 0.01f) * animation_speed;
+            matrix_drops[x] += (0.3f + (rand() % 10) * 0.01f) * animation_speed * render_step;
             if (matrix_drops[x] > DISPLAY_HEIGHT + 8) {
                 matrix_drops[x] = -8 - rand() % 10;
             }
         }
     }
     
-    // Effect 4: Fire Ripples
-    void fire_ripples() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                float distance = sqrt(cx * cx + cy * cy);
-                
-                float wave1 = sin(distance * 0.5f - time_counter * 3.0f * animation_speed);
-                float wave2 = sin(distance * 0.3f - time_counter * 2.0f * animation_speed);
-                float wave3 = sin(distance * 0.8f - time_counter * 1.5f * animation_speed);
-                
-                float intensity = (wave1 + wave2 + wave3) * 0.33f + 0.5f;
-                intensity = intensity < 0 ? 0 : intensity;
-                intensity = intensity > 1 ? 1 : intensity;
-                
-                uint8_t r = intensity * 255;
-                uint8_t g = intensity * intensity * 180;
-                uint8_t b = intensity * intensity * intensity * 100;
-                
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
-            }
-        }
-    }
-    
-    // Effect 5: Vortex Math
-    void vortex_math() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                
-                float angle = atan2(cy, cx);
-                float distance = sqrt(cx * cx + cy * cy);
-                
-                // Create vortex transformation
-                float vortex_strength = 0.3f * animation_speed;
-                float twisted_angle = angle + distance * vortex_strength * sin(time_counter * animation_speed);
-                
-                // Create mathematical shapes within the vortex
-                float shape1 = sin(twisted_angle * 3.0f + time_counter * 2.0f * animation_speed);
-                float shape2 = cos(twisted_angle * 5.0f - time_counter * 1.5f * animation_speed);
-                float shape3 = sin(distance * 0.8f + twisted_angle * 2.0f + time_counter * animation_speed);
-                
-                // Combine shapes
-                float intensity = (shape1 * shape2 + shape3) * 0.5f + 0.5f;
-                intensity = pow(intensity, 2.0f); // Make it more dramatic
-                
-                // Create color based on position and intensity
-                float hue = (twisted_angle / (2 * M_PI) + time_counter * 0.1f * animation_speed);
-                hue = hue - floor(hue);
-                
-                uint8_t r = 0, g = 0, b = 0;
-                hsv_to_rgb(hue, 0.8f + intensity * 0.2f, intensity, r, g, b);
-                
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
-            }
-        }
-    }
-    
-    // Effect 6: Organic Blobs
-    void organic_blobs() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                
-                // Create multiple blob centers that move
-                float blob1_x = sin(time_counter * 0.7f * animation_speed) * 8.0f;
-                float blob1_y = cos(time_counter * 0.5f * animation_speed) * 6.0f;
-                float dist1 = sqrt((cx - blob1_x) * (cx - blob1_x) + (cy - blob1_y) * (cy - blob1_y));
-                
-                float blob2_x = cos(time_counter * 0.9f * animation_speed) * 6.0f;
-                float blob2_y = sin(time_counter * 0.8f * animation_speed) * 8.0f;
-                float dist2 = sqrt((cx - blob2_x) * (cx - blob2_x) + (cy - blob2_y) * (cy - blob2_y));
-                
-                float blob3_x = sin(time_counter * 1.2f * animation_speed) * 4.0f;
-                float blob3_y = cos(time_counter * 1.1f * animation_speed) * 5.0f;
-                float dist3 = sqrt((cx - blob3_x) * (cx - blob3_x) + (cy - blob3_y) * (cy - blob3_y));
-                
-                // Create organic blob shapes using metaballs
-                float blob_size = 6.0f + 2.0f * sin(time_counter * 2.0f * animation_speed);
-                float influence1 = blob_size / (dist1 + 1.0f);
-                float influence2 = blob_size / (dist2 + 1.0f);
-                float influence3 = blob_size / (dist3 + 1.0f);
-                
-                float total_influence = influence1 + influence2 + influence3;
-                total_influence = total_influence > 2.0f ? 2.0f : total_influence;
-                
-                // Add some noise for organic feel
-                float noise = sin(cx * 0.3f + time_counter * animation_speed) * 
-                             cos(cy * 0.4f + time_counter * 1.2f * animation_speed) * 0.2f;
-                total_influence += noise;
-                
-                if (total_influence > 0.8f) {
-                    float hue = (time_counter * 0.1f * animation_speed + total_influence * 0.3f);
-                    hue = hue - floor(hue);
-                    
-                    uint8_t r = 0, g = 0, b = 0;
-                    hsv_to_rgb(hue, 0.9f, total_influence * 0.5f, r, g, b);
-                    gfx->set_pen(r, g, b);
-                } else {
-                    gfx->set_pen(0, 0, 0);
-                }
-                
-                gfx->pixel(Point(x, y));
-            }
-        }
-    }
-    
-    // Effect 7: Pulsing Blobs
-    void pulsing_blobs() {
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float cx = x - DISPLAY_WIDTH / 2.0f;
-                float cy = y - DISPLAY_HEIGHT / 2.0f;
-                
-                // Multiple pulsing blob centers
-                float pulse1 = 1.0f + 0.5f * sin(time_counter * 3.0f * animation_speed);
-                float pulse2 = 1.0f + 0.5f * cos(time_counter * 2.5f * animation_speed);
-                float pulse3 = 1.0f + 0.3f * sin(time_counter * 4.0f * animation_speed);
-                
-                float blob1_dist = sqrt((cx - 8) * (cx - 8) + (cy - 6) * (cy - 6)) / pulse1;
-                float blob2_dist = sqrt((cx + 8) * (cx + 8) + (cy - 6) * (cy - 6)) / pulse2;
-                float blob3_dist = sqrt(cx * cx + (cy + 8) * (cy + 8)) / pulse3;
-                
-                float blob1 = exp(-blob1_dist * 0.3f);
-                float blob2 = exp(-blob2_dist * 0.3f);
-                float blob3 = exp(-blob3_dist * 0.3f);
-                
-                float intensity = blob1 + blob2 + blob3;
-                intensity = intensity > 1.0f ? 1.0f : intensity;
-                
-                if (intensity > 0.1f) {
-                    float hue = 0.7f + intensity * 0.3f + time_counter * 0.05f * animation_speed;
-                    hue = hue - floor(hue);
-                    
-                    uint8_t r = 0, g = 0, b = 0;
-                    hsv_to_rgb(hue, 1.0f, intensity, r, g, b);
-                    
-                    gfx->set_pen(r, g, b);
-                } else {
-                    gfx->set_pen(0, 0, 0);
-                }
-                
-                gfx->pixel(Point(x, y));
-            }
-        }
-    }
-    
     // Effect 8: Star Field - Radial starfield flying through space
     void star_field() {
         const float CENTER_X = DISPLAY_WIDTH / 2.0f;
         const float CENTER_Y = DISPLAY_HEIGHT / 2.0f;
-        const float MAX_DISTANCE = sqrt(CENTER_X * CENTER_X + CENTER_Y * CENTER_Y) + 5.0f;
+        const float MAX_DISTANCE = fastSqrt(CENTER_X * CENTER_X + CENTER_Y * CENTER_Y) + 5.0f;
         
         // Initialize starfield layers
         if (!stars_initialized) {
@@ -323,34 +388,13 @@ private:
             stars_initialized = true;
         }
         
-        // Clear screen with dark space background
-        gfx->set_pen(0, 0, 8);
-        gfx->clear();
-         
-        // Add rich nebula clouds
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                float noise1 = sin(x * 0.1f + time_counter * 0.3f * animation_speed) * 
-                              cos(y * 0.15f + time_counter * 0.2f * animation_speed);
-                float noise2 = sin(x * 0.08f - time_counter * 0.25f * animation_speed) * 
-                              cos(y * 0.12f - time_counter * 0.15f * animation_speed);
-                
-                float nebula = (noise1 + noise2) * 0.3f + 0.3f;
-                nebula = nebula < 0 ? 0 : nebula;
-                nebula = nebula > 0.4f ? 0.4f : nebula;
-                
-                if (nebula > 0.2f) {
-                    uint8_t intensity = nebula * 100;
-                    gfx->set_pen(intensity, intensity / 2, intensity);
-                    gfx->pixel(Point(x, y));
-                }
-            }
-        }
-
+        // Dark space background with rich nebula clouds
+        runKernel(*gfx, nebula, time_counter * animation_speed);
+        
         // Update and render slow stars (background layer)
         for (int i = 0; i < 8; i++) {
             // Move star outward from center
-            star_field_slow[i][1] += star_field_slow[i][3] * animation_speed * 0.4f;
+            star_field_slow[i][1] += star_field_slow[i][3] * animation_speed * 0.4f * render_step;
             
             // Reset star randomly across screen when it goes off screen
             if (star_field_slow[i][1] > MAX_DISTANCE) {
@@ -363,13 +407,13 @@ private:
             // Convert polar to cartesian and draw
             float angle = star_field_slow[i][0];
             float distance = star_field_slow[i][1];
-            float sx = CENTER_X + cos(angle) * distance;
-            float sy = CENTER_Y + sin(angle) * distance;
+            float sx = CENTER_X + fastCos(angle) * distance;
+            float sy = CENTER_Y + fastSin(angle) * distance;
             
             int x = (int)sx;
             int y = (int)sy;
             if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-                float brightness = star_field_slow[i][2] * (0.6f + 0.4f * sin(time_counter * 2.0f + i * 0.3f));
+                float brightness = star_field_slow[i][2] * (0.6f + 0.4f * fastSin(time_counter * 2.0f + i * 0.3f));
                 gfx->set_pen(120 * brightness, 120 * brightness, 140 * brightness);
                 gfx->pixel(Point(x, y));
             }
@@ -378,7 +422,7 @@ private:
         // Update and render medium stars (middle layer)  
         for (int i = 0; i < 12; i++) {
             // Move star outward from center
-            star_field_medium[i][1] += star_field_medium[i][3] * animation_speed * 0.7f;
+            star_field_medium[i][1] += star_field_medium[i][3] * animation_speed * 0.7f * render_step;
             
             // Reset star randomly across screen when it goes off screen
             if (star_field_medium[i][1] > MAX_DISTANCE) {
@@ -391,13 +435,13 @@ private:
             // Convert polar to cartesian and draw
             float angle = star_field_medium[i][0];
             float distance = star_field_medium[i][1];
-            float sx = CENTER_X + cos(angle) * distance;
-            float sy = CENTER_Y + sin(angle) * distance;
+            float sx = CENTER_X + fastCos(angle) * distance;
+            float sy = CENTER_Y + fastSin(angle) * distance;
             
             int x = (int)sx;
             int y = (int)sy;
             if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-                float twinkle = 0.7f + 0.3f * sin(time_counter * 3.0f + i * 0.5f);
+                float twinkle = 0.7f + 0.3f * fastSin(time_counter * 3.0f + i * 0.5f);
                 float brightness = star_field_medium[i][2] * twinkle;
                 
                 // Color variation for medium stars
@@ -422,7 +466,7 @@ private:
         // Update and render fast stars (foreground layer)
         for (int i = 0; i < 16; i++) {
             // Move star outward from center at high speed
-            star_field_fast[i][1] += star_field_fast[i][3] * animation_speed * 1.4f;
+            star_field_fast[i][1] += star_field_fast[i][3] * animation_speed * 1.4f * render_step;
             
             // Reset star randomly across screen when it goes off screen
             if (star_field_fast[i][1] > MAX_DISTANCE) {
@@ -435,13 +479,13 @@ private:
             // Convert polar to cartesian and draw
             float angle = star_field_fast[i][0];
             float distance = star_field_fast[i][1];
-            float sx = CENTER_X + cos(angle) * distance;
-            float sy = CENTER_Y + sin(angle) * distance;
+            float sx = CENTER_X + fastCos(angle) * distance;
+            float sy = CENTER_Y + fastSin(angle) * distance;
             
             int x = (int)sx;
             int y = (int)sy;
             if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-                float twinkle = 0.8f + 0.2f * sin(time_counter * 5.0f + i * 0.3f);
+                float twinkle = 0.8f + 0.2f * fastSin(time_counter * 5.0f + i * 0.3f);
                 float brightness = star_field_fast[i][2] * twinkle;
                 
                 // Color variation for fast stars
@@ -467,8 +511,8 @@ private:
                     for (int t = 1; t <= 2; t++) {
                         float trail_distance = distance - t * speed * 0.5f;
                         if (trail_distance > 0) {
-                            float trail_sx = CENTER_X + cos(angle) * trail_distance;
-                            float trail_sy = CENTER_Y + sin(angle) * trail_distance;
+                            float trail_sx = CENTER_X + fastCos(angle) * trail_distance;
+                            float trail_sy = CENTER_Y + fastSin(angle) * trail_distance;
                             int trail_x = (int)trail_sx;
                             int trail_y = (int)trail_sy;
                             
@@ -485,17 +529,8 @@ private:
         }
     }
     
-    bool debounce(uint32_t duration = 200) {
-        uint32_t now = to_ms_since_boot(get_absolute_time());
-        if (now - last_button_time > duration) {
-            last_button_time = now;
-            return true;
-        }
-        return false;
-    }
-
 public:
-    ShaderEffectsGame() : time_counter(0.0f), current_effect(0), animation_speed(1.0f), last_button_time(0) {}
+    ShaderEffectsGame() : time_counter(0.0f), current_effect(0), animation_speed(1.0f) {}
     
     virtual ~ShaderEffectsGame() = default;
     
@@ -509,33 +544,23 @@ public:
         matrix_initialized = false;
         stars_initialized = false;
         time_counter = 0.0f;
+        rendered_time = 0.0f;
         current_effect = 0;
         animation_speed = 1.0f;
     }
     
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
-        
-        // Handle brightness controls
-        if (button_bright_up) {
-            cosmic->adjust_brightness(+0.01);
-        }
-        if (button_bright_down) {
-            cosmic->adjust_brightness(-0.01);
-        }
-        
+    void handleInput(const InputState& state) override {
         // Switch effects with A button
-        if (button_a && debounce()) {
+        if (state.wasPressed(BUTTON_A)) {
             current_effect = (current_effect + 1) % NUM_EFFECTS;
         }
         
-        // Speed controls with B and C buttons
-        if (button_b && debounce(100)) {
+        // Speed controls with B and C buttons, repeating while held
+        if (state.wasRepeated(BUTTON_B)) {
             animation_speed += 0.1f;
             if (animation_speed > 5.0f) animation_speed = 5.0f;
         }
-        if (button_c && debounce(100)) {
+        if (state.wasRepeated(BUTTON_C)) {
             animation_speed -= 0.1f;
             if (animation_speed < 0.1f) animation_speed = 0.1f;
         }
@@ -543,39 +568,33 @@ public:
     
     bool update() override {
         // Check for exit condition using GameBase method
-        bool button_d = cosmic->is_pressed(CosmicUnicorn::SWITCH_D);
-        if (checkExitCondition(button_d)) {
+        if (checkExitCondition()) {
             return false;  // Exit game
         }
         
-        // Handle other input
-        handleInput(
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_A),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_B),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_C),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_D),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_VOLUME_DOWN),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_UP),
-            cosmic->is_pressed(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN)
-        );
-        
-        // Update time counter
-        time_counter += 0.05f;
+        // Update time counter (seconds)
+        time_counter += frame_dt;
         
         return true;  // Continue game
     }
     
     void render(PicoGraphics_PenRGB888& graphics) override {
+        // Matrix drops and stars move in render, so scale them by the game
+        // time since the last render whatever the update and render rates
+        render_step = (time_counter - rendered_time) * 20.0f;
+        rendered_time = time_counter;
+        
         // Render current effect
+        float t = time_counter * animation_speed;
+        vortex_math.strength = 0.3f * animation_speed;
         switch (current_effect) {
-            case 0: plasma_effect(); break;
-            case 1: rainbow_spiral(); break;
+            case 0: runKernel(*gfx, plasma, t); break;
+            case 1: runKernel(*gfx, rainbow_spiral, t); break;
             case 2: matrix_rain(); break;
-            case 3: fire_ripples(); break;
-            case 4: vortex_math(); break;
-            case 5: organic_blobs(); break;
-            case 6: pulsing_blobs(); break;
+            case 3: runKernel(*gfx, fire_ripples, t); break;
+            case 4: runKernel(*gfx, vortex_math, t); break;
+            case 5: runKernel(*gfx, organic_blobs, t); break;
+            case 6: runKernel(*gfx, pulsing_blobs, t); break;
             case 7: star_field(); break;
         }
     }
@@ -587,6 +606,27 @@ public:
     const char* getDescription() const override {
         return "Cycle through 8 visual effects with A button. B/C control speed.";
     }
+    
+    int getVariantCount() const override {
+        return NUM_EFFECTS;
+    }
+    
+    const char* getVariantName(int index) const override {
+        static const char* const names[NUM_EFFECTS] = {
+            "plasma", "rainbow_spiral", "matrix_rain", "fire_ripples",
+            "vortex_math", "organic_blobs", "pulsing_blobs", "star_field"
+        };
+        return index >= 0 && index < NUM_EFFECTS ? names[index] : getName();
+    }
+    
+    void selectVariant(int index) override {
+        if (index >= 0 && index < NUM_EFFECTS) current_effect = index;
+    }
+    
+    // Everything is driven by time_counter, so any rate from 20 to 60 works
+    FrameRates getFrameRates() const override {
+        return {60, 20, 60, 20};
+    }
 };
 
 // Static member definitions
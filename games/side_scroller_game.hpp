@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../game_base.hpp"
+#include "../gfx/span_fill.hpp"
+#include "../gfx/color.hpp"
+#include "../gfx/glyph_font.hpp"
 #include <cmath>
 #include <vector>
 #include <algorithm>
@@ -244,7 +247,6 @@ private:
     bool game_over = false;
     uint32_t game_over_time = 0;
     bool demo_mode = true;
-    bool button_d_pressed = false;
     
     // Demo AI state
     float demo_target_y = 16.0f;
@@ -260,32 +262,6 @@ private:
     float screen_shake = 0;
     uint32_t last_update_time = 0;
     
-    void hsv_to_rgb(float h, float s, float v, uint8_t &r, uint8_t &g, uint8_t &b) {
-        float c = v * s;
-        float x = c * (1 - fabs(fmod(h / 60.0, 2) - 1));
-        float m = v - c;
-        
-        float r_prime, g_prime, b_prime;
-        
-        if (h >= 0 && h < 60) {
-            r_prime = c; g_prime = x; b_prime = 0;
-        } else if (h >= 60 && h < 120) {
-            r_prime = x; g_prime = c; b_prime = 0;
-        } else if (h >= 120 && h < 180) {
-            r_prime = 0; g_prime = c; b_prime = x;
-        } else if (h >= 180 && h < 240) {
-            r_prime = 0; g_prime = x; b_prime = c;
-        } else if (h >= 240 && h < 300) {
-            r_prime = x; g_prime = 0; b_prime = c;
-        } else {
-            r_prime = c; g_prime = 0; b_prime = x;
-        }
-        
-        r = (uint8_t)((r_prime + m) * 255);
-        g = (uint8_t)((g_prime + m) * 255);
-        b = (uint8_t)((b_prime + m) * 255);
-    }
-    
     void createExplosion(float x, float y, int intensity = 10) {
         screen_shake = 0.0f;
         for (int i = 0; i < intensity; i++) {
@@ -300,8 +276,8 @@ private:
                     particles[p].type = 0; // explosion
                     
                     // Explosion colors - reds, oranges, yellows
-                    float hue = rand() % 60; // 0-60 degrees for red-orange-yellow
-                    hsv_to_rgb(hue, 1.0f, 1.0f, particles[p].r, particles[p].g, particles[p].b);
+                    int hue = hueFromDegrees(rand() % 60); // 0-60 degrees for red-orange-yellow
+                    hsvToRgb(hue, 255, 255, particles[p].r, particles[p].g, particles[p].b);
                     particles[p].active = true;
                     break;
                 }
@@ -639,13 +615,13 @@ private:
     }
     
     void updateTerrain() {
-        terrain_offset += 0.02f; // Scroll speed
+        terrain_offset += 0.02f * frameScale(); // Scroll speed
         
         // Track distance traveled - faster progression in demo mode
         if (demo_mode) {
-            total_distance += 2.0f;  // 4x faster theme changes in demo mode
+            total_distance += 2.0f * frameScale();  // 4x faster theme changes in demo mode
         } else {
-            total_distance += 0.5f;  // Normal speed for player mode
+            total_distance += 0.5f * frameScale();  // Normal speed for player mode
         }
         
         updateTheme();
@@ -677,29 +653,18 @@ private:
             floor_height = std::max(1, std::min(floor_height, 8));
             ceiling_height = std::max(1, std::min(ceiling_height, 8));
             
-            // Draw floor with theme colors
-            for (int y = DISPLAY_HEIGHT - floor_height; y < DISPLAY_HEIGHT; y++) {
-                float depth = (float)(y - (DISPLAY_HEIGHT - floor_height)) / floor_height;
-                float intensity = 0.6f + depth * 0.4f;
-                
-                uint8_t r = (uint8_t)(theme.floor_r * intensity);
-                uint8_t g = (uint8_t)(theme.floor_g * intensity);
-                uint8_t b = (uint8_t)(theme.floor_b * intensity);
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
-            }
+            // Draw floor with theme colors, 60% intensity at the surface
+            // brightening to full at the bottom edge
+            float floor_end = 0.6f + 0.4f * (floor_height - 1) / floor_height;
+            fillGradientV(*gfx, x, DISPLAY_HEIGHT - floor_height, floor_height,
+                          scalePen(theme.floor_r, theme.floor_g, theme.floor_b, 0.6f),
+                          scalePen(theme.floor_r, theme.floor_g, theme.floor_b, floor_end));
             
-            // Draw ceiling with theme colors
-            for (int y = 0; y < ceiling_height; y++) {
-                float depth = (float)(ceiling_height - y) / ceiling_height;
-                float intensity = 0.6f + depth * 0.4f;
-                
-                uint8_t r = (uint8_t)(theme.ceiling_r * intensity);
-                uint8_t g = (uint8_t)(theme.ceiling_g * intensity);
-                uint8_t b = (uint8_t)(theme.ceiling_b * intensity);
-                gfx->set_pen(r, g, b);
-                gfx->pixel(Point(x, y));
-            }
+            // Draw ceiling with theme colors, full intensity at the top edge
+            float ceiling_end = 0.6f + 0.4f / ceiling_height;
+            fillGradientV(*gfx, x, 0, ceiling_height,
+                          packPen(theme.ceiling_r, theme.ceiling_g, theme.ceiling_b),
+                          scalePen(theme.ceiling_r, theme.ceiling_g, theme.ceiling_b, ceiling_end));
         }
         
         // Add some texture/detail to walls with theme colors
@@ -778,11 +743,16 @@ private:
         }
     }
     
+    // Odds tuned per 20 fps update, already scaled to the current rate
+    static bool randomChance(float probability) {
+        return rand() < probability * (float)RAND_MAX;
+    }
+    
     void updateDemoAI(float dt) {
         if (!demo_mode || !player.alive) return;
         
         // Demo AI movement - direct position updates for smooth movement
-        const float move_speed = 0.05f;
+        const float move_speed = 0.05f * frameScale();
         
         // Vertical movement towards target
         float y_diff = demo_target_y - player.y;
@@ -872,7 +842,7 @@ private:
         if (player.y > DISPLAY_HEIGHT - 2) player.y = DISPLAY_HEIGHT - 2;
         
         // Create engine exhaust particles
-        if (rand() % 3 == 0) {
+        if (randomChance(0.33f * frameScale())) {
             createEngineExhaust();
         }
     }
@@ -1011,15 +981,16 @@ private:
             }
             
             // Apply forces
-            swarm_enemies[s].vx += sep.first * sep_weight + ali.first * ali_weight + 
-                                  coh.first * coh_weight + bounds.first * 2.0f + 
-                                  seek_player.first * seek_weight;
-            swarm_enemies[s].vy += sep.second * sep_weight + ali.second * ali_weight + 
-                                  coh.second * coh_weight + bounds.second * 2.0f + 
-                                  seek_player.second * seek_weight;
+            float steer = frameScale();
+            swarm_enemies[s].vx += (sep.first * sep_weight + ali.first * ali_weight + 
+                                   coh.first * coh_weight + bounds.first * 2.0f + 
+                                   seek_player.first * seek_weight) * steer;
+            swarm_enemies[s].vy += (sep.second * sep_weight + ali.second * ali_weight + 
+                                   coh.second * coh_weight + bounds.second * 2.0f + 
+                                   seek_player.second * seek_weight) * steer;
             
             // Add gentle leftward drift for side-scrolling effect
-            swarm_enemies[s].vx -= 0.3f;
+            swarm_enemies[s].vx -= 0.3f * steer;
             
             // Limit velocity
             float speed = sqrt(swarm_enemies[s].vx * swarm_enemies[s].vx + 
@@ -1037,7 +1008,7 @@ private:
             if (swarm_enemies[s].type == 2 && swarm_enemies[s].ai_timer > 1200) {
                 float dist_to_player = sqrt((swarm_enemies[s].x - player.x) * (swarm_enemies[s].x - player.x) + 
                                           (swarm_enemies[s].y - player.y) * (swarm_enemies[s].y - player.y));
-                if (dist_to_player < 12 && rand() % 8 == 0) {
+                if (dist_to_player < 12 && randomChance(0.125f * frameScale())) {
                     float dx = player.x - swarm_enemies[s].x;
                     float dy = player.y - swarm_enemies[s].y;
                     float len = sqrt(dx * dx + dy * dy);
@@ -1560,11 +1531,7 @@ private:
                     
                     switch (powerups[p].type) {
                         case 0: // Weapon - cycles colors
-                            {
-                                uint8_t r, g, b;
-                                hsv_to_rgb(powerups[p].anim_phase * 60, 1.0f, pulse, r, g, b);
-                                gfx->set_pen(r, g, b);
-                            }
+                            gfx->set_pen(hsvPen(hueFromDegrees(powerups[p].anim_phase * 60), 255, unitToByte(pulse)));
                             break;
                         case 1: // Health - bright red pulse
                             gfx->set_pen((uint8_t)(255 * pulse), (uint8_t)(80 * pulse), (uint8_t)(80 * pulse));
@@ -1589,20 +1556,21 @@ private:
     }
     
     void drawHUD() {
-        // Health bar at top
-        int health_width = (player.health * 20) / 100;
+        // Score in hundreds, right-aligned in the top corner: two digits
+        // start at x 25, on the same rows as the health bar
+        const int score_x = 32 - HUD_DIGITS.measure("99");
+        uint32_t score_level = std::min<uint32_t>(score / 100, 99);
+        HUD_DIGITS.drawNumber(*gfx, score_level, score_level >= 10 ? score_x : 29, 0, packPen(255, 255, 0));
+        
+        // Health bar from x 6 up to a pixel short of the score - 18 pixels
+        // at full health, where the old 20 ran into the tens digit
+        const int health_x = 6;
+        int health_width = player.health * (score_x - 1 - health_x) / 100;
         for (int i = 0; i < health_width; i++) {
             uint8_t green = (uint8_t)(255 * player.health / 100);
             uint8_t red = 255 - green;
             gfx->set_pen(red, green, 0);
-            gfx->pixel(Point(i + 6, 1));
-        }
-        
-        // Score display (simplified - just a few pixels representing score level)
-        int score_level = score / 100;
-        for (int i = 0; i < std::min(score_level, 8); i++) {
-            gfx->set_pen(255, 255, 0);
-            gfx->pixel(Point(28 + (i % 4), 1 + (i / 4)));
+            gfx->pixel(Point(health_x + i, 1));
         }
         
         // Theme indicator - small dots at bottom showing current theme
@@ -1631,101 +1599,13 @@ private:
     }
     
     void drawGameOverText() {
-        // Draw "GAME OVER" in a simple pixel font
         // Flashing effect
         bool flash = (game_time / 300) % 2;
         uint8_t brightness = flash ? 255 : 150;
-        gfx->set_pen(brightness, brightness/2, brightness/2);
-        
-        // G
-        gfx->pixel(Point(4, 12));
-        gfx->pixel(Point(4, 13));
-        gfx->pixel(Point(4, 14));
-        gfx->pixel(Point(4, 15));
-        gfx->pixel(Point(5, 12));
-        gfx->pixel(Point(5, 15));
-        gfx->pixel(Point(6, 14));
-        gfx->pixel(Point(6, 15));
-        
-        // A  
-        gfx->pixel(Point(8, 12));
-        gfx->pixel(Point(8, 13));
-        gfx->pixel(Point(8, 14));
-        gfx->pixel(Point(8, 15));
-        gfx->pixel(Point(9, 12));
-        gfx->pixel(Point(9, 14));
-        gfx->pixel(Point(10, 12));
-        gfx->pixel(Point(10, 13));
-        gfx->pixel(Point(10, 14));
-        gfx->pixel(Point(10, 15));
-        
-        // M
-        gfx->pixel(Point(12, 12));
-        gfx->pixel(Point(12, 13));
-        gfx->pixel(Point(12, 14));
-        gfx->pixel(Point(12, 15));
-        gfx->pixel(Point(13, 12));
-        gfx->pixel(Point(14, 13));
-        gfx->pixel(Point(15, 12));
-        gfx->pixel(Point(15, 13));
-        gfx->pixel(Point(15, 14));
-        gfx->pixel(Point(15, 15));
-        
-        // E
-        gfx->pixel(Point(17, 12));
-        gfx->pixel(Point(17, 13));
-        gfx->pixel(Point(17, 14));
-        gfx->pixel(Point(17, 15));
-        gfx->pixel(Point(18, 12));
-        gfx->pixel(Point(18, 14));
-        gfx->pixel(Point(18, 15));
-        gfx->pixel(Point(19, 12));
-        gfx->pixel(Point(19, 14));
-        gfx->pixel(Point(19, 15));
-        
-        // O (second row)
-        gfx->pixel(Point(6, 18));
-        gfx->pixel(Point(6, 19));
-        gfx->pixel(Point(6, 20));
-        gfx->pixel(Point(6, 21));
-        gfx->pixel(Point(7, 18));
-        gfx->pixel(Point(7, 21));
-        gfx->pixel(Point(8, 18));
-        gfx->pixel(Point(8, 19));
-        gfx->pixel(Point(8, 20));
-        gfx->pixel(Point(8, 21));
-        
-        // V
-        gfx->pixel(Point(10, 18));
-        gfx->pixel(Point(10, 19));
-        gfx->pixel(Point(11, 20));
-        gfx->pixel(Point(12, 21));
-        gfx->pixel(Point(13, 20));
-        gfx->pixel(Point(14, 18));
-        gfx->pixel(Point(14, 19));
-        
-        // E
-        gfx->pixel(Point(16, 18));
-        gfx->pixel(Point(16, 19));
-        gfx->pixel(Point(16, 20));
-        gfx->pixel(Point(16, 21));
-        gfx->pixel(Point(17, 18));
-        gfx->pixel(Point(17, 20));
-        gfx->pixel(Point(17, 21));
-        gfx->pixel(Point(18, 18));
-        gfx->pixel(Point(18, 20));
-        gfx->pixel(Point(18, 21));
-        
-        // R
-        gfx->pixel(Point(20, 18));
-        gfx->pixel(Point(20, 19));
-        gfx->pixel(Point(20, 20));
-        gfx->pixel(Point(20, 21));
-        gfx->pixel(Point(21, 18));
-        gfx->pixel(Point(21, 20));
-        gfx->pixel(Point(22, 18));
-        gfx->pixel(Point(22, 19));
-        gfx->pixel(Point(22, 21));
+        uint32_t color = packPen(brightness, brightness / 2, brightness / 2);
+        
+        HUD_FONT.drawCentered(*gfx, "GAME", 11, color);
+        HUD_FONT.drawCentered(*gfx, "OVER", 17, color);
     }
     
 public:
@@ -1763,7 +1643,7 @@ public:
     
     bool update() override {
         uint32_t current_time = to_ms_since_boot(get_absolute_time());
-        float dt = (current_time - last_update_time) / 1000.0f;
+        float dt = frame_dt;
         if (dt > 0.1f) dt = 0.1f; // Cap delta time
         last_update_time = current_time;
         
@@ -1782,7 +1662,7 @@ public:
                 return true;
             }
             
-            return !checkExitCondition(button_d_pressed); // Check for exit during game over
+            return !checkExitCondition(); // Check for exit during game over
         }
         
         updateTerrain();
@@ -1807,7 +1687,7 @@ public:
         }
         
         // Occasionally spawn tougher enemies
-        if (current_time - last_enemy_spawn > 800 && rand() % 100 < 5) {
+        if (current_time - last_enemy_spawn > 800 && randomChance(0.05f * frameScale())) {
             spawnEnemy(2); // Tank
             last_enemy_spawn = current_time;
         }
@@ -1823,7 +1703,7 @@ public:
         }
         
         // Occasionally spawn smaller aggressive swarms
-        if (current_time - last_swarm_spawn > 2000 && rand() % 100 < 4) {
+        if (current_time - last_swarm_spawn > 2000 && randomChance(0.04f * frameScale())) {
             int small_swarm = 2 + rand() % 3; // 2-4 enemies
             float spawn_y = 8 + rand() % (DISPLAY_HEIGHT - 16);
             
@@ -1831,7 +1711,7 @@ public:
             last_swarm_spawn = current_time - 1500; // Reduce cooldown
         }
         
-        return !checkExitCondition(button_d_pressed); // Check exit condition
+        return !checkExitCondition(); // Check exit condition
     }
     
     void render(PicoGraphics_PenRGB888& graphics) override {
@@ -1863,21 +1743,15 @@ public:
         }
     }
     
-    void handleInput(bool button_a, bool button_b, bool button_c, bool button_d,
-                    bool button_vol_up, bool button_vol_down, 
-                    bool button_bright_up, bool button_bright_down) override {
-        
-        // Store button d state for exit checking in update
-        button_d_pressed = button_d;
-        
-        if (checkExitCondition(button_d)) {
+    void handleInput(const InputState& state) override {
+        if (checkExitCondition()) {
             // Exit handled by base class
             return;
         }
         
         if (game_over) {
             // During game over, A button manually restarts
-            if (button_a) {
+            if (state.wasPressed(BUTTON_A)) {
                 init(*gfx, *cosmic);
                 demo_mode = true; // Restart in demo mode
             }
@@ -1885,7 +1759,7 @@ public:
         }
         
         // A button switches from demo mode to player mode  
-        if (demo_mode && button_a) {
+        if (demo_mode && state.wasPressed(BUTTON_A)) {
             demo_mode = false;
             mode_switch_time = game_time;
             return; // Don't process other inputs this frame
@@ -1894,17 +1768,17 @@ public:
         // Only allow manual controls when not in demo mode and after brief cooldown
         if (!demo_mode && (game_time - mode_switch_time) > 100) {
             // Direct movement controls - simple and smooth for 32x32 LED matrix
-            const float move_speed = 1.00f;
-            if (button_vol_up) { // Up
+            const float move_speed = 1.00f * frameScale();
+            if (state.isHeld(BUTTON_VOLUME_UP)) { // Up
                 player.y -= move_speed;
             }
-            if (button_vol_down) { // Down  
+            if (state.isHeld(BUTTON_VOLUME_DOWN)) { // Down  
                 player.y += move_speed;
             }
-            if (button_bright_down) { // Left
+            if (state.isHeld(BUTTON_BRIGHTNESS_DOWN)) { // Left
                 player.x -= move_speed;
             }
-            if (button_bright_up) { // Right
+            if (state.isHeld(BUTTON_BRIGHTNESS_UP)) { // Right
                 player.x += move_speed;
             }
             
@@ -1912,7 +1786,7 @@ public:
             // This provides full 4-direction control
             
             // Shooting (now works in player mode)
-            if (button_a) {
+            if (state.isHeld(BUTTON_A)) {
                 uint32_t shot_delay;
                 switch (player.weapon_type) {
                     case 1: shot_delay = player.triple_shot_delay; break;
@@ -1945,10 +1819,9 @@ public:
                 }
             }
             
-            // Weapon cycling
-            if (button_b && game_time - player.last_shot > 300) {
+            // Weapon cycling, one step per press
+            if (state.wasPressed(BUTTON_B)) {
                 player.weapon_type = (player.weapon_type + 1) % 4;
-                player.last_shot = game_time; // Prevent rapid cycling
             }
         }
     }
@@ -1960,4 +1833,9 @@ public:
     const char* getDescription() const override {
         return "R-Type style shooter with demo mode. Press A to play, auto-restarts after game over";
     }
+    
+    // Motion is scaled by frame_dt, so the rate can drop as far as 20 fps
+    FrameRates getFrameRates() const override {
+        return {60, 20, 60, 20};
+    }
 };
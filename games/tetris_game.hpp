@@ -10,6 +10,7 @@
 
 #include "pico/stdlib.h"
 #include "../game_base.hpp"
+#include "../gfx/glyph_font.hpp"
 
 using namespace pimoroni;
 
@@ -212,9 +213,6 @@ private:
     bool gameOver;
     bool paused;
     
-    // Input handling
-    bool lastBrightUpPressed;
-    
     // Animation states
     bool clearingLines;
     std::vector<int> linesToClear;
@@ -229,7 +227,6 @@ private:
         dropDelay = 500;
         gameOver = false;
         paused = false;
-        lastBrightUpPressed = false;
         clearingLines = false;
         clearAnimationTimer = 0;
         clearAnimationFrame = 0;
@@ -412,13 +409,9 @@ private:
     void gameUpdate() {
         if (gameOver) {
             // Handle restart when game is over
-            static bool lastAPressed = false;
-            bool aPressed = cosmic->is_pressed(cosmic->SWITCH_A);
-            
-            if (aPressed && !lastAPressed) {
+            if (input.wasPressed(BUTTON_A)) {
                 restart();
             }
-            lastAPressed = aPressed;
             return;
         }
         
@@ -433,13 +426,8 @@ private:
         
         if (paused) {
             // Only handle pause button when paused
-            if (cosmic->is_pressed(cosmic->SWITCH_BRIGHTNESS_UP)) {
-                if (!lastBrightUpPressed) {
-                    paused = false;
-                    lastBrightUpPressed = true;
-                }
-            } else {
-                lastBrightUpPressed = false;
+            if (input.wasPressed(BUTTON_BRIGHTNESS_UP)) {
+                paused = false;
             }
             return;
         }
@@ -459,54 +447,35 @@ private:
             dropTimer = currentTime;
         }
         
-        // Simplified button handling
-        static bool lastA = false, lastB = false, lastVolUp = false, lastVolDown = false;
-        static bool lastBrightUp = false, lastBrightDown = false;
-        
-        bool aPressed = cosmic->is_pressed(cosmic->SWITCH_A);
-        bool bPressed = cosmic->is_pressed(cosmic->SWITCH_B);
-        bool volUpPressed = cosmic->is_pressed(cosmic->SWITCH_VOLUME_UP);
-        bool volDownPressed = cosmic->is_pressed(cosmic->SWITCH_VOLUME_DOWN);
-        bool brightUpPressed = cosmic->is_pressed(cosmic->SWITCH_BRIGHTNESS_UP);
-        bool brightDownPressed = cosmic->is_pressed(cosmic->SWITCH_BRIGHTNESS_DOWN);
-        
-        // Move left
-        if (aPressed && !lastA) {
+        // Moves repeat while held; rotate, drops and pause act once per press
+        if (input.wasRepeated(BUTTON_A)) {
             moveLeft();
         }
         
-        // Move right  
-        if (volUpPressed && !lastVolUp) {
+        if (input.wasRepeated(BUTTON_VOLUME_UP)) {
             moveRight();
         }
         
         // Rotate
-        if (bPressed && !lastB) {
+        if (input.wasPressed(BUTTON_B)) {
             rotatePiece();
         }
         
         // Soft drop
-        if (volDownPressed && !lastVolDown) {
+        if (input.wasRepeated(BUTTON_VOLUME_DOWN)) {
             moveDown();
             // No points for soft drop - just faster movement
         }
         
         // Hard drop
-        if (brightDownPressed && !lastBrightDown) {
+        if (input.wasPressed(BUTTON_BRIGHTNESS_DOWN)) {
             hardDrop();
         }
         
         // Pause
-        if (brightUpPressed && !lastBrightUp) {
+        if (input.wasPressed(BUTTON_BRIGHTNESS_UP)) {
             paused = true;
         }
-        
-        lastA = aPressed;
-        lastB = bPressed;
-        lastVolUp = volUpPressed;
-        lastVolDown = volDownPressed;
-        lastBrightUp = brightUpPressed;
-        lastBrightDown = brightDownPressed;
     }
     
     void drawBlock(PicoGraphics_PenRGB888& graphics, int x, int y, uint8_t r, uint8_t g, uint8_t b, bool highlight = false) {
@@ -522,58 +491,6 @@ private:
         }
     }
     
-    void drawDigit(PicoGraphics_PenRGB888& graphics, int digit, int x, int y, uint8_t r, uint8_t g, uint8_t b) {
-        graphics.set_pen(r, g, b);
-        
-        // Compact 3x3 digit patterns optimized for small display
-        bool pattern[10][9] = {
-            {1,1,1,1,0,1,1,1,1}, // 0
-            {0,1,0,0,1,0,0,1,0}, // 1
-            {1,1,1,0,0,1,1,1,1}, // 2
-            {1,1,1,0,0,1,0,1,1}, // 3
-            {1,0,1,1,1,1,0,0,1}, // 4
-            {1,1,1,1,0,0,1,1,1}, // 5
-            {1,1,1,1,0,0,1,1,1}, // 6
-            {1,1,1,0,0,1,0,0,1}, // 7
-            {1,1,1,1,1,1,1,1,1}, // 8
-            {1,1,1,1,1,1,0,1,1}  // 9
-        };
-        
-        if (digit < 0 || digit > 9) return;
-        
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-                if (pattern[digit][i*3 + j]) {
-                    graphics.pixel(Point(x + j, y + i));
-                }
-            }
-        }
-    }
-    
-    void drawNumber(PicoGraphics_PenRGB888& graphics, uint32_t number, int x, int y, uint8_t r, uint8_t g, uint8_t b) {
-        if (number == 0) {
-            drawDigit(graphics, 0, x, y, r, g, b);
-            return;
-        }
-        
-        // Count digits to determine starting position
-        uint32_t temp = number;
-        int digits = 0;
-        while (temp > 0) {
-            temp /= 10;
-            digits++;
-        }
-        
-        // Draw digits from right to left with tight spacing
-        int currentX = x + (digits - 1) * 4; // 4 pixels spacing between digits
-        while (number > 0) {
-            int digit = number % 10;
-            drawDigit(graphics, digit, currentX, y, r, g, b);
-            number /= 10;
-            currentX -= 4;
-        }
-    }
-    
     void drawGameOverText(PicoGraphics_PenRGB888& graphics) {
         graphics.set_font("sans");
         
@@ -653,19 +570,10 @@ public:
     
     bool update() override {
         // Check for exit condition using GameBase method
-        bool button_d = cosmic->is_pressed(CosmicUnicorn::SWITCH_D);
-        if (checkExitCondition(button_d)) {
+        if (checkExitCondition()) {
             return false;  // Exit game
         }
         
-        // Handle brightness controls directly
-        if (cosmic->is_pressed(cosmic->SWITCH_BRIGHTNESS_UP)) {
-            cosmic->adjust_brightness(+0.01);
-        }
-        if (cosmic->is_pressed(cosmic->SWITCH_BRIGHTNESS_DOWN)) {
-            cosmic->adjust_brightness(-0.01);
-        }
-        
         // Update game logic
         gameUpdate();
         
@@ -775,15 +683,15 @@ public:
         // Score label and value
         graphics.set_pen(150, 150, 150);
         graphics.pixel(Point(17, 8)); // "S" indicator
-        drawNumber(graphics, score, 18, 8, 255, 255, 0); // Yellow score
+        HUD_DIGITS.drawNumber(graphics, score, 18, 8, packPen(255, 255, 0)); // Yellow score
         
         // Level label and value
         graphics.set_pen(150, 150, 150);
         graphics.pixel(Point(17, 12)); // "L" indicator
-        drawNumber(graphics, level, 18, 12, 0, 255, 100); // Green level
+        HUD_DIGITS.drawNumber(graphics, level, 18, 12, packPen(0, 255, 100)); // Green level
         
         // Lines value (no label needed)
-        drawNumber(graphics, lines, 18, 16, 255, 0, 200); // Magenta lines
+        HUD_DIGITS.drawNumber(graphics, lines, 18, 16, packPen(255, 0, 200)); // Magenta lines
         
         // Game over effect with flashing border and text
         if (gameOver) {
@@ -833,4 +741,10 @@ public:
     const char* getDescription() const override {
         return "Classic Tetris with falling tetromino blocks on the Cosmic Unicorn";
     }
+    
+    // Blocks move a cell at a time on millisecond timers, so a handful of
+    // frames a second shows every move; input is still read at 20 Hz
+    FrameRates getFrameRates() const override {
+        return {20, 20, 10, 5};
+    }
 };
\ No newline at end of file
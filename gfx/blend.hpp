@@ -0,0 +1,157 @@
+#pragma once
+
+#include <stdint.h>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "palette.hpp"
+#include "color.hpp"
+#include "span_fill.hpp"
+
+using namespace pimoroni;
+
+// Blending into the RGB888 framebuffer, for glows and flashes that should
+// light up what's underneath rather than paint over it. Integer only: add
+// and alpha work on two or three channels per operation, multiply per
+// channel. Spans, rectangles and whole sprites are clipped once and the mode
+// is chosen once per call, not per pixel.
+//
+//   blendPixel(gfx, x, y, glow, BlendMode::ADD);
+//   blendSpanH(gfx, 0, y, 32, haze, BlendMode::ALPHA, 96);
+//   blendRect(gfx, 0, 0, 32, 32, flash, BlendMode::ADD);
+//   blendPixels(gfx, x, y, width, height, sprite, BlendMode::ADD);  // black skipped
+
+enum class BlendMode {
+    ADD,       // Channels added, saturating at 255
+    MULTIPLY,  // Channels multiplied: white leaves the pixel, black clears it
+    ALPHA      // Mixed in at alpha / 255
+};
+
+// All three channels at once: add the low seven bits, work out each
+// channel's carry out of the top bit, then force the carried channels to 255
+constexpr uint32_t addPens(uint32_t a, uint32_t b) {
+    uint32_t low = (a & 0x7f7f7f) + (b & 0x7f7f7f);
+    uint32_t carry = ((a & b) | ((a | b) & low)) & 0x808080;
+    uint32_t sum = low ^ ((a ^ b) & 0x808080);
+    return sum | ((carry >> 7) * 0xff);
+}
+
+constexpr uint32_t multiplyPens(uint32_t a, uint32_t b) {
+    return packPen(mulByte(penRed(a), penRed(b)), mulByte(penGreen(a), penGreen(b)), mulByte(penBlue(a), penBlue(b)));
+}
+
+// 0..255 to the 0..256 weight mixPens() takes, so 255 is all of b
+constexpr uint32_t alphaWeight(uint8_t alpha) {
+    return alpha + (alpha >> 7);
+}
+
+// a + (b - a) * weight / 256, red and blue together
+constexpr uint32_t mixPens(uint32_t a, uint32_t b, uint32_t weight) {
+    uint32_t rb = ((a & 0xff00ff) * (256 - weight) + (b & 0xff00ff) * weight) >> 8;
+    uint32_t g = ((a & 0x00ff00) * (256 - weight) + (b & 0x00ff00) * weight) >> 8;
+    return (rb & 0xff00ff) | (g & 0x00ff00);
+}
+
+inline uint32_t blendPens(uint32_t under, uint32_t over, BlendMode mode, uint8_t alpha = 255) {
+    switch (mode) {
+        case BlendMode::ADD: return addPens(under, over);
+        case BlendMode::MULTIPLY: return multiplyPens(under, over);
+        default: return mixPens(under, over, alphaWeight(alpha));
+    }
+}
+
+namespace blend_detail {
+    // length pixels step apart, each replaced by op(pixel)
+    template <typename Op>
+    inline void blendRun(uint32_t* p, int length, int step, Op op) {
+        for (int i = 0; i < length; i++, p += step) *p = op(*p);
+    }
+
+    inline void blendRun(uint32_t* p, int length, int step, uint32_t color, BlendMode mode, uint8_t alpha) {
+        switch (mode) {
+            case BlendMode::ADD:
+                blendRun(p, length, step, [color](uint32_t under) { return addPens(under, color); });
+                break;
+            case BlendMode::MULTIPLY:
+                blendRun(p, length, step, [color](uint32_t under) { return multiplyPens(under, color); });
+                break;
+            case BlendMode::ALPHA: {
+                uint32_t weight = alphaWeight(alpha);
+                blendRun(p, length, step, [color, weight](uint32_t under) { return mixPens(under, color, weight); });
+                break;
+            }
+        }
+    }
+}
+
+inline void blendPixel(PicoGraphics_PenRGB888& gfx, int x, int y, uint32_t color, BlendMode mode, uint8_t alpha = 255) {
+    if (x < gfx.clip.x || x >= gfx.clip.x + gfx.clip.w || y < gfx.clip.y || y >= gfx.clip.y + gfx.clip.h) return;
+
+    uint32_t* p = spanPointer(gfx, x, y);
+    *p = blendPens(*p, color, mode, alpha);
+}
+
+// length pixels from (x, y) rightwards
+inline void blendSpanH(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t color, BlendMode mode, uint8_t alpha = 255) {
+    if (y < gfx.clip.y || y >= gfx.clip.y + gfx.clip.h) return;
+    if (clipSpan(x, length, gfx.clip.x, gfx.clip.x + gfx.clip.w) < 0) return;
+
+    blend_detail::blendRun(spanPointer(gfx, x, y), length, 1, color, mode, alpha);
+}
+
+// length pixels from (x, y) downwards
+inline void blendSpanV(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t color, BlendMode mode, uint8_t alpha = 255) {
+    if (x < gfx.clip.x || x >= gfx.clip.x + gfx.clip.w) return;
+    if (clipSpan(y, length, gfx.clip.y, gfx.clip.y + gfx.clip.h) < 0) return;
+
+    blend_detail::blendRun(spanPointer(gfx, x, y), length, gfx.bounds.w, color, mode, alpha);
+}
+
+inline void blendRect(PicoGraphics_PenRGB888& gfx, int x, int y, int width, int height, uint32_t color, BlendMode mode,
+                      uint8_t alpha = 255) {
+    if (clipSpan(x, width, gfx.clip.x, gfx.clip.x + gfx.clip.w) < 0) return;
+    if (clipSpan(y, height, gfx.clip.y, gfx.clip.y + gfx.clip.h) < 0) return;
+
+    // Whole rows are one run
+    if (width == gfx.bounds.w) {
+        blend_detail::blendRun(spanPointer(gfx, x, y), width * height, 1, color, mode, alpha);
+        return;
+    }
+    for (int row = 0; row < height; row++) {
+        blend_detail::blendRun(spanPointer(gfx, x, y + row), width, 1, color, mode, alpha);
+    }
+}
+
+// A width x height block of pens, row by row, blended in with its top-left
+// at (x, y). Black pixels are left alone, so a sprite's background doesn't
+// darken an ALPHA blend.
+inline void blendPixels(PicoGraphics_PenRGB888& gfx, int x, int y, int width, int height, const uint32_t* pixels,
+                        BlendMode mode, uint8_t alpha = 255) {
+    int stride = width;
+    int skip_x = clipSpan(x, width, gfx.clip.x, gfx.clip.x + gfx.clip.w);
+    int skip_y = clipSpan(y, height, gfx.clip.y, gfx.clip.y + gfx.clip.h);
+    if (skip_x < 0 || skip_y < 0) return;
+    const uint32_t* source = pixels + skip_y * stride + skip_x;
+
+    // width has been clipped; the source rows keep their full length
+    for (int row = 0; row < height; row++, source += stride) {
+        uint32_t* p = spanPointer(gfx, x, y + row);
+        switch (mode) {
+            case BlendMode::ADD:
+                for (int i = 0; i < width; i++) {
+                    if (source[i] & 0xffffff) p[i] = addPens(p[i], source[i]);
+                }
+                break;
+            case BlendMode::MULTIPLY:
+                for (int i = 0; i < width; i++) {
+                    if (source[i] & 0xffffff) p[i] = multiplyPens(p[i], source[i]);
+                }
+                break;
+            case BlendMode::ALPHA: {
+                uint32_t weight = alphaWeight(alpha);
+                for (int i = 0; i < width; i++) {
+                    if (source[i] & 0xffffff) p[i] = mixPens(p[i], source[i], weight);
+                }
+                break;
+            }
+        }
+    }
+}
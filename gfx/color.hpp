@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include "palette.hpp"
+#include "../math/fast_math.hpp"
+
+// HSV to packed pen in integer arithmetic, shared by every game and effect.
+//
+// Hue runs 0..HUE_STEPS - 1 (1536: 256 steps per sixth of the wheel, so each
+// sector is a byte and the interpolation is a multiply) and wraps, so an
+// animated hue can just keep counting. Saturation and value are 0..255.
+// hueFromUnit(), hueFromDegrees() and unitToByte() take the float forms the
+// effects compute in.
+//
+//   gfx.set_pen(hsvPen(hueFromDegrees(angle), 255, 200));
+//   gfx.set_pen(hueWheelPen(hue8, brightness));   // full saturation, table
+
+constexpr int HUE_STEPS = 6 * 256;
+
+// round(a * b / 255) for bytes, without a division
+constexpr uint8_t mulByte(uint8_t a, uint8_t b) {
+    return (uint8_t)(((uint32_t)a * b + 128 + (((uint32_t)a * b + 128) >> 8)) >> 8);
+}
+
+constexpr uint32_t hsvPen(int hue, uint8_t sat, uint8_t val) {
+    hue %= HUE_STEPS;
+    if (hue < 0) hue += HUE_STEPS;
+    int sector = hue >> 8;
+    uint8_t f = (uint8_t)(hue & 0xff);
+
+    // The channel between the lowest (p) and val: falling through odd
+    // sectors, rising through even ones
+    uint8_t p = mulByte(val, 255 - sat);
+    uint8_t m = mulByte(val, 255 - mulByte(sat, (sector & 1) ? f : 255 - f));
+
+    switch (sector) {
+        case 0: return packPen(val, m, p);
+        case 1: return packPen(m, val, p);
+        case 2: return packPen(p, val, m);
+        case 3: return packPen(p, m, val);
+        case 4: return packPen(m, p, val);
+        default: return packPen(val, p, m);
+    }
+}
+
+// For code that keeps channels rather than pens
+inline void hsvToRgb(int hue, uint8_t sat, uint8_t val, uint8_t& r, uint8_t& g, uint8_t& b) {
+    uint32_t pen = hsvPen(hue, sat, val);
+    r = penRed(pen);
+    g = penGreen(pen);
+    b = penBlue(pen);
+}
+
+// 0..1 (one turn) to hue steps. Any float, wraps.
+inline int hueFromUnit(float turns) {
+    return (int)(turns * HUE_STEPS) % HUE_STEPS;
+}
+
+inline int hueFromDegrees(float degrees) {
+    return (int)(degrees * (HUE_STEPS / 360.0f)) % HUE_STEPS;
+}
+
+inline int hueFromRadians(float radians) {
+    return (int)(radians * (float)(HUE_STEPS / (2 * fast_math_detail::PI))) % HUE_STEPS;
+}
+
+// 0..1 to 0..255, clamped, truncating as (uint8_t)(x * 255) did
+inline uint8_t unitToByte(float x) {
+    return x <= 0 ? 0 : (x >= 1 ? 255 : (uint8_t)(x * 255));
+}
+
+// The fully saturated wheel at 256 hues (hue8 = hue / 6), for effects that
+// only ever vary hue and brightness
+struct HueWheel {
+    uint32_t pens[256] = {};
+    constexpr HueWheel() {
+        for (int i = 0; i < 256; i++) pens[i] = hsvPen(i * 6, 255, 255);
+    }
+};
+
+inline constexpr HueWheel HUE_WHEEL{};
+
+// Each channel times level / 255
+constexpr uint32_t dimPen(uint32_t pen, uint8_t level) {
+    return packPen(mulByte(penRed(pen), level), mulByte(penGreen(pen), level), mulByte(penBlue(pen), level));
+}
+
+inline uint32_t hueWheelPen(uint8_t hue8, uint8_t val = 255) {
+    return val == 255 ? HUE_WHEEL.pens[hue8] : dimPen(HUE_WHEEL.pens[hue8], val);
+}
+
+// The panel driver gamma-corrects each channel (about 2.2), so halving a
+// channel gives much less than half the light. DISPLAY_LEVEL[light] is the
+// channel level that gives light / 255 of the full output - use it when a
+// brightness is physically additive, like overlapping glows.
+struct GammaTable {
+    uint8_t levels[256] = {};
+    constexpr GammaTable(double gamma) {
+        for (int i = 0; i < 256; i++) {
+            double light = i / 255.0;
+            // light^(1/gamma) = e^(ln(light) / gamma)
+            double level = i == 0 ? 0 : fast_math_detail::seriesExp(fast_math_detail::seriesLog(light) / gamma);
+            levels[i] = (uint8_t)(level * 255 + 0.5);
+        }
+    }
+};
+
+inline constexpr GammaTable DISPLAY_LEVEL{2.2};
+
+// pen at light / 255 of its output, as the eye sees it on the panel
+constexpr uint32_t dimPenLinear(uint32_t pen, uint8_t light) {
+    return dimPen(pen, DISPLAY_LEVEL.levels[light]);
+}
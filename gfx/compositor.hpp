@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <vector>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "palette.hpp"
+#include "blend.hpp"
+#include "../frame_profiler.hpp"
+
+using namespace pimoroni;
+
+// Cached layers for backgrounds that don't change every frame. A Layer owns
+// a frame-sized RGB888 buffer and a draw function. Only when the layer is due
+// does the draw function run, onto a black buffer with the graphics pointed
+// at it (so existing drawing code works unchanged); every frame the buffer
+// is composited into the real framebuffer.
+//
+//   Layer sky{"sky", LayerRefresh::STATIC};
+//   sky.setDraw([this](PicoGraphics_PenRGB888& g) { drawSky(g); });
+//   ...
+//   if (theme_changed) sky.invalidate();
+//   sky.render(gfx);              // redraws only after invalidate()
+//   drawRoad();                   // then draw the moving parts on top
+//
+// Compositor draws several layers in order. Layer redraws are profiled
+// under the layer's name.
+
+enum class LayerRefresh {
+    STATIC,       // Only after invalidate()
+    EVERY_N,      // Every period-th render, or after invalidate()
+    EVERY_FRAME   // Always; the buffer is only there for blending
+};
+
+enum class LayerBlend {
+    COPY,    // Replaces the framebuffer, black included
+    KEYED,   // Black pixels are transparent, others replace
+    ADD,     // Channels added, saturating
+    ALPHA    // Non-black pixels mixed in at the layer's opacity
+};
+
+class Layer {
+public:
+    using DrawFunction = std::function<void(PicoGraphics_PenRGB888&)>;
+
+    explicit Layer(const char* layer_name, LayerRefresh layer_refresh = LayerRefresh::STATIC, int refresh_period = 1,
+                   LayerBlend layer_blend = LayerBlend::COPY, uint8_t layer_opacity = 255)
+        : name(layer_name), refresh(layer_refresh), period(refresh_period < 1 ? 1 : refresh_period),
+          blend(layer_blend), opacity(layer_opacity) {}
+
+    void setDraw(DrawFunction function) {
+        draw = std::move(function);
+        invalidate();
+    }
+
+    void setOpacity(uint8_t layer_opacity) { opacity = layer_opacity; }
+
+    // The next render() redraws
+    void invalidate() { valid = false; }
+
+    const char* getName() const { return name; }
+    bool wasRedrawn() const { return redrawn; }
+
+    // Redraw if due, then composite into gfx
+    void render(PicoGraphics_PenRGB888& gfx) {
+        redrawn = false;
+        if (!draw) return;
+
+        int size = gfx.bounds.w * gfx.bounds.h;
+        if ((int)pixels.size() != size) {
+            pixels.assign(size, 0);
+            valid = false;
+        }
+
+        frames_since_draw++;
+        if (!valid || refresh == LayerRefresh::EVERY_FRAME ||
+            (refresh == LayerRefresh::EVERY_N && frames_since_draw >= period)) {
+            PROFILE_SCOPE(name);
+            void* target = gfx.frame_buffer;
+            gfx.set_framebuffer(pixels.data());
+            memset(pixels.data(), 0, size * sizeof(uint32_t));
+            draw(gfx);
+            gfx.set_framebuffer(target);
+            valid = true;
+            redrawn = true;
+            frames_since_draw = 0;
+        }
+
+        composite((uint32_t*)gfx.frame_buffer, size);
+    }
+
+private:
+    const char* name;
+    LayerRefresh refresh;
+    int period;
+    LayerBlend blend;
+    uint8_t opacity;
+
+    DrawFunction draw;
+    std::vector<uint32_t> pixels;
+    bool valid = false;
+    bool redrawn = false;
+    int frames_since_draw = 0;
+
+    void composite(uint32_t* target, int size) const {
+        const uint32_t* source = pixels.data();
+        switch (blend) {
+            case LayerBlend::COPY:
+                memcpy(target, source, size * sizeof(uint32_t));
+                break;
+            case LayerBlend::KEYED:
+                for (int i = 0; i < size; i++) {
+                    if (source[i] & 0xffffff) target[i] = source[i];
+                }
+                break;
+            case LayerBlend::ADD:
+                for (int i = 0; i < size; i++) {
+                    if (source[i] & 0xffffff) target[i] = addPens(target[i], source[i]);
+                }
+                break;
+            case LayerBlend::ALPHA: {
+                uint32_t weight = alphaWeight(opacity);
+                for (int i = 0; i < size; i++) {
+                    if (source[i] & 0xffffff) target[i] = mixPens(target[i], source[i], weight);
+                }
+                break;
+            }
+        }
+    }
+};
+
+// Layers rendered bottom to top
+class Compositor {
+public:
+    void add(Layer& layer) { layers.push_back(&layer); }
+
+    void invalidateAll() {
+        for (Layer* layer : layers) layer->invalidate();
+    }
+
+    void render(PicoGraphics_PenRGB888& gfx) {
+        for (Layer* layer : layers) layer->render(gfx);
+    }
+
+private:
+    std::vector<Layer*> layers;
+};
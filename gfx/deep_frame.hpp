@@ -0,0 +1,164 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "palette.hpp"
+
+using namespace pimoroni;
+
+// A working framebuffer with 16 bits per channel, for dark gradients that
+// band when every row is truncated to 8 bits (a sky fading from 15 to 5
+// over 32 rows is ten flat stripes). Channels are 8.8 fixed point, so 256
+// is one 8-bit level. Draw the smooth parts here, dither them into the
+// RGB888 framebuffer with present(), then draw the sharp parts on top as
+// usual:
+//
+//   DeepFrame sky{32, 32};
+//   sky.fillGradientV(0, 32, deepColor(15, 15, 35), deepColor(5, 5, 20));
+//   sky.present(gfx, 0, 0);
+//   drawClouds(gfx);
+//
+// ORDERED adds a 4x4 Bayer threshold before dropping the low byte, so the
+// panel shows the in-between levels as a fixed fine pattern; it's stable,
+// so it suits cached layers. TEMPORAL also shifts the pattern every
+// present(), averaging out over 16 frames - smoother at high frame rates,
+// a faint shimmer at 20 fps.
+
+// Up to 255.0 (65280) per channel
+struct DeepColor {
+    uint16_t r, g, b;
+};
+
+// 0..255 per channel, fractions kept
+constexpr DeepColor deepColor(float r, float g, float b) {
+    return {(uint16_t)(r <= 0 ? 0 : (r >= 255 ? 65280 : r * 256)),
+            (uint16_t)(g <= 0 ? 0 : (g >= 255 ? 65280 : g * 256)),
+            (uint16_t)(b <= 0 ? 0 : (b >= 255 ? 65280 : b * 256))};
+}
+
+constexpr DeepColor deepFromPen(uint32_t pen) {
+    return {(uint16_t)(penRed(pen) << 8), (uint16_t)(penGreen(pen) << 8), (uint16_t)(penBlue(pen) << 8)};
+}
+
+enum class Dither {
+    ORDERED,
+    TEMPORAL
+};
+
+class DeepFrame {
+public:
+    DeepFrame(int frame_width, int frame_height)
+        : width(frame_width), height(frame_height), pixels(frame_width * frame_height, DeepColor{0, 0, 0}) {}
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    void clear(DeepColor color = {0, 0, 0}) {
+        for (DeepColor& p : pixels) p = color;
+    }
+
+    void setPixel(int x, int y, DeepColor color) {
+        if (x < 0 || x >= width || y < 0 || y >= height) return;
+        pixels[y * width + x] = color;
+    }
+
+    DeepColor getPixel(int x, int y) const {
+        return pixels[y * width + x];
+    }
+
+    // rows full-width rows from y, row i at top + (bottom - top) * i / rows
+    // (so bottom itself is where the next row would be), interpolated in
+    // 8.16 per channel
+    void fillGradientV(int y, int rows, DeepColor top, DeepColor bottom) {
+        if (rows <= 0) return;
+        int32_t r = top.r << 8, g = top.g << 8, b = top.b << 8;
+        int32_t dr = (((int32_t)bottom.r - top.r) << 8) / rows;
+        int32_t dg = (((int32_t)bottom.g - top.g) << 8) / rows;
+        int32_t db = (((int32_t)bottom.b - top.b) << 8) / rows;
+        for (int i = 0; i < rows; i++, r += dr, g += dg, b += db) {
+            int row = y + i;
+            if (row < 0 || row >= height) continue;
+            DeepColor color = {(uint16_t)(r >> 8), (uint16_t)(g >> 8), (uint16_t)(b >> 8)};
+            DeepColor* p = &pixels[row * width];
+            for (int x = 0; x < width; x++) p[x] = color;
+        }
+    }
+
+    // Dither the whole frame into gfx with its top-left at (x, y)
+    void present(PicoGraphics_PenRGB888& gfx, int x, int y, Dither mode = Dither::ORDERED) {
+        int shift_x = 0, shift_y = 0;
+        if (mode == Dither::TEMPORAL) {
+            // Each pixel steps through all 16 thresholds every 16 frames
+            shift_x = present_count & 3;
+            shift_y = (present_count >> 2) & 3;
+        }
+        present_count++;
+
+        int x0 = x < gfx.clip.x ? gfx.clip.x - x : 0;
+        int y0 = y < gfx.clip.y ? gfx.clip.y - y : 0;
+        int x1 = width, y1 = height;
+        if (x + x1 > gfx.clip.x + gfx.clip.w) x1 = gfx.clip.x + gfx.clip.w - x;
+        if (y + y1 > gfx.clip.y + gfx.clip.h) y1 = gfx.clip.y + gfx.clip.h - y;
+
+        for (int row = y0; row < y1; row++) {
+            // This row's thresholds, rotated so column col uses t[col & 3]
+            const uint8_t* bayer_row = BAYER[(row + y + shift_y) & 3];
+            uint32_t t[4];
+            for (int i = 0; i < 4; i++) t[i] = bayer_row[(i + x + shift_x) & 3];
+
+            const DeepColor* source = pixels.data() + row * width;
+            uint32_t* out = (uint32_t*)gfx.frame_buffer + (y + row) * gfx.bounds.w + x;
+            for (int col = x0; col < x1; col++) out[col] = ditherPen(source[col], t[col & 3]);
+        }
+    }
+
+private:
+    // 4x4 Bayer matrix scaled to the low byte: (0..15) * 16 + 8
+    static constexpr uint8_t BAYER[4][4] = {
+        {  8, 136,  40, 168},
+        {200,  72, 232, 104},
+        { 56, 184,  24, 152},
+        {248, 120, 216,  88}
+    };
+
+    int width, height;
+    std::vector<DeepColor> pixels;
+    uint32_t present_count = 0;
+
+    // High byte of each channel after adding the threshold. Channels stop at
+    // 255.0 (65280), so the sum never reaches 256.
+    static uint32_t ditherPen(DeepColor color, uint32_t threshold) {
+        return (((color.r + threshold) & 0xff00) << 8) | ((color.g + threshold) & 0xff00) |
+               ((color.b + threshold) >> 8);
+    }
+};
+
+// A full-width vertical gradient from the top of the frame that only
+// changes now and then, like a theme's sky. Each of its rows is one colour,
+// so the ORDERED dither repeats every four columns: set() dithers a 4-pixel
+// strip per row once, and draw() tiles it across the framebuffer.
+class CachedGradientV {
+public:
+    explicit CachedGradientV(int gradient_rows) : rows(gradient_rows), strip(4 * gradient_rows, 0) {}
+
+    void set(DeepColor top, DeepColor bottom) {
+        DeepFrame deep(4, rows);
+        deep.fillGradientV(0, rows, top, bottom);
+        PicoGraphics_PenRGB888 target(4, rows, strip.data());
+        deep.present(target, 0, 0);
+    }
+
+    void draw(PicoGraphics_PenRGB888& gfx) const {
+        int y1 = rows < gfx.clip.y + gfx.clip.h ? rows : gfx.clip.y + gfx.clip.h;
+        for (int row = gfx.clip.y; row < y1; row++) {
+            const uint32_t* source = strip.data() + row * 4;
+            uint32_t* out = (uint32_t*)gfx.frame_buffer + row * gfx.bounds.w;
+            for (int col = gfx.clip.x; col < gfx.clip.x + gfx.clip.w; col++) out[col] = source[col & 3];
+        }
+    }
+
+private:
+    int rows;
+    std::vector<uint32_t> strip;
+};
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "libraries/bitmap_fonts/bitmap_fonts.hpp"
+#include "span_fill.hpp"
+
+using namespace pimoroni;
+
+// Text from glyph bitmasks: one byte per glyph row, drawn as a masked blit
+// with the colour passed in, no set_pen() and no font lookups per pixel.
+// Widths come from a table, so measuring a string is a sum.
+//
+//   HUD_DIGITS.drawNumber(gfx, score, 18, 8, packPen(255, 255, 0));
+//   HUD_FONT.drawCentered(gfx, "TIME UP!", 10, red);
+//
+// Fonts are either data (the compact HUD fonts below, built at compile time)
+// or captured from a pimoroni bitmap font, which keeps its look: prepare()
+// rasterises the characters a string needs the first time it sees them.
+//
+//   GlyphFont menu_font{&font6};
+//   menu_font.prepare(gfx, name);
+//   int width = menu_font.measure(name);
+//
+// Glyphs are up to 8 x 8. Lower case falls back to upper case when a font
+// only has capitals; other missing characters are skipped.
+
+class GlyphFont {
+public:
+    static constexpr int FIRST_CHAR = 32;
+    static constexpr int CHAR_COUNT = 96;
+    static constexpr int MAX_WIDTH = 8;
+    static constexpr int MAX_HEIGHT = 8;
+
+    // For fonts written as data: rows top to bottom, each read left to right
+    // from bit width - 1, so 0b101 is a pixel, a gap and a pixel
+    struct GlyphDef {
+        char c;
+        uint8_t width;
+        uint8_t rows[MAX_HEIGHT];
+    };
+
+    template <size_t N>
+    constexpr GlyphFont(int font_height, int letter_spacing, const GlyphDef (&defs)[N])
+        : height((uint8_t)font_height), spacing((uint8_t)letter_spacing) {
+        for (const GlyphDef& def : defs) {
+            Glyph& glyph = glyphs[def.c - FIRST_CHAR];
+            glyph.present = true;
+            glyph.width = def.width;
+            // Stored with column x at bit x
+            for (int row = 0; row < MAX_HEIGHT; row++) {
+                uint8_t mask = 0;
+                for (int x = 0; x < def.width; x++) {
+                    if (def.rows[row] & (1 << (def.width - 1 - x))) mask |= (uint8_t)(1 << x);
+                }
+                glyph.rows[row] = mask;
+            }
+        }
+    }
+
+    // Captured from a bitmap font as prepare() asks for characters
+    explicit GlyphFont(const bitmap::font_t* font) : source(font) {}
+
+    int getHeight() const { return height; }
+
+    // Rasterise any characters of text the font doesn't have yet. Only for
+    // captured fonts; the gfx font is left set to the source font.
+    void prepare(PicoGraphics_PenRGB888& gfx, const char* text) {
+        if (!source) return;
+        for (const char* c = text; *c; c++) {
+            if (*c >= FIRST_CHAR && *c < FIRST_CHAR + CHAR_COUNT && !glyphs[*c - FIRST_CHAR].present) {
+                capture(gfx, *c);
+            }
+        }
+    }
+
+    // Pixels from the first glyph's left edge to the last glyph's right
+    int measure(const char* text) const {
+        int width = 0, count = 0;
+        for (const char* c = text; *c; c++) {
+            const Glyph* glyph = find(*c);
+            if (!glyph) continue;
+            width += glyph->width;
+            count++;
+        }
+        return count > 0 ? width + (count - 1) * spacing : 0;
+    }
+
+    int measure(const std::string& text) const { return measure(text.c_str()); }
+
+    // Draws text with its top-left at (x, y); returns where the next
+    // character would go
+    int draw(PicoGraphics_PenRGB888& gfx, const char* text, int x, int y, uint32_t color) const {
+        for (const char* c = text; *c; c++) {
+            const Glyph* glyph = find(*c);
+            if (!glyph) continue;
+            drawGlyph(gfx, *glyph, x, y, color);
+            x += glyph->width + spacing;
+        }
+        return x;
+    }
+
+    int draw(PicoGraphics_PenRGB888& gfx, const std::string& text, int x, int y, uint32_t color) const {
+        return draw(gfx, text.c_str(), x, y, color);
+    }
+
+    // Centred across the frame
+    void drawCentered(PicoGraphics_PenRGB888& gfx, const char* text, int y, uint32_t color) const {
+        draw(gfx, text, (gfx.bounds.w - measure(text)) / 2, y, color);
+    }
+
+    // Decimal, left-aligned at x
+    int drawNumber(PicoGraphics_PenRGB888& gfx, uint32_t value, int x, int y, uint32_t color) const {
+        char digits[11];
+        int n = sizeof(digits) - 1;
+        digits[n] = '\0';
+        do {
+            digits[--n] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        return draw(gfx, digits + n, x, y, color);
+    }
+
+private:
+    struct Glyph {
+        bool present = false;
+        uint8_t width = 0;
+        uint8_t rows[MAX_HEIGHT] = {};   // Column x at bit x
+    };
+
+    // Never a pen: pens have a zero top byte
+    static constexpr uint32_t UNDRAWN = 0xff000000;
+
+    Glyph glyphs[CHAR_COUNT] = {};
+    const bitmap::font_t* source = nullptr;
+    uint8_t height = 0;
+    uint8_t spacing = 0;
+
+    const Glyph* find(char c) const {
+        if (c < FIRST_CHAR || c >= FIRST_CHAR + CHAR_COUNT) return nullptr;
+        const Glyph* glyph = &glyphs[c - FIRST_CHAR];
+        if (!glyph->present && c >= 'a' && c <= 'z') glyph = &glyphs[c - 'a' + 'A' - FIRST_CHAR];
+        return glyph->present ? glyph : nullptr;
+    }
+
+    void drawGlyph(PicoGraphics_PenRGB888& gfx, const Glyph& glyph, int x, int y, uint32_t color) const {
+        // Clip the glyph's box once, then walk the rows' set bits
+        int left = x, width = glyph.width;
+        int top = y, rows = height;
+        int skip_x = clipSpan(left, width, gfx.clip.x, gfx.clip.x + gfx.clip.w);
+        int skip_y = clipSpan(top, rows, gfx.clip.y, gfx.clip.y + gfx.clip.h);
+        if (skip_x < 0 || skip_y < 0) return;
+        uint32_t visible = (1u << width) - 1;
+
+        for (int row = 0; row < rows; row++) {
+            // Bit col is now pixel left + col
+            uint32_t mask = (glyph.rows[skip_y + row] >> skip_x) & visible;
+            if (!mask) continue;
+
+            uint32_t* out = spanPointer(gfx, left, top + row);
+            for (int col = 0; mask; col++, mask >>= 1) {
+                if (mask & 1) out[col] = color;
+            }
+        }
+    }
+
+    // Draws c in the source font onto a blank frame and keeps what it drew.
+    // The width is what measure_text() gives, and the spacing is whatever
+    // measuring two characters adds on top of two widths, so strings lay out
+    // as gfx.text() would place them.
+    void capture(PicoGraphics_PenRGB888& gfx, char c) {
+        gfx.set_font(source);
+        if (height == 0) {
+            int one = gfx.measure_text("0", 1.0f);
+            int two = gfx.measure_text("00", 1.0f);
+            spacing = (uint8_t)(two > 2 * one ? two - 2 * one : 0);
+        }
+
+        char text[2] = {c, '\0'};
+        int frame_w = gfx.bounds.w, frame_h = gfx.bounds.h;
+        std::vector<uint32_t> scratch(frame_w * frame_h, UNDRAWN);
+        void* target = gfx.frame_buffer;
+        gfx.set_framebuffer(scratch.data());
+        gfx.text(text, Point(0, 0), -1, 1.0f);
+        gfx.set_framebuffer(target);
+
+        Glyph& glyph = glyphs[c - FIRST_CHAR];
+        glyph.present = true;
+        int width = gfx.measure_text(text, 1.0f);
+        glyph.width = (uint8_t)(width < 0 ? 0 : (width > MAX_WIDTH ? MAX_WIDTH : width));
+        for (int row = 0; row < MAX_HEIGHT && row < frame_h; row++) {
+            uint8_t mask = 0;
+            for (int x = 0; x < MAX_WIDTH && x < frame_w; x++) {
+                if (scratch[row * frame_w + x] != UNDRAWN) mask |= (uint8_t)(1 << x);
+            }
+            glyph.rows[row] = mask;
+            if (mask && row + 1 > height) height = (uint8_t)(row + 1);
+        }
+    }
+};
+
+// Compact 3x3 digits for tight HUDs such as the Tetris side panel, one pixel
+// apart. (5 and 6 share a shape at this size.)
+inline constexpr GlyphFont::GlyphDef HUD_DIGIT_GLYPHS[] = {
+    {'0', 3, {0b111, 0b101, 0b111}},
+    {'1', 3, {0b010, 0b010, 0b010}},
+    {'2', 3, {0b111, 0b001, 0b111}},
+    {'3', 3, {0b111, 0b001, 0b011}},
+    {'4', 3, {0b101, 0b111, 0b001}},
+    {'5', 3, {0b111, 0b100, 0b111}},
+    {'6', 3, {0b111, 0b100, 0b111}},
+    {'7', 3, {0b111, 0b001, 0b001}},
+    {'8', 3, {0b111, 0b111, 0b111}},
+    {'9', 3, {0b111, 0b111, 0b011}},
+};
+
+inline constexpr GlyphFont HUD_DIGITS{3, 1, HUD_DIGIT_GLYPHS};
+
+// 3x5 capitals, digits and a little punctuation for in-game messages. The
+// space has no width, so words are two pixels apart. Even so "GAME OVER" is
+// the whole 32 pixels, with no margin, so games stack it on two lines.
+inline constexpr GlyphFont::GlyphDef HUD_FONT_GLYPHS[] = {
+    {' ', 0, {}},
+    {'!', 1, {0b1, 0b1, 0b1, 0b0, 0b1}},
+    {'-', 3, {0b000, 0b000, 0b111, 0b000, 0b000}},
+    {'.', 1, {0b0, 0b0, 0b0, 0b0, 0b1}},
+    {':', 1, {0b0, 0b1, 0b0, 0b1, 0b0}},
+    {'0', 3, {0b111, 0b101, 0b101, 0b101, 0b111}},
+    {'1', 3, {0b010, 0b110, 0b010, 0b010, 0b111}},
+    {'2', 3, {0b111, 0b001, 0b111, 0b100, 0b111}},
+    {'3', 3, {0b111, 0b001, 0b011, 0b001, 0b111}},
+    {'4', 3, {0b101, 0b101, 0b111, 0b001, 0b001}},
+    {'5', 3, {0b111, 0b100, 0b111, 0b001, 0b111}},
+    {'6', 3, {0b111, 0b100, 0b111, 0b101, 0b111}},
+    {'7', 3, {0b111, 0b001, 0b001, 0b010, 0b010}},
+    {'8', 3, {0b111, 0b101, 0b111, 0b101, 0b111}},
+    {'9', 3, {0b111, 0b101, 0b111, 0b001, 0b111}},
+    {'A', 3, {0b010, 0b101, 0b111, 0b101, 0b101}},
+    {'B', 3, {0b110, 0b101, 0b110, 0b101, 0b110}},
+    {'C', 3, {0b011, 0b100, 0b100, 0b100, 0b011}},
+    {'D', 3, {0b110, 0b101, 0b101, 0b101, 0b110}},
+    {'E', 3, {0b111, 0b100, 0b110, 0b100, 0b111}},
+    {'F', 3, {0b111, 0b100, 0b110, 0b100, 0b100}},
+    {'G', 3, {0b011, 0b100, 0b101, 0b101, 0b011}},
+    {'H', 3, {0b101, 0b101, 0b111, 0b101, 0b101}},
+    {'I', 3, {0b111, 0b010, 0b010, 0b010, 0b111}},
+    {'J', 3, {0b001, 0b001, 0b001, 0b101, 0b010}},
+    {'K', 3, {0b101, 0b101, 0b110, 0b101, 0b101}},
+    {'L', 3, {0b100, 0b100, 0b100, 0b100, 0b111}},
+    {'M', 3, {0b101, 0b111, 0b111, 0b101, 0b101}},
+    {'N', 3, {0b110, 0b101, 0b101, 0b101, 0b101}},
+    {'O', 3, {0b010, 0b101, 0b101, 0b101, 0b010}},
+    {'P', 3, {0b110, 0b101, 0b110, 0b100, 0b100}},
+    {'Q', 3, {0b010, 0b101, 0b101, 0b110, 0b011}},
+    {'R', 3, {0b110, 0b101, 0b110, 0b101, 0b101}},
+    {'S', 3, {0b011, 0b100, 0b010, 0b001, 0b110}},
+    {'T', 3, {0b111, 0b010, 0b010, 0b010, 0b010}},
+    {'U', 3, {0b101, 0b101, 0b101, 0b101, 0b111}},
+    {'V', 3, {0b101, 0b101, 0b101, 0b101, 0b010}},
+    {'W', 3, {0b101, 0b101, 0b111, 0b111, 0b101}},
+    {'X', 3, {0b101, 0b101, 0b010, 0b101, 0b101}},
+    {'Y', 3, {0b101, 0b101, 0b010, 0b010, 0b010}},
+    {'Z', 3, {0b111, 0b001, 0b010, 0b100, 0b111}},
+};
+
+inline constexpr GlyphFont HUD_FONT{5, 1, HUD_FONT_GLYPHS};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+
+// Pens for the RGB888 framebuffer without calling create_pen() per pixel.
+// A pen there is just 0xRRGGBB, so fixed colours can be packed at compile
+// time and theme-dependent ones once when the theme changes; hot loops then
+// pick pens from a table by index.
+//
+//   static constexpr uint32_t PEN_WALL = packPen(30, 60, 120);
+//   static constexpr PenRamp<8> GLOW_RAMP{255, 80, 0};  // black .. orange
+//   gfx.set_pen(GLOW_RAMP.at(heat));
+
+constexpr uint32_t packPen(uint8_t r, uint8_t g, uint8_t b) {
+    return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+}
+
+constexpr uint8_t penRed(uint32_t pen) { return (uint8_t)(pen >> 16); }
+constexpr uint8_t penGreen(uint32_t pen) { return (uint8_t)(pen >> 8); }
+constexpr uint8_t penBlue(uint32_t pen) { return (uint8_t)pen; }
+
+// The colour with each channel multiplied by factor and truncated, as the
+// per-pixel code did with (uint8_t)(r * factor)
+constexpr uint32_t scalePen(uint8_t r, uint8_t g, uint8_t b, float factor) {
+    return packPen((uint8_t)(r * factor), (uint8_t)(g * factor), (uint8_t)(b * factor));
+}
+
+// STEPS shades of one colour, brightness going linearly from `from` (first
+// entry) to `to` (last entry). constexpr for fixed colours; build() refills
+// it at run time, e.g. from a theme.
+template <int STEPS>
+struct PenRamp {
+    static_assert(STEPS >= 2, "A ramp needs at least two steps");
+
+    uint32_t pens[STEPS] = {};
+
+    constexpr PenRamp() = default;
+
+    constexpr PenRamp(uint8_t r, uint8_t g, uint8_t b, float from = 0.0f, float to = 1.0f) {
+        build(r, g, b, from, to);
+    }
+
+    constexpr void build(uint8_t r, uint8_t g, uint8_t b, float from = 0.0f, float to = 1.0f) {
+        for (int i = 0; i < STEPS; i++) {
+            pens[i] = scalePen(r, g, b, from + (to - from) * i / (STEPS - 1));
+        }
+    }
+
+    constexpr uint32_t operator[](int index) const { return pens[index]; }
+
+    // Nearest step for level 0 (from) .. 1 (to), clamped
+    constexpr int indexFor(float level) const {
+        int index = (int)(level * (STEPS - 1) + 0.5f);
+        return index < 0 ? 0 : (index >= STEPS ? STEPS - 1 : index);
+    }
+
+    constexpr uint32_t at(float level) const { return pens[indexFor(level)]; }
+};
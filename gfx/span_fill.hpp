@@ -0,0 +1,117 @@
+#pragma once
+
+#include <stdint.h>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "palette.hpp"
+
+using namespace pimoroni;
+
+// Row and column fills that write RGB888 straight into the framebuffer. A span
+// is clipped once against the graphics clip rect, then filled with a plain
+// store per pixel - no set_pen() and no per-pixel bounds check as with
+// pixel(). Colours are packed pens (packPen() in palette.hpp), the value
+// create_pen() returns for the RGB888 framebuffer, and the current pen is
+// left alone.
+//
+// The launcher only ever draws into a PicoGraphics_PenRGB888, so this and
+// the other gfx/ helpers take one and write its framebuffer directly.
+
+// Clip [start, start + length) to [low, high); returns how many pixels were
+// cut off the front, or -1 if nothing is left
+inline int clipSpan(int& start, int& length, int low, int high) {
+    int skipped = 0;
+    if (start < low) {
+        skipped = low - start;
+        length -= skipped;
+        start = low;
+    }
+    if (start + length > high) length = high - start;
+    return length > 0 ? skipped : -1;
+}
+
+inline uint32_t* spanPointer(PicoGraphics_PenRGB888& gfx, int x, int y) {
+    return (uint32_t*)gfx.frame_buffer + y * gfx.bounds.w + x;
+}
+
+// length pixels from (x, y) rightwards
+inline void fillSpanH(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t color) {
+    if (y < gfx.clip.y || y >= gfx.clip.y + gfx.clip.h) return;
+    if (clipSpan(x, length, gfx.clip.x, gfx.clip.x + gfx.clip.w) < 0) return;
+
+    uint32_t* p = spanPointer(gfx, x, y);
+    for (int i = 0; i < length; i++) p[i] = color;
+}
+
+// length pixels from (x, y) downwards
+inline void fillSpanV(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t color) {
+    if (x < gfx.clip.x || x >= gfx.clip.x + gfx.clip.w) return;
+    if (clipSpan(y, length, gfx.clip.y, gfx.clip.y + gfx.clip.h) < 0) return;
+
+    uint32_t* p = spanPointer(gfx, x, y);
+    int stride = gfx.bounds.w;
+    for (int i = 0; i < length; i++, p += stride) *p = color;
+}
+
+// Linear blend from `from` at the first pixel to `to` at the last, stepped in
+namespace span_detail {
+    // (to - from) / steps in 16.16, rounded to nearest
+    inline int32_t gradientStep(int32_t from, int32_t to, int steps) {
+        int32_t delta = (to - from) * 65536;
+        return (delta + (delta < 0 ? -steps / 2 : steps / 2)) / steps;
+    }
+}
+
+// 16.16 fixed point per channel, along a row or down a column. Channels
+// start half a level up and are truncated, so each pixel is rounded to
+// nearest and the last one lands on to.
+inline void fillGradient(PicoGraphics_PenRGB888& gfx, int x, int y, int length, bool vertical,
+                         uint32_t from, uint32_t to) {
+    int full_length = length;
+    int skipped;
+    if (vertical) {
+        if (x < gfx.clip.x || x >= gfx.clip.x + gfx.clip.w) return;
+        skipped = clipSpan(y, length, gfx.clip.y, gfx.clip.y + gfx.clip.h);
+    } else {
+        if (y < gfx.clip.y || y >= gfx.clip.y + gfx.clip.h) return;
+        skipped = clipSpan(x, length, gfx.clip.x, gfx.clip.x + gfx.clip.w);
+    }
+    if (skipped < 0) return;
+
+    int32_t r = ((int32_t)penRed(from) << 16) + 0x8000;
+    int32_t g = ((int32_t)penGreen(from) << 16) + 0x8000;
+    int32_t b = ((int32_t)penBlue(from) << 16) + 0x8000;
+    int32_t dr = 0, dg = 0, db = 0;
+    if (full_length > 1) {
+        dr = span_detail::gradientStep(penRed(from), penRed(to), full_length - 1);
+        dg = span_detail::gradientStep(penGreen(from), penGreen(to), full_length - 1);
+        db = span_detail::gradientStep(penBlue(from), penBlue(to), full_length - 1);
+    }
+    r += dr * skipped;
+    g += dg * skipped;
+    b += db * skipped;
+
+    uint32_t* p = spanPointer(gfx, x, y);
+    int step = vertical ? gfx.bounds.w : 1;
+    for (int i = 0; i < length; i++, p += step, r += dr, g += dg, b += db) {
+        *p = ((uint32_t)(r >> 16) << 16) | ((uint32_t)(g >> 16) << 8) | (uint32_t)(b >> 16);
+    }
+}
+
+inline void fillGradientH(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t from, uint32_t to) {
+    fillGradient(gfx, x, y, length, false, from, to);
+}
+
+inline void fillGradientV(PicoGraphics_PenRGB888& gfx, int x, int y, int length, uint32_t from, uint32_t to) {
+    fillGradient(gfx, x, y, length, true, from, to);
+}
+
+inline void fillRect(PicoGraphics_PenRGB888& gfx, int x, int y, int width, int height, uint32_t color) {
+    if (clipSpan(y, height, gfx.clip.y, gfx.clip.y + gfx.clip.h) < 0) return;
+    if (clipSpan(x, width, gfx.clip.x, gfx.clip.x + gfx.clip.w) < 0) return;
+
+    uint32_t* p = spanPointer(gfx, x, y);
+    int stride = gfx.bounds.w;
+    for (int row = 0; row < height; row++, p += stride) {
+        for (int i = 0; i < width; i++) p[i] = color;
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "color.hpp"
+
+using namespace pimoroni;
+
+// Pre-rasterised sprites for shapes that are otherwise redrawn from
+// geometry every frame. capture() runs ordinary drawing code against a
+// scratch frame and stores what it drew as runs of opaque pixels, each run
+// 8-bit palette indices, so drawing it later is a copy per run with no float
+// math, no per-pixel bounds checks and no transparent pixels visited.
+//
+// build() runs the captures twice: once to size the atlas, then again to
+// fill it, so every table is allocated once at its final size rather than
+// grown (in the game arena an outgrown block is never handed back).
+//
+//   atlas.build([&] {
+//       tree = atlas.capture(gfx, 16, 28, [&](PicoGraphics_PenRGB888& g) { drawTree(g, 16, 28, 0.5f); });
+//   });
+//   ...
+//   atlas.blit(gfx, tree, x, y, shade);   // the tree drawn at (x, y)
+//
+// Each blit can be shaded: level SHADE_LEVELS - 1 is full brightness and
+// each level below drops an eighth, from per-level palettes made as colours
+// are added. Up to 255 colours; past that a pixel takes the nearest one.
+
+class SpriteAtlas {
+public:
+    static constexpr int SHADE_LEVELS = 8;
+    static constexpr int MAX_COLOURS = 255;
+
+    // Bounding box, relative to the anchor, and where its runs start
+    struct Sprite {
+        int8_t left, top;
+        uint8_t width, height;
+        uint32_t first_run;
+        uint32_t run_count;
+        uint32_t offset;      // Into the index data; runs follow on
+    };
+
+    // A horizontal stretch of drawn pixels, relative to the anchor
+    struct Run {
+        int8_t x, y;
+        uint8_t length;
+    };
+
+    // Calls capture_all() to size the atlas, allocates it, then calls it again
+    // to fill it. capture_all() must make the same captures both times.
+    template <typename CaptureAll>
+    void build(CaptureAll capture_all) {
+        palette.reserve(MAX_COLOURS + 1);
+        palette.push_back(0);  // Index 0 is transparent
+        sizing = true;
+        capture_all();
+        sizing = false;
+        sprites.reserve(sized_sprites);
+        runs.reserve(sized_runs);
+        indices.reserve(sized_indices);
+        shaded.reserve((colour_count + 1) * SHADE_LEVELS);
+        for (int i = 0; i <= colour_count; i++) {
+            for (int level = 0; level < SHADE_LEVELS; level++) {
+                shaded.push_back(i == 0 ? 0 : dimPen(palette[i], (uint8_t)((level + 1) * 256 / SHADE_LEVELS - 1)));
+            }
+        }
+        capture_all();
+        // The scratch frame and colour list are only needed while capturing
+        std::vector<uint32_t>().swap(scratch);
+        std::vector<uint32_t>().swap(palette);
+    }
+
+    // Runs draw(gfx) onto a blank frame and stores what it drew, relative to
+    // (anchor_x, anchor_y). Returns the sprite's index. Only call from
+    // build()'s capture_all().
+    template <typename Draw>
+    int capture(PicoGraphics_PenRGB888& gfx, int anchor_x, int anchor_y, Draw draw) {
+        int frame_w = gfx.bounds.w, frame_h = gfx.bounds.h;
+        scratch.assign(frame_w * frame_h, UNDRAWN);
+        void* target = gfx.frame_buffer;
+        gfx.set_framebuffer(scratch.data());
+        draw(gfx);
+        gfx.set_framebuffer(target);
+
+        int min_x = frame_w, min_y = frame_h, max_x = -1, max_y = -1;
+        for (int y = 0; y < frame_h; y++) {
+            for (int x = 0; x < frame_w; x++) {
+                if (scratch[y * frame_w + x] == UNDRAWN) continue;
+                if (x < min_x) min_x = x;
+                if (x > max_x) max_x = x;
+                if (y < min_y) min_y = y;
+                if (y > max_y) max_y = y;
+            }
+        }
+
+        if (sizing) {
+            for (int y = min_y; y <= max_y; y++) {
+                for (int x = min_x; x <= max_x; x++) {
+                    if (scratch[y * frame_w + x] == UNDRAWN) continue;
+                    while (x <= max_x && scratch[y * frame_w + x] != UNDRAWN) {
+                        colourIndex(scratch[y * frame_w + x]);
+                        sized_indices++;
+                        x++;
+                    }
+                    sized_runs++;
+                }
+            }
+            return (int)sized_sprites++;
+        }
+
+        Sprite sprite = {0, 0, 0, 0, (uint32_t)runs.size(), 0, (uint32_t)indices.size()};
+        if (max_x >= 0) {
+            sprite.left = (int8_t)(min_x - anchor_x);
+            sprite.top = (int8_t)(min_y - anchor_y);
+            sprite.width = (uint8_t)(max_x - min_x + 1);
+            sprite.height = (uint8_t)(max_y - min_y + 1);
+            for (int y = min_y; y <= max_y; y++) {
+                for (int x = min_x; x <= max_x; x++) {
+                    if (scratch[y * frame_w + x] == UNDRAWN) continue;
+                    int start = x;
+                    while (x <= max_x && scratch[y * frame_w + x] != UNDRAWN) {
+                        indices.push_back(colourIndex(scratch[y * frame_w + x]));
+                        x++;
+                    }
+                    runs.push_back({(int8_t)(start - anchor_x), (int8_t)(y - anchor_y), (uint8_t)(x - start)});
+                }
+            }
+            sprite.run_count = (uint32_t)runs.size() - sprite.first_run;
+        }
+        sprites.push_back(sprite);
+        return (int)sprites.size() - 1;
+    }
+
+    // Sprite drawn with its anchor at (x, y), clipped to the clip rect
+    void blit(PicoGraphics_PenRGB888& gfx, int sprite_index, int x, int y, int shade = SHADE_LEVELS - 1) const {
+        const Sprite& sprite = sprites[sprite_index];
+        const Rect& clip = gfx.clip;
+        int clip_right = clip.x + clip.w, clip_bottom = clip.y + clip.h;
+        int left = x + sprite.left, top = y + sprite.top;
+        if (left >= clip_right || top >= clip_bottom ||
+            left + sprite.width <= clip.x || top + sprite.height <= clip.y) return;
+
+        const uint32_t* pens = &shaded[shade];
+        uint32_t* frame = (uint32_t*)gfx.frame_buffer;
+        const uint8_t* source = indices.data() + sprite.offset;
+        const Run* run = runs.data() + sprite.first_run;
+        for (uint32_t r = 0; r < sprite.run_count; r++, run++) {
+            const uint8_t* run_source = source;
+            source += run->length;
+            int row = y + run->y;
+            if (row < clip.y || row >= clip_bottom) continue;
+
+            int start = x + run->x, end = start + run->length;
+            if (start < clip.x) {
+                run_source += clip.x - start;
+                start = clip.x;
+            }
+            if (end > clip_right) end = clip_right;
+
+            uint32_t* out = frame + row * gfx.bounds.w;
+            for (int px = start; px < end; px++) out[px] = pens[*run_source++ * SHADE_LEVELS];
+        }
+    }
+
+    const Sprite& getSprite(int sprite_index) const { return sprites[sprite_index]; }
+    int getSpriteCount() const { return (int)sprites.size(); }
+    int getColourCount() const { return colour_count; }
+
+    // Bytes held once capturing is finished: index data, runs, sprite table
+    // and the shaded palettes
+    size_t getFootprintBytes() const {
+        return indices.capacity() + runs.capacity() * sizeof(Run) + sprites.capacity() * sizeof(Sprite) +
+               shaded.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    // Never a pen: pens have a zero top byte
+    static constexpr uint32_t UNDRAWN = 0xff000000;
+
+    std::vector<Sprite> sprites;
+    std::vector<Run> runs;
+    std::vector<uint8_t> indices;
+    // shaded[index * SHADE_LEVELS + level]; index 0 is transparent
+    std::vector<uint32_t> shaded;
+    int colour_count = 0;
+
+    // While building: the frame captures draw into, each colour's full pen
+    // (found in the sizing pass, so the second pass only looks them up) and
+    // what the sizing pass counted
+    std::vector<uint32_t> scratch;
+    std::vector<uint32_t> palette;
+    bool sizing = false;
+    size_t sized_sprites = 0, sized_runs = 0, sized_indices = 0;
+
+    uint8_t colourIndex(uint32_t pen) {
+        for (int i = 1; i <= colour_count; i++) {
+            if (palette[i] == pen) return (uint8_t)i;
+        }
+        if (colour_count == MAX_COLOURS || !sizing) return nearestColour(pen);
+
+        colour_count++;
+        palette.push_back(pen);
+        return (uint8_t)colour_count;
+    }
+
+    uint8_t nearestColour(uint32_t pen) const {
+        int best = 1, best_distance = 1 << 30;
+        for (int i = 1; i <= colour_count; i++) {
+            int dr = penRed(palette[i]) - penRed(pen);
+            int dg = penGreen(palette[i]) - penGreen(pen);
+            int db = penBlue(palette[i]) - penBlue(pen);
+            int distance = dr * dr + dg * dg + db * db;
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = i;
+            }
+        }
+        return (uint8_t)best;
+    }
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stddef.h>
+#include <malloc.h>
+
+// Bytes currently handed out by malloc (and therefore by new)
+inline size_t heapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    return mallinfo2().uordblks;
+#else
+    return (size_t)mallinfo().uordblks;
+#endif
+}
+
+#if PICO_ON_DEVICE
+// Linker symbols bounding the region malloc grows into
+extern "C" char __bss_end__;
+extern "C" char __StackLimit;
+
+inline size_t heapBytesTotal() {
+    return (size_t)(&__StackLimit - &__bss_end__);
+}
+#else
+inline size_t heapBytesTotal() {
+    return 0;  // Unbounded on a desktop
+}
+#endif
@@ -0,0 +1,1193 @@
+// Render benchmark for the host build (cosmic_benchmark_host). Runs every
+// game - and every scene, theme or effect a game cycles through - for a fixed
+// number of frames against a 32x32 software framebuffer, timing update() and
+// render() separately and counting heap allocations, then writes the results
+// as JSON (benchmark.json by default) so runs can be compared over time.
+//
+//   ./build-host/cosmic_benchmark_host --frames 600 --out bench.json
+//
+// The fake clock advances one update period (from the game's preferred rate)
+// per iteration, so games animate as they would on the panel; only the wall
+// time spent in the game is measured. Every update is rendered, and every
+// frame is also run through the frame stream encoder (frame_stream.hpp) to
+// time it and size its records.
+//
+// --micro runs drawing microbenchmarks instead: each fast path against the
+// per-pixel code it replaced, over the same pixels, reported side by side.
+// It also times the fixed-point game math in math/fixed.hpp against the
+// same code on host/soft_float.hpp's software float, since the RP2040 has no
+// FPU (math/fixed_bench.hpp; a COSMIC_FIXED_BENCH firmware runs the same
+// kernels on the board), the table-driven functions in math/fast_math.hpp
+// against float libm, gfx/color.hpp against float HSV,
+// effects/polar_field.hpp against per-pixel atan2/sqrt/sin,
+// gfx/sprite_atlas.hpp blits against the racer's scenery geometry,
+// gfx/blend.hpp against float read-back blending and the gfx/deep_frame.hpp
+// dither pass against 8-bit fills, and each shader effect's kernel
+// (effects/shader_kernel.hpp) on its own against drawing it pixel by pixel.
+// It checks the math for accuracy (and the span gradients for rounding, and
+// the frame stream for decoding back exactly, and the soft float against the
+// host's), exiting with 1 if a function drifts past its tolerance. (The host
+// has an FPU, so the other float baselines understate what the RP2040's soft
+// float costs.)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "pico/stdlib.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "cosmic_unicorn.hpp"
+
+#include "games/arcade_racer_game.hpp"
+#include "games/frogger_game.hpp"
+#include "games/tetris_game.hpp"
+#include "games/shader_effects_game.hpp"
+#include "games/halloween_game.hpp"
+#include "games/side_scroller_game.hpp"
+#include "games/qix_game.hpp"
+#include "gfx/span_fill.hpp"
+#include "math/fixed.hpp"
+#include "math/fixed_bench.hpp"
+#include "math/fast_math.hpp"
+#include "gfx/color.hpp"
+#include "effects/polar_field.hpp"
+#include "effects/shader_kernel.hpp"
+#include "gfx/compositor.hpp"
+#include "gfx/blend.hpp"
+#include "gfx/deep_frame.hpp"
+#include "gfx/glyph_font.hpp"
+#include "frame_stream.hpp"
+#include "soft_float.hpp"
+
+using namespace pimoroni;
+
+// Every new/delete in the benchmark is counted
+static uint64_t allocation_count = 0;
+static uint64_t allocation_bytes = 0;
+
+static void* countedAlloc(size_t size) {
+    allocation_count++;
+    allocation_bytes += size;
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+struct BenchmarkGame {
+    const char* name;  // Menu name, as used by the host runner's --game
+    std::unique_ptr<GameBase> (*create)();
+};
+
+template <typename T>
+std::unique_ptr<GameBase> createBenchmarkGame() {
+    return std::make_unique<T>();
+}
+
+static const BenchmarkGame benchmark_games[] = {
+    {"SPOOK", createBenchmarkGame<HalloweenGame>},
+    {"P-TYPE", createBenchmarkGame<SideScrollerGame>},
+    {"RACE", createBenchmarkGame<ArcadeRacerGame>},
+    {"FROG", createBenchmarkGame<FroggerGame>},
+    {"QIX", createBenchmarkGame<QixGame>},
+    {"BLOCKS", createBenchmarkGame<TetrisGame>},
+    {"PRETTY", createBenchmarkGame<ShaderEffectsGame>},
+};
+
+struct BenchmarkOptions {
+    int frames = 600;
+    int warmup = 60;
+    const char* only_game = nullptr;
+    const char* out_path = "benchmark.json";  // Not stdout: some games print
+    bool micro = false;
+    int micro_iterations = 20000;
+};
+
+struct BenchmarkResult {
+    const char* game;
+    std::string variant;
+    int frames;
+    uint64_t update_ns;
+    uint64_t render_ns;
+    uint64_t max_frame_ns;
+    uint64_t allocations;
+    uint64_t allocated_bytes;
+    uint64_t stream_ns;          // Frame stream encoding
+    uint64_t max_stream_ns;
+    uint64_t stream_bytes;
+};
+
+// One microbenchmark: the old way and the new way of drawing the same thing
+struct MicroResult {
+    const char* name;
+    uint64_t pixels;       // Pixels written (or values computed) per iteration
+    double baseline_ns;    // Per iteration
+    double fast_ns;
+};
+
+static uint64_t nowNs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Folded into the output so the framebuffer writes can't be optimised away
+static volatile uint32_t micro_sink = 0;
+
+static void sinkFrame(PicoGraphics_PenRGB888& graphics) {
+    const uint32_t* pixels = (const uint32_t*)graphics.frame_buffer;
+    uint32_t sum = 0;
+    for (int i = 0; i < CosmicUnicorn::WIDTH * CosmicUnicorn::HEIGHT; i++) sum += pixels[i];
+    micro_sink = micro_sink + sum;
+}
+
+template <typename Draw>
+static double timeMicro(PicoGraphics_PenRGB888& graphics, int iterations, Draw draw) {
+    for (int i = 0; i < iterations / 10 + 1; i++) draw(i);  // Warm up
+    uint64_t start = nowNs();
+    for (int i = 0; i < iterations; i++) draw(i);
+    uint64_t end = nowNs();
+    sinkFrame(graphics);
+    return (double)(end - start) / iterations;
+}
+
+template <typename Baseline, typename Fast>
+static MicroResult runMicro(const char* name, uint64_t pixels, PicoGraphics_PenRGB888& graphics,
+                            int iterations, Baseline baseline, Fast fast) {
+    MicroResult result = {name, pixels, 0, 0};
+    result.baseline_ns = timeMicro(graphics, iterations, baseline);
+    result.fast_ns = timeMicro(graphics, iterations, fast);
+    return result;
+}
+
+// Span fills (gfx/span_fill.hpp) against set_pen() + pixel() per pixel
+static void runSpanBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH;
+    const int h = CosmicUnicorn::HEIGHT;
+
+    results.push_back(runMicro("span_h_full_frame", w * h, graphics, iterations,
+        [&](int i) {
+            for (int y = 0; y < h; y++) {
+                graphics.set_pen(graphics.create_pen(i, y, 40));
+                for (int x = 0; x < w; x++) graphics.pixel(Point(x, y));
+            }
+        },
+        [&](int i) {
+            for (int y = 0; y < h; y++) fillSpanH(graphics, 0, y, w, packPen(i, y, 40));
+        }));
+
+    results.push_back(runMicro("span_v_full_frame", w * h, graphics, iterations,
+        [&](int i) {
+            for (int x = 0; x < w; x++) {
+                graphics.set_pen(graphics.create_pen(x, i, 40));
+                for (int y = 0; y < h; y++) graphics.pixel(Point(x, y));
+            }
+        },
+        [&](int i) {
+            for (int x = 0; x < w; x++) fillSpanV(graphics, x, 0, h, packPen(x, i, 40));
+        }));
+
+    // Shaded columns, as the side scroller's floor and ceiling were drawn
+    results.push_back(runMicro("gradient_v_full_frame", w * h, graphics, iterations,
+        [&](int i) {
+            for (int x = 0; x < w; x++) {
+                for (int y = 0; y < h; y++) {
+                    float intensity = 0.6f + 0.4f * y / h;
+                    graphics.set_pen((uint8_t)(200 * intensity), (uint8_t)((i & 127) * intensity), (uint8_t)(90 * intensity));
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        },
+        [&](int i) {
+            float end = 0.6f + 0.4f * (h - 1) / h;
+            for (int x = 0; x < w; x++) {
+                fillGradientV(graphics, x, 0, h, scalePen(200, i & 127, 90, 0.6f),
+                              scalePen(200, i & 127, 90, end));
+            }
+        }));
+
+    // The menu's selection bar
+    results.push_back(runMicro("rect_32x6", w * 6, graphics, iterations,
+        [&](int i) {
+            for (int x = 0; x < w; x++) {
+                for (int y = 8; y < 14; y++) {
+                    graphics.set_pen(graphics.create_pen(60, 60, i));
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        },
+        [&](int i) {
+            fillRect(graphics, 0, 8, w, 6, packPen(60, 60, i));
+        }));
+}
+
+// The kernels' float calls, on soft float
+static SoftFloat benchSqrt(SoftFloat x) { return softSqrt(x); }
+static SoftFloat benchSin(SoftFloat x) { return softSin(x); }
+static SoftFloat benchAtan2(SoftFloat y, SoftFloat x) { return softAtan2(y, x); }
+
+// The game code ported to fix16 against the same code on soft float, which
+// is what the float version costs on the RP2040
+static void runFixedBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    forEachFixedBench<SoftFloat>([&](const char* name, int items, auto run_float, auto run_fixed) {
+        results.push_back(runMicro(name, items, graphics, iterations,
+            [&](int i) { micro_sink = micro_sink + fixedBenchBits(run_float()); },
+            [&](int i) { micro_sink = micro_sink + fixedBenchBits(run_fixed()); }));
+    });
+}
+
+// math/fast_math.hpp against the libm calls it replaced, over the
+// arguments the effects use
+static void runFastMathBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int n = 1024;  // One frame of per-pixel calls
+    static float angles[n], distances[n], coords[n];
+    for (int i = 0; i < n; i++) {
+        angles[i] = i * 0.05f - 20.0f;
+        coords[i] = (i & 31) - 15.5f;
+        distances[i] = coords[i] * coords[i] + ((i >> 5) - 15.5f) * ((i >> 5) - 15.5f);
+    }
+
+    results.push_back(runMicro("fast_sin", n, graphics, iterations,
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += sinf(angles[k] + i);
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        },
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += fastSin(angles[k] + i);
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        }));
+
+    results.push_back(runMicro("fast_sqrt", n, graphics, iterations,
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += sqrtf(distances[k] + i);
+            micro_sink = micro_sink + (uint32_t)sum;
+        },
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += fastSqrt(distances[k] + i);
+            micro_sink = micro_sink + (uint32_t)sum;
+        }));
+
+    results.push_back(runMicro("fast_atan2", n, graphics, iterations,
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += atan2f(coords[n - 1 - k] + i, coords[k]);
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        },
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += fastAtan2(coords[n - 1 - k] + i, coords[k]);
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        }));
+
+    results.push_back(runMicro("fast_exp", n, graphics, iterations,
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += expf(-0.3f * fastSqrt(distances[k]) - (i & 7));
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        },
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) sum += fastExp(-0.3f * fastSqrt(distances[k]) - (i & 7));
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        }));
+
+    // The road's per-scanline curve terms
+    results.push_back(runMicro("fast_pow_int", n, graphics, iterations,
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) {
+                float depth = 1.0f - (k & 15) / 16.0f;
+                sum += pow(depth, 3) * i + pow(depth, 2);
+            }
+            micro_sink = micro_sink + (uint32_t)sum;
+        },
+        [&](int i) {
+            float sum = 0;
+            for (int k = 0; k < n; k++) {
+                float depth = 1.0f - (k & 15) / 16.0f;
+                sum += cubed(depth) * i + squared(depth);
+            }
+            micro_sink = micro_sink + (uint32_t)sum;
+        }));
+}
+
+// The float HSV conversion each game used to carry its own copy of
+static void floatHsvToRgb(float h, float s, float v, uint8_t& r, uint8_t& g, uint8_t& b) {
+    int i = int(h * 6.0f);
+    float f = h * 6.0f - i;
+    float p = v * (1.0f - s);
+    float q = v * (1.0f - f * s);
+    float t = v * (1.0f - (1.0f - f) * s);
+
+    switch (i % 6) {
+        case 0: r = v * 255; g = t * 255; b = p * 255; break;
+        case 1: r = q * 255; g = v * 255; b = p * 255; break;
+        case 2: r = p * 255; g = v * 255; b = t * 255; break;
+        case 3: r = p * 255; g = q * 255; b = v * 255; break;
+        case 4: r = t * 255; g = p * 255; b = v * 255; break;
+        case 5: r = v * 255; g = p * 255; b = q * 255; break;
+    }
+}
+
+// gfx/color.hpp against the float conversion, one full frame of rainbow
+static void runColorBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH, h = CosmicUnicorn::HEIGHT;
+
+    results.push_back(runMicro("hsv_pixel", w * h, graphics, iterations,
+        [&](int i) {
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    float hue = (x + y + i) * (1.0f / 64);
+                    hue -= floorf(hue);
+                    uint8_t r = 0, g = 0, b = 0;
+                    floatHsvToRgb(hue, 0.9f, y * (1.0f / h), r, g, b);
+                    graphics.set_pen(r, g, b);
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        },
+        [&](int i) {
+            // A turn every 64 pixels, and value 0..255 down the panel
+            for (int y = 0; y < h; y++) {
+                uint8_t val = (uint8_t)(y * 255 / h);
+                for (int x = 0; x < w; x++) {
+                    graphics.set_pen(hsvPen((x + y + i) * (HUE_STEPS / 64), 229, val));
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        }));
+
+    results.push_back(runMicro("hue_wheel_pixel", w * h, graphics, iterations,
+        [&](int i) {
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    float hue = ((x + y + i) & 255) * (1.0f / 256);
+                    uint8_t r = 0, g = 0, b = 0;
+                    floatHsvToRgb(hue, 1.0f, 1.0f, r, g, b);
+                    graphics.set_pen(r, g, b);
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        },
+        [&](int i) {
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    graphics.set_pen(hueWheelPen((uint8_t)(x + y + i)));
+                    graphics.pixel(Point(x, y));
+                }
+            }
+        }));
+}
+
+// effects/polar_field.hpp against the per-pixel atan2/sqrt/sin it replaced:
+// the rainbow spiral's hue and brightness terms
+static constexpr RadialWave BENCH_RING{0.3};
+
+static void runPolarBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH, h = CosmicUnicorn::HEIGHT;
+    static constexpr PixelTable<float> hue_table{
+        [](PolarPixel p) { return p.angle / (2 * fast_math_detail::PI) + p.distance * 0.1; }};
+
+    results.push_back(runMicro("polar_spiral", w * h, graphics, iterations,
+        [&](int i) {
+            float t = i * 0.01f, sum = 0;
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    float cx = x - w / 2.0f, cy = y - h / 2.0f;
+                    float angle = fastAtan2(cy, cx);
+                    float distance = fastSqrt(cx * cx + cy * cy);
+                    float hue = angle * (float)(1 / (2 * M_PI)) + distance * 0.1f - t * 0.3f;
+                    sum += hue + fastSin(distance * 0.3f - t * 2.0f);
+                }
+            }
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        },
+        [&](int i) {
+            float t = i * 0.01f, sum = 0;
+            RadialWave::Phase ring = RadialWave::phase(-t * 2.0f);
+            for (int p = 0; p < POLAR_PIXELS; p++) {
+                sum += hue_table[p] - t * 0.3f + BENCH_RING.at(p, ring);
+            }
+            micro_sink = micro_sink + (uint32_t)(sum * 1000);
+        }));
+}
+
+// A full-frame animated background (the Halloween nebula) drawn every frame
+// against the same drawing in a Layer redrawn every fourth frame, plus the
+// per-frame cost of compositing a cached layer each way
+static void drawBenchNebula(PicoGraphics_PenRGB888& graphics, float phase) {
+    for (int y = 0; y < CosmicUnicorn::HEIGHT; y++) {
+        for (int x = 0; x < CosmicUnicorn::WIDTH; x++) {
+            float noise1 = sinf(x * 0.1f + phase * 0.3f) * cosf(y * 0.15f + phase * 0.2f);
+            float noise2 = sinf(x * 0.08f - phase * 0.25f) * cosf(y * 0.12f - phase * 0.15f);
+            float nebula = (noise1 + noise2) * 0.3f + 0.2f;
+            uint8_t level = nebula > 0.05f ? (uint8_t)(nebula * 100) : 0;
+            graphics.set_pen(level * 0.8f, level * 0.3f, level);
+            graphics.pixel(Point(x, y));
+        }
+    }
+}
+
+static void runCompositorBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH, h = CosmicUnicorn::HEIGHT;
+    float phase = 0;
+
+    Layer nebula{"nebula", LayerRefresh::EVERY_N, 4};
+    nebula.setDraw([&](PicoGraphics_PenRGB888& g) { drawBenchNebula(g, phase); });
+    results.push_back(runMicro("layer_every_4", w * h, graphics, iterations,
+        [&](int i) { phase = i * 0.02f; drawBenchNebula(graphics, phase); },
+        [&](int i) { phase = i * 0.02f; nebula.render(graphics); }));
+
+    // Composite cost alone: a static layer each way against redrawing it
+    const LayerBlend blends[] = {LayerBlend::COPY, LayerBlend::KEYED, LayerBlend::ADD, LayerBlend::ALPHA};
+    const char* const names[] = {"layer_copy", "layer_keyed", "layer_add", "layer_alpha"};
+    for (int b = 0; b < 4; b++) {
+        Layer layer{names[b], LayerRefresh::STATIC, 1, blends[b], 160};
+        layer.setDraw([](PicoGraphics_PenRGB888& g) { drawBenchNebula(g, 1.0f); });
+        results.push_back(runMicro(names[b], w * h, graphics, iterations,
+            [&](int) { drawBenchNebula(graphics, 1.0f); },
+            [&](int) { layer.render(graphics); }));
+    }
+}
+
+// A blend the way it's written without gfx/blend.hpp: read the pixel back,
+// unpack it and blend each channel in float
+static uint32_t floatBlendPens(uint32_t under, uint32_t over, BlendMode mode, float alpha) {
+    const int shifts[3] = {16, 8, 0};
+    uint32_t pen = 0;
+    for (int shift : shifts) {
+        float a = (float)((under >> shift) & 0xff), b = (float)((over >> shift) & 0xff);
+        float c = mode == BlendMode::ADD ? fminf(a + b, 255.0f) :
+                  mode == BlendMode::MULTIPLY ? a * b / 255.0f : a + (b - a) * alpha;
+        pen |= (uint32_t)(c + 0.5f) << shift;
+    }
+    return pen;
+}
+
+// gfx/blend.hpp against the float read-back, over a full frame and an 8x8
+// glow sprite
+static void runBlendBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH, h = CosmicUnicorn::HEIGHT;
+    uint32_t* frame = (uint32_t*)graphics.frame_buffer;
+    const uint32_t color = packPen(40, 90, 160);
+
+    const BlendMode modes[] = {BlendMode::ADD, BlendMode::MULTIPLY, BlendMode::ALPHA};
+    const char* const names[] = {"blend_add_frame", "blend_multiply_frame", "blend_alpha_frame"};
+    for (int m = 0; m < 3; m++) {
+        results.push_back(runMicro(names[m], w * h, graphics, iterations,
+            [&](int i) {
+                for (int y = 0; y < h; y++) {
+                    for (int x = 0; x < w; x++) {
+                        uint32_t pen = floatBlendPens(frame[y * w + x], color, modes[m], 96 / 255.0f);
+                        graphics.set_pen(penRed(pen), penGreen(pen), penBlue(pen));
+                        graphics.pixel(Point(x, y));
+                    }
+                }
+                frame[i & (w * h - 1)] = packPen(i, i * 3, i * 7);  // Keep the frame from settling
+            },
+            [&](int i) {
+                blendRect(graphics, 0, 0, w, h, color, modes[m], 96);
+                frame[i & (w * h - 1)] = packPen(i, i * 3, i * 7);
+            }));
+    }
+
+    uint32_t glow[8 * 8];
+    for (int i = 0; i < 8 * 8; i++) {
+        int dx = i % 8 - 4, dy = i / 8 - 4;
+        int level = 255 - (dx * dx + dy * dy) * 8;
+        glow[i] = level > 0 ? packPen(level / 2, level / 4, level) : 0;
+    }
+    results.push_back(runMicro("blend_add_sprite", 8 * 8, graphics, iterations * 8,
+        [&](int i) {
+            int left = i % (w - 8), top = (i / 3) % (h - 8);
+            for (int y = 0; y < 8; y++) {
+                for (int x = 0; x < 8; x++) {
+                    if (!glow[y * 8 + x]) continue;
+                    uint32_t pen = floatBlendPens(frame[(top + y) * w + left + x], glow[y * 8 + x], BlendMode::ADD, 1);
+                    graphics.set_pen(penRed(pen), penGreen(pen), penBlue(pen));
+                    graphics.pixel(Point(left + x, top + y));
+                }
+            }
+        },
+        [&](int i) {
+            blendPixels(graphics, i % (w - 8), (i / 3) % (h - 8), 8, 8, glow, BlendMode::ADD);
+        }));
+}
+
+// The stormy night sky the way it was drawn (float gradient, set_pen() +
+// pixel()) against the same gradient at 16 bits and dithered, and the
+// dither pass alone against filling the frame with the banded 8-bit rows:
+// what it costs per frame
+static void runDeepFrameBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const int w = CosmicUnicorn::WIDTH, h = CosmicUnicorn::HEIGHT;
+    DeepFrame sky(w, h);
+
+    results.push_back(runMicro("deep_sky_gradient", w * h, graphics, iterations,
+        [&](int i) {
+            for (int y = 0; y < h; y++) {
+                float t = (float)y / h;
+                graphics.set_pen(graphics.create_pen(15 - 10 * t, 15 - 10 * t, 35 - 15 * t + (i & 1)));
+                for (int x = 0; x < w; x++) graphics.pixel(Point(x, y));
+            }
+        },
+        [&](int i) {
+            sky.fillGradientV(0, h, deepColor(15, 15, 35 + (i & 1)), deepColor(5, 5, 20));
+            sky.present(graphics, 0, 0);
+        }));
+
+    sky.fillGradientV(0, h, deepColor(15, 15, 35), deepColor(5, 5, 20));
+    const Dither modes[] = {Dither::ORDERED, Dither::TEMPORAL};
+    const char* const names[] = {"deep_present_ordered", "deep_present_temporal"};
+    for (int m = 0; m < 2; m++) {
+        results.push_back(runMicro(names[m], w * h, graphics, iterations,
+            [&](int) {
+                for (int y = 0; y < h; y++) {
+                    fillSpanH(graphics, 0, y, w, packPen(15 - 10 * y / h, 15 - 10 * y / h, 35 - 15 * y / h));
+                }
+            },
+            [&](int) { sky.present(graphics, 0, 0, modes[m]); }));
+    }
+}
+
+// Racer scenery drawn from geometry (SceneryObject::drawShape) against a
+// blit of the same shape from the scale-cached atlas, small and full size
+static void runSpriteAtlasBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    SceneryAtlas atlas;
+    atlas.build(graphics);
+    const SpriteAtlas& sprites = atlas.getSprites();
+    printf("Scenery atlas: %d sprites, %d colours, %zu bytes\n",
+           sprites.getSpriteCount(), sprites.getColourCount(), sprites.getFootprintBytes());
+
+    struct Case { const char* name; SceneryObject::Type type; float scale; };
+    const Case cases[] = {
+        {"atlas_tree_0.4", SceneryObject::TREE, 0.4f},
+        {"atlas_tree_1.0", SceneryObject::TREE, 1.0f},
+        {"atlas_palm_1.0", SceneryObject::PALM_TREE, 1.0f},
+        {"atlas_church_0.6", SceneryObject::CHURCH, 0.6f},
+        {"atlas_church_1.0", SceneryObject::CHURCH, 1.0f},
+        {"atlas_turbine_1.0", SceneryObject::WIND_TURBINE, 1.0f},
+    };
+    for (const Case& c : cases) {
+        SceneryObject object(c.type);
+        int step = SceneryAtlas::scaleStep(c.scale);
+        int sprite = atlas.spriteFor(c.type, step, false);
+        const SpriteAtlas::Sprite& shape = sprites.getSprite(sprite);
+        results.push_back(runMicro(c.name, shape.width * shape.height, graphics, iterations,
+            [&](int) { object.drawShape(graphics, 12, 28, c.scale); },
+            [&](int) { atlas.blit(graphics, sprite, 12, 28, SpriteAtlas::SHADE_LEVELS - 1); }));
+    }
+}
+
+// Tetris's HUD digits as they were drawn before gfx/glyph_font.hpp: a 3x3
+// pattern per digit, set_pen() and pixel() per lit pixel
+static void legacyDrawNumber(PicoGraphics_PenRGB888& graphics, uint32_t number, int x, int y, uint32_t color) {
+    static const bool pattern[10][9] = {
+        {1,1,1,1,0,1,1,1,1}, {0,1,0,0,1,0,0,1,0}, {1,1,1,0,0,1,1,1,1}, {1,1,1,0,0,1,0,1,1},
+        {1,0,1,1,1,1,0,0,1}, {1,1,1,1,0,0,1,1,1}, {1,1,1,1,0,0,1,1,1}, {1,1,1,0,0,1,0,0,1},
+        {1,1,1,1,1,1,1,1,1}, {1,1,1,1,1,1,0,1,1}
+    };
+    int digits = 0;
+    for (uint32_t temp = number; temp > 0 || digits == 0; temp /= 10) digits++;
+    int current_x = x + (digits - 1) * 4;
+    do {
+        graphics.set_pen(penRed(color), penGreen(color), penBlue(color));
+        for (int i = 0; i < 9; i++) {
+            if (pattern[number % 10][i]) graphics.pixel(Point(current_x + i % 3, y + i / 3));
+        }
+        number /= 10;
+        current_x -= 4;
+    } while (number > 0);
+}
+
+// Menu names through the font renderer against the glyph cache, and the
+// Tetris side panel's numbers
+static void runTextBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    const char* const names[] = {"SPOOK", "P-TYPE", "RACE", "FROG", "QIX", "BLOCKS", "PRETTY"};
+    const uint32_t color = packPen(255, 255, 100);
+    GlyphFont menu_font{&font6};
+    for (const char* name : names) menu_font.prepare(graphics, name);
+
+    results.push_back(runMicro("text_menu_items", 7 * 6 * 24, graphics, iterations,
+        [&](int i) {
+            graphics.set_font(&font6);
+            for (int n = 0; n < 4; n++) {
+                const char* name = names[(i + n) % 7];
+                int width = graphics.measure_text(name, 1.0f);
+                graphics.set_pen(penRed(color), penGreen(color), penBlue(color));
+                graphics.text(name, Point((32 - width) / 2, 2 + n * 7), -1, 1.0f);
+            }
+        },
+        [&](int i) {
+            for (int n = 0; n < 4; n++) {
+                const char* name = names[(i + n) % 7];
+                menu_font.draw(graphics, name, (32 - menu_font.measure(name)) / 2, 2 + n * 7, color);
+            }
+        }));
+
+    results.push_back(runMicro("text_hud_digits", 3 * 4 * 9, graphics, iterations,
+        [&](int i) {
+            legacyDrawNumber(graphics, 1000 + i % 9000, 18, 8, packPen(255, 255, 0));
+            legacyDrawNumber(graphics, i % 10, 18, 12, packPen(0, 255, 100));
+            legacyDrawNumber(graphics, i % 100, 18, 16, packPen(255, 0, 200));
+        },
+        [&](int i) {
+            HUD_DIGITS.drawNumber(graphics, 1000 + i % 9000, 18, 8, packPen(255, 255, 0));
+            HUD_DIGITS.drawNumber(graphics, i % 10, 18, 12, packPen(0, 255, 100));
+            HUD_DIGITS.drawNumber(graphics, i % 100, 18, 16, packPen(255, 0, 200));
+        }));
+}
+
+// A shader kernel drawn the way the effects drew before
+// effects/shader_kernel.hpp: set_pen() + pixel() for every pixel
+template <typename Kernel>
+static void drawKernelPerPixel(PicoGraphics_PenRGB888& graphics, Kernel& kernel, float t) {
+    kernel.frame(t);
+    for (int y = 0; y < CosmicUnicorn::HEIGHT; y++) {
+        kernel.row(y);
+        for (int x = 0; x < CosmicUnicorn::WIDTH; x++) {
+            graphics.set_pen(kernel.colour(x, y, y * CosmicUnicorn::WIDTH + x));
+            graphics.pixel(Point(x, y));
+        }
+    }
+}
+
+template <typename Kernel>
+static MicroResult runKernelMicro(const char* name, PicoGraphics_PenRGB888& graphics, int iterations) {
+    Kernel kernel;
+    return runMicro(name, CosmicUnicorn::WIDTH * CosmicUnicorn::HEIGHT, graphics, iterations,
+        [&](int i) { drawKernelPerPixel(graphics, kernel, i * 0.05f); },
+        [&](int i) { runKernel(graphics, kernel, i * 0.05f); });
+}
+
+// Each shader effect on its own, as a kernel written straight into the
+// framebuffer against the same kernel drawn pixel by pixel
+static void runShaderBenchmarks(PicoGraphics_PenRGB888& graphics, int iterations, std::vector<MicroResult>& results) {
+    results.push_back(runKernelMicro<ShaderEffectsGame::PlasmaKernel>("kernel_plasma", graphics, iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::RainbowSpiralKernel>("kernel_rainbow_spiral", graphics,
+                                                                               iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::FireRipplesKernel>("kernel_fire_ripples", graphics,
+                                                                             iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::VortexMathKernel>("kernel_vortex_math", graphics,
+                                                                            iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::OrganicBlobsKernel>("kernel_organic_blobs", graphics,
+                                                                              iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::PulsingBlobsKernel>("kernel_pulsing_blobs", graphics,
+                                                                              iterations));
+    results.push_back(runKernelMicro<ShaderEffectsGame::NebulaKernel>("kernel_nebula", graphics, iterations));
+}
+
+// Worst absolute error of a fixed-point or fast-math function against libm
+struct AccuracyResult {
+    const char* name;
+    double max_error;
+    double tolerance;
+};
+
+template <typename Fixed, typename Reference>
+static AccuracyResult measureAccuracy(const char* name, double tolerance, double from, double to, int steps,
+                                      Fixed fixed, Reference reference) {
+    AccuracyResult result = {name, 0, tolerance};
+    for (int i = 0; i <= steps; i++) {
+        double x = from + (to - from) * i / steps;
+        double error = fabs(fixed(fix16(x)).toFloat() - reference(fix16(x).toFloat()));
+        if (error > result.max_error) result.max_error = error;
+    }
+    return result;
+}
+
+// relative: error divided by the reference value
+template <typename Fast, typename Reference>
+static AccuracyResult measureFloatAccuracy(const char* name, double tolerance, bool relative, double from, double to,
+                                           int steps, Fast fast, Reference reference) {
+    AccuracyResult result = {name, 0, tolerance};
+    for (int i = 0; i <= steps; i++) {
+        float x = (float)(from + (to - from) * i / steps);
+        double expected = reference((double)x);
+        double error = fabs(fast(x) - expected);
+        if (relative && expected != 0) error /= fabs(expected);
+        if (error > result.max_error) result.max_error = error;
+    }
+    return result;
+}
+
+static void runMathAccuracy(std::vector<AccuracyResult>& results) {
+    results.push_back(measureAccuracy("fixed_sin", 1e-4, -100, 100, 200000,
+        [](fix16 x) { return fixedSin(x); }, [](double x) { return sin(x); }));
+    results.push_back(measureAccuracy("fixed_cos", 1e-4, -100, 100, 200000,
+        [](fix16 x) { return fixedCos(x); }, [](double x) { return cos(x); }));
+    results.push_back(measureAccuracy("fixed_sqrt", 2e-5, 0, 30000, 300000,
+        [](fix16 x) { return fixedSqrt(x); }, [](double x) { return sqrt(x); }));
+    // Relative to the result's size: 1/x for small x is big
+    results.push_back(measureAccuracy("fixed_reciprocal", 2e-5, 0.5, 1000, 200000,
+        [](fix16 x) { return fixedReciprocal(x); }, [](double x) { return 1 / x; }));
+    results.push_back(measureAccuracy("fixed_mul", 2e-5, -180, 180, 200000,
+        [](fix16 x) { return x * fix16(0.85f); }, [](double x) { return x * fix16(0.85f).toFloat(); }));
+
+    AccuracyResult atan = {"fixed_atan2", 0, 2e-4};
+    for (int yi = -200; yi <= 200; yi++) {
+        for (int xi = -200; xi <= 200; xi++) {
+            if (xi == 0 && yi == 0) continue;
+            fix16 y = fix16(yi) / 10, x = fix16(xi) / 10;
+            double error = fabs(fixedAtan2(y, x).toFloat() - atan2(y.toFloat(), x.toFloat()));
+            if (error > atan.max_error) atan.max_error = error;
+        }
+    }
+    results.push_back(atan);
+
+    // host/soft_float.hpp must be the float it stands in for, bit for bit,
+    // or its timings mean nothing. Subnormals are flushed, so skip them.
+    AccuracyResult soft = {"soft_float_ops", 0, 0};
+    uint32_t state = 12345;
+    auto isSubnormal = [](float f) { return f != 0 && fabsf(f) < 1.17549435e-38f; };
+    for (int i = 0; i < 2000000; i++) {
+        state = state * 1664525u + 1013904223u;
+        uint32_t a_bits = (state & 0x83ffffffu) | 0x3c000000u;  // Magnitudes 2^-7 .. 2^8
+        state = state * 1664525u + 1013904223u;
+        uint32_t b_bits = (state & 0x83ffffffu) | 0x3c000000u;
+        float a, b;
+        memcpy(&a, &a_bits, sizeof(a));
+        memcpy(&b, &b_bits, sizeof(b));
+        SoftFloat sa = a, sb = b;
+        float expected[] = {a + b, a - b, a * b, a / b, sqrtf(fabsf(a))};
+        SoftFloat actual[] = {sa + sb, sa - sb, sa * sb, sa / sb, softSqrt(sa < SoftFloat(0) ? -sa : sa)};
+        for (int k = 0; k < 5; k++) {
+            if (isSubnormal(expected[k])) continue;
+            if (fixedBenchBits(expected[k]) != actual[k].raw()) soft.max_error = 1;
+        }
+        if ((sa < sb) != (a < b) || (sa == sb) != (a == b)) soft.max_error = 1;
+    }
+    results.push_back(soft);
+
+    // The bounds documented in math/fast_math.hpp
+    results.push_back(measureFloatAccuracy("fast_sin", 1e-4, false, -1000, 1000, 2000000,
+        [](float x) { return fastSin(x); }, [](double x) { return sin(x); }));
+    results.push_back(measureFloatAccuracy("fast_cos", 1e-4, false, -1000, 1000, 2000000,
+        [](float x) { return fastCos(x); }, [](double x) { return cos(x); }));
+    results.push_back(measureFloatAccuracy("fast_sqrt", 1e-5, true, 1e-6, 1e6, 2000000,
+        [](float x) { return fastSqrt(x); }, [](double x) { return sqrt(x); }));
+    results.push_back(measureFloatAccuracy("fast_sqrt_pixels", 1e-5, true, 0, 512, 200000,
+        [](float x) { return fastSqrt(x); }, [](double x) { return sqrt(x); }));
+    results.push_back(measureFloatAccuracy("fast_exp", 5e-5, true, -87, 88, 2000000,
+        [](float x) { return fastExp(x); }, [](double x) { return exp(x); }));
+
+    AccuracyResult fast_atan = {"fast_atan2", 0, 2e-5};
+    for (int yi = -300; yi <= 300; yi++) {
+        for (int xi = -300; xi <= 300; xi++) {
+            float y = yi * 0.1f, x = xi * 0.1f;
+            double error = fabs(fastAtan2(y, x) - atan2((double)y, (double)x));
+            if (error > fast_atan.max_error) fast_atan.max_error = error;
+        }
+    }
+    results.push_back(fast_atan);
+
+    // Channel levels, against the float conversion over the whole wheel
+    AccuracyResult hsv = {"hsv_pen", 0, 2};
+    for (int hue = 0; hue < HUE_STEPS; hue++) {
+        for (int s = 0; s < 256; s += 15) {
+            for (int v = 0; v < 256; v += 15) {
+                uint8_t r = 0, g = 0, b = 0;
+                floatHsvToRgb((float)hue / HUE_STEPS, s / 255.0f, v / 255.0f, r, g, b);
+                uint32_t pen = hsvPen(hue, (uint8_t)s, (uint8_t)v);
+                int errors[3] = {abs(penRed(pen) - r), abs(penGreen(pen) - g), abs(penBlue(pen) - b)};
+                for (int e : errors) {
+                    if (e > hsv.max_error) hsv.max_error = e;
+                }
+            }
+        }
+    }
+    results.push_back(hsv);
+
+    AccuracyResult polar_angle = {"polar_angle", 0, 2e-5};
+    AccuracyResult polar_distance = {"polar_distance", 0, 2e-5};
+    AccuracyResult radial_wave = {"radial_wave", 0, 2e-4};
+    for (int i = 0; i < POLAR_PIXELS; i++) {
+        double cx = i % POLAR_WIDTH - POLAR_WIDTH / 2, cy = i / POLAR_WIDTH - POLAR_HEIGHT / 2;
+        double distance = sqrt(cx * cx + cy * cy);
+        polar_angle.max_error = fmax(polar_angle.max_error, fabs(POLAR_FIELD.angle(i) - atan2(cy, cx)));
+        polar_distance.max_error = fmax(polar_distance.max_error, fabs(POLAR_FIELD.distance(i) - distance));
+        for (int step = 0; step < 100; step++) {
+            float phase = step * 0.37f - 18.0f;
+            double error = fabs(BENCH_RING.at(i, RadialWave::phase(phase)) - sin(distance * 0.3 + phase));
+            radial_wave.max_error = fmax(radial_wave.max_error, error);
+        }
+    }
+    results.push_back(polar_angle);
+    results.push_back(polar_distance);
+    results.push_back(radial_wave);
+
+    // Channel levels over a grid of pen pairs, against the float blend
+    AccuracyResult blend_add = {"blend_add", 0, 0};
+    AccuracyResult blend_multiply = {"blend_multiply", 0, 1};
+    AccuracyResult blend_alpha = {"blend_alpha", 0, 1};
+    AccuracyResult* blend_results[] = {&blend_add, &blend_multiply, &blend_alpha};
+    const BlendMode blend_modes[] = {BlendMode::ADD, BlendMode::MULTIPLY, BlendMode::ALPHA};
+    for (int a = 0; a < 256; a += 5) {
+        for (int b = 0; b < 256; b += 3) {
+            uint32_t under = packPen(a, 255 - a, a / 2), over = packPen(b, b / 3, 255 - b);
+            for (int m = 0; m < 3; m++) {
+                for (int alpha = 0; alpha < 256; alpha += m == 2 ? 17 : 256) {
+                    uint32_t fast = blendPens(under, over, blend_modes[m], (uint8_t)alpha);
+                    uint32_t exact = floatBlendPens(under, over, blend_modes[m], alpha / 255.0f);
+                    int errors[3] = {abs(penRed(fast) - penRed(exact)), abs(penGreen(fast) - penGreen(exact)),
+                                     abs(penBlue(fast) - penBlue(exact))};
+                    for (int e : errors) {
+                        if (e > blend_results[m]->max_error) blend_results[m]->max_error = e;
+                    }
+                }
+            }
+        }
+    }
+    results.push_back(blend_add);
+    results.push_back(blend_multiply);
+    results.push_back(blend_alpha);
+
+    // A temporally dithered pixel averaged over the 16-frame cycle, in 8-bit
+    // levels, against the 16-bit value it stands for (up to 255.0, the most
+    // deepColor() gives)
+    AccuracyResult deep_dither = {"deep_dither_mean", 0, 1.0 / 16};
+    {
+        static uint32_t frame[4 * 4];
+        PicoGraphics_PenRGB888 small(4, 4, frame);
+        DeepFrame deep(4, 4);
+        for (int value = 0; value <= 65280; value += 37) {
+            deep.clear({(uint16_t)value, (uint16_t)value, (uint16_t)value});
+            int sum = 0;
+            for (int f = 0; f < 16; f++) {
+                deep.present(small, 0, 0, Dither::TEMPORAL);
+                sum += penRed(frame[5]);
+            }
+            deep_dither.max_error = fmax(deep_dither.max_error, fabs(sum / 16.0 - value / 256.0));
+        }
+    }
+    results.push_back(deep_dither);
+
+    // Pixels that differ after a frame stream round trip: a key frame of
+    // noise, then frames with a moved block, long flat runs, a single pixel,
+    // no change at all and a fresh key frame
+    AccuracyResult stream = {"stream_roundtrip", 0, 0};
+    {
+        const int pixels = FrameStreamEncoder::PIXELS;
+        static FrameStreamEncoder encoder;
+        static std::vector<uint8_t> bytes;
+        bytes.clear();
+        encoder.begin([](const uint8_t* data, size_t length, void*) { bytes.insert(bytes.end(), data, data + length); });
+
+        std::vector<std::vector<uint32_t>> frames;
+        std::vector<uint32_t> frame(pixels);
+        srand(7);
+        for (uint32_t& p : frame) p = packPen(rand() & 255, rand() & 255, rand() & 255);
+        frames.push_back(frame);
+        for (int i = 100; i < 300; i++) frame[i] = packPen(40, 200, 90);
+        frames.push_back(frame);
+        for (int i = 0; i < pixels; i++) frame[i] = i < 700 ? 0 : packPen(0, 0, i & 1 ? 255 : 254);
+        frames.push_back(frame);
+        frame[pixels - 1] = packPen(255, 255, 255);
+        frames.push_back(frame);
+        frames.push_back(frame);
+        frames.push_back(frame);
+
+        std::vector<uint32_t> decoded(pixels, 0);
+        for (size_t f = 0; f < frames.size(); f++) {
+            if (f + 1 == frames.size()) encoder.requestKeyFrame();
+            encoder.encodeFrame(frames[f].data(), f * 50000);
+        }
+        FrameStreamDecoder decoder;
+        FrameStreamDecoder::Frame record;
+        size_t next = 0;
+        if (!decoder.begin(bytes.data(), bytes.size())) stream.max_error = pixels;
+        while (decoder.next(decoded.data(), record)) {
+            // Unchanged frames have no record; compare against the one sent
+            next = record.number - 1;
+            int wrong = 0;
+            for (int i = 0; i < pixels; i++) wrong += decoded[i] != frames[next][i];
+            if (wrong > stream.max_error) stream.max_error = wrong;
+        }
+        if (next + 1 != frames.size()) stream.max_error = pixels;
+    }
+    results.push_back(stream);
+
+    // Worst distance of a gradient pixel from the exact line between its
+    // ends, in levels, for every length up to a column and channels going
+    // both ways; rounded to nearest it's at most half a level, and the ends
+    // are exact
+    AccuracyResult gradient = {"span_gradient", 0, 0.5 + 1e-6};
+    {
+        static uint32_t pixels[32 * 32];
+        PicoGraphics_PenRGB888 gradient_gfx(32, 32, pixels);
+        for (int length = 1; length <= 32; length++) {
+            for (int from = 0; from < 256; from += 15) {
+                for (int to = 0; to < 256; to += 17) {
+                    fillGradientV(gradient_gfx, 0, 0, length, packPen(from, to, 255 - from), packPen(to, from, 255 - to));
+                    for (int i = 0; i < length; i++) {
+                        double k = length > 1 ? (double)i / (length - 1) : 0;
+                        double error = fabs(penRed(pixels[i * 32]) - (from + (to - from) * k));
+                        if (i == length - 1 && length > 1 && penRed(pixels[i * 32]) != to) error = 1;
+                        if (error > gradient.max_error) gradient.max_error = error;
+                    }
+                }
+            }
+        }
+    }
+    results.push_back(gradient);
+
+    // Pixels that differ between the HUD digit font and the digits it
+    // replaced, for numbers of every length, including ones clipped at the
+    // right edge
+    AccuracyResult hud_digits = {"text_hud_digits", 0, 0};
+    {
+        static uint32_t legacy[32 * 32], glyphs[32 * 32];
+        PicoGraphics_PenRGB888 legacy_gfx(32, 32, legacy), glyph_gfx(32, 32, glyphs);
+        for (uint32_t number = 0; number < 2000000; number = number * 3 + 1) {
+            for (int x = 10; x < 32; x += 7) {
+                memset(legacy, 0, sizeof(legacy));
+                memset(glyphs, 0, sizeof(glyphs));
+                legacyDrawNumber(legacy_gfx, number, x, 8, packPen(255, 255, 0));
+                HUD_DIGITS.drawNumber(glyph_gfx, number, x, 8, packPen(255, 255, 0));
+                int wrong = 0;
+                for (int i = 0; i < 32 * 32; i++) wrong += legacy[i] != glyphs[i];
+                if (wrong > hud_digits.max_error) hud_digits.max_error = wrong;
+            }
+        }
+    }
+    results.push_back(hud_digits);
+
+    // Pixels that differ between each shader kernel written straight into
+    // the framebuffer and drawn pixel by pixel, over a minute of frames
+    AccuracyResult kernels = {"kernel_direct_writes", 0, 0};
+    {
+        static uint32_t per_pixel[32 * 32], direct[32 * 32];
+        PicoGraphics_PenRGB888 per_pixel_gfx(32, 32, per_pixel), direct_gfx(32, 32, direct);
+        auto compare = [&](auto kernel) {
+            for (float t = 0; t < 60.0f; t += 0.37f) {
+                drawKernelPerPixel(per_pixel_gfx, kernel, t);
+                runKernel(direct_gfx, kernel, t);
+                int wrong = 0;
+                for (int i = 0; i < 32 * 32; i++) wrong += per_pixel[i] != direct[i];
+                if (wrong > kernels.max_error) kernels.max_error = wrong;
+            }
+        };
+        compare(ShaderEffectsGame::PlasmaKernel());
+        compare(ShaderEffectsGame::RainbowSpiralKernel());
+        compare(ShaderEffectsGame::FireRipplesKernel());
+        compare(ShaderEffectsGame::VortexMathKernel());
+        compare(ShaderEffectsGame::OrganicBlobsKernel());
+        compare(ShaderEffectsGame::PulsingBlobsKernel());
+        compare(ShaderEffectsGame::NebulaKernel());
+    }
+    results.push_back(kernels);
+}
+
+static void writeMicroJson(FILE* out, const std::vector<MicroResult>& results,
+                           const std::vector<AccuracyResult>& accuracy) {
+    fprintf(out, "{\n  \"micro\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const MicroResult& r = results[i];
+        fprintf(out,
+                "    {\"name\": \"%s\", \"pixels\": %llu, \"baseline_ns\": %.1f, \"fast_ns\": %.1f, "
+                "\"speedup\": %.2f}%s\n",
+                r.name, (unsigned long long)r.pixels, r.baseline_ns, r.fast_ns,
+                r.fast_ns > 0 ? r.baseline_ns / r.fast_ns : 0.0, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ],\n  \"accuracy\": [\n");
+    for (size_t i = 0; i < accuracy.size(); i++) {
+        const AccuracyResult& a = accuracy[i];
+        fprintf(out, "    {\"name\": \"%s\", \"max_error\": %.3g, \"tolerance\": %.3g, \"pass\": %s}%s\n",
+                a.name, a.max_error, a.tolerance, a.max_error <= a.tolerance ? "true" : "false",
+                i + 1 < accuracy.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static BenchmarkResult runBenchmark(const BenchmarkGame& entry, int variant, const BenchmarkOptions& options,
+                                    PicoGraphics_PenRGB888& graphics, CosmicUnicorn& unicorn) {
+    // Same seed and clock for every case so runs are comparable
+    srand(1);
+    host_time_us = 0;
+    hostSetButtons(0);
+
+    std::unique_ptr<GameBase> game = entry.create();
+    game->init(graphics, unicorn);
+    if (game->getVariantCount() > 1) {
+        game->selectVariant(variant);
+    }
+
+    BenchmarkResult result = {entry.name, game->getVariantName(variant), 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    // No byte budget, so every changed frame is encoded and counted
+    static FrameStreamEncoder stream;
+    stream.begin([](const uint8_t*, size_t, void*) {});
+
+    FrameRates rates = game->getFrameRates();
+    uint32_t update_period_us = 1000000 / (rates.update_hz > 0 ? rates.update_hz : 1);
+    game->setFrameTime(update_period_us / 1000000.0f);
+
+    for (int frame = -options.warmup; frame < options.frames; frame++) {
+        hostAdvanceUs(update_period_us);
+
+        uint64_t allocations_before = allocation_count;
+        uint64_t bytes_before = allocation_bytes;
+        uint64_t start = nowNs();
+        bool running = game->update();
+        uint64_t mid = nowNs();
+        game->render(graphics);
+        uint64_t end = nowNs();
+        uint64_t stream_bytes_before = stream.getByteCount();
+        stream.encodeFrame((const uint32_t*)graphics.frame_buffer, host_time_us);
+        uint64_t streamed = nowNs();
+
+        if (frame >= 0) {
+            result.frames++;
+            result.update_ns += mid - start;
+            result.render_ns += end - mid;
+            if (end - start > result.max_frame_ns) result.max_frame_ns = end - start;
+            result.allocations += allocation_count - allocations_before;
+            result.allocated_bytes += allocation_bytes - bytes_before;
+            result.stream_ns += streamed - end;
+            if (streamed - end > result.max_stream_ns) result.max_stream_ns = streamed - end;
+            result.stream_bytes += stream.getByteCount() - stream_bytes_before;
+        }
+        if (!running) break;
+    }
+
+    game->cleanup();
+    return result;
+}
+
+static void writeJson(FILE* out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    fprintf(out, "{\n  \"frames\": %d,\n  \"warmup\": %d,\n  \"results\": [\n", options.frames, options.warmup);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchmarkResult& r = results[i];
+        double frames = r.frames ? (double)r.frames : 1.0;
+        double frame_ns = (r.update_ns + r.render_ns) / frames;
+        fprintf(out,
+                "    {\"game\": \"%s\", \"variant\": \"%s\", \"frames\": %d, "
+                "\"update_ns_per_frame\": %.0f, \"render_ns_per_frame\": %.0f, \"max_frame_ns\": %llu, "
+                "\"fps\": %.0f, \"allocs_per_frame\": %.2f, \"alloc_bytes_per_frame\": %.1f, "
+                "\"stream_ns_per_frame\": %.0f, \"max_stream_ns\": %llu, \"stream_bytes_per_frame\": %.1f}%s\n",
+                r.game, r.variant.c_str(), r.frames, r.update_ns / frames, r.render_ns / frames,
+                (unsigned long long)r.max_frame_ns, frame_ns > 0 ? 1e9 / frame_ns : 0.0,
+                r.allocations / frames, r.allocated_bytes / frames, r.stream_ns / frames,
+                (unsigned long long)r.max_stream_ns, r.stream_bytes / frames, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static bool parseBenchmarkOptions(int argc, char** argv, BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            options.frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && has_value) {
+            options.warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--game") == 0 && has_value) {
+            options.only_game = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && has_value) {
+            options.out_path = argv[++i];
+        } else if (strcmp(argv[i], "--micro") == 0) {
+            options.micro = true;
+        } else if (strcmp(argv[i], "--iterations") == 0 && has_value) {
+            options.micro_iterations = atoi(argv[++i]);
+        } else {
+            printf("Usage: %s [--frames N] [--warmup N] [--game NAME] [--out FILE (benchmark.json)]\n"
+                   "       %s --micro [--iterations N] [--out FILE]\n", argv[0], argv[0]);
+            return false;
+        }
+    }
+    if (options.frames < 1) options.frames = 1;
+    if (options.warmup < 0) options.warmup = 0;
+    if (options.micro_iterations < 1) options.micro_iterations = 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    if (!parseBenchmarkOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    static uint32_t framebuffer[CosmicUnicorn::WIDTH * CosmicUnicorn::HEIGHT];
+    PicoGraphics_PenRGB888 graphics(CosmicUnicorn::WIDTH, CosmicUnicorn::HEIGHT, framebuffer);
+    CosmicUnicorn unicorn;
+    unicorn.init();
+
+    if (options.micro) {
+        std::vector<MicroResult> micro_results;
+        runSpanBenchmarks(graphics, options.micro_iterations, micro_results);
+        runFixedBenchmarks(graphics, options.micro_iterations / 10 + 1, micro_results);
+        runFastMathBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runColorBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runPolarBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runCompositorBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runSpriteAtlasBenchmarks(graphics, options.micro_iterations / 10 + 1, micro_results);
+        runBlendBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runDeepFrameBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        runTextBenchmarks(graphics, options.micro_iterations / 10 + 1, micro_results);
+        runShaderBenchmarks(graphics, options.micro_iterations / 40 + 1, micro_results);
+        for (const MicroResult& r : micro_results) {
+            printf("%-24s baseline %9.1f ns  fast %9.1f ns  %5.2fx\n", r.name, r.baseline_ns, r.fast_ns,
+                   r.fast_ns > 0 ? r.baseline_ns / r.fast_ns : 0.0);
+        }
+
+        std::vector<AccuracyResult> accuracy;
+        runMathAccuracy(accuracy);
+        bool accurate = true;
+        for (const AccuracyResult& a : accuracy) {
+            bool pass = a.max_error <= a.tolerance;
+            printf("%-24s max error %.3g (tolerance %.3g)%s\n", a.name, a.max_error, a.tolerance, pass ? "" : "  FAIL");
+            accurate = accurate && pass;
+        }
+
+        FILE* out = fopen(options.out_path, "w");
+        if (!out) {
+            fprintf(stderr, "Can't write %s\n", options.out_path);
+            return 1;
+        }
+        writeMicroJson(out, micro_results, accuracy);
+        fclose(out);
+        printf("Wrote %zu results to %s\n", micro_results.size(), options.out_path);
+        return accurate ? 0 : 1;
+    }
+
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkGame& entry : benchmark_games) {
+        if (options.only_game && strcmp(options.only_game, entry.name) != 0) continue;
+
+        // Ask a throwaway instance how many variants there are
+        int variants = entry.create()->getVariantCount();
+        for (int variant = 0; variant < variants; variant++) {
+            BenchmarkResult result = runBenchmark(entry, variant, options, graphics, unicorn);
+            double frames = result.frames ? (double)result.frames : 1.0;
+            printf("%-7s %-16s update %9.0f ns  render %9.0f ns  %6.2f allocs/frame  stream %6.0f ns %6.0f B/frame\n",
+                    result.game, result.variant.c_str(), result.update_ns / frames,
+                    result.render_ns / frames, result.allocations / frames, result.stream_ns / frames,
+                    result.stream_bytes / frames);
+            results.push_back(result);
+        }
+    }
+
+    FILE* out = fopen(options.out_path, "w");
+    if (!out) {
+        fprintf(stderr, "Can't write %s\n", options.out_path);
+        return 1;
+    }
+    writeJson(out, options, results);
+    fclose(out);
+    printf("Wrote %zu results to %s\n", results.size(), options.out_path);
+    return 0;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+
+namespace pimoroni {
+
+// Headless CosmicUnicorn: buttons come from the scripted mask in
+// host_platform.hpp and update() keeps a copy of the last frame instead of
+// driving LEDs
+class CosmicUnicorn {
+public:
+    static const int WIDTH = 32;
+    static const int HEIGHT = 32;
+
+    // Same switch numbers (GPIOs) as the real board
+    static const uint8_t SWITCH_A = 0;
+    static const uint8_t SWITCH_B = 1;
+    static const uint8_t SWITCH_C = 3;
+    static const uint8_t SWITCH_D = 6;
+    static const uint8_t SWITCH_SLEEP = 27;
+    static const uint8_t SWITCH_VOLUME_UP = 7;
+    static const uint8_t SWITCH_VOLUME_DOWN = 8;
+    static const uint8_t SWITCH_BRIGHTNESS_UP = 21;
+    static const uint8_t SWITCH_BRIGHTNESS_DOWN = 26;
+
+private:
+    uint32_t panel[WIDTH * HEIGHT];
+    float brightness = 0.5f;
+    float volume = 0.5f;
+    uint32_t frames_shown = 0;
+
+public:
+    CosmicUnicorn() {
+        clear();
+    }
+
+    void init() {}
+
+    void clear() {
+        memset(panel, 0, sizeof(panel));
+    }
+
+    void update(PicoGraphics* graphics) {
+        if (graphics->pen_type == PicoGraphics::PEN_RGB888) {
+            memcpy(panel, graphics->frame_buffer, sizeof(panel));
+        }
+        frames_shown++;
+    }
+
+    void set_pixel(int x, int y, uint8_t r, uint8_t g, uint8_t b) {
+        if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+        panel[y * WIDTH + x] = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    void set_brightness(float value) {
+        brightness = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    }
+
+    float get_brightness() { return brightness; }
+
+    void adjust_brightness(float delta) {
+        set_brightness(brightness + delta);
+    }
+
+    void set_volume(float value) {
+        volume = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    }
+
+    float get_volume() { return volume; }
+
+    void adjust_volume(float delta) {
+        set_volume(volume + delta);
+    }
+
+    uint16_t light() { return 0; }
+
+    bool is_pressed(uint8_t button) {
+        return hostButtonPressed(button);
+    }
+
+    const uint32_t* getPanel() const { return panel; }
+    uint32_t getFramesShown() const { return frames_shown; }
+};
+
+}
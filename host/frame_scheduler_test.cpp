@@ -0,0 +1,224 @@
+// FrameScheduler (frame_scheduler.hpp) driven by FakeFrameClock: each tick
+// sleeps to its deadline, advance_us() stands in for the frame's work, and
+// the checks below pin down the pacing policy. Exits with 1 on any failure.
+//
+//   ./build-host/frame_scheduler_test
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "frame_scheduler.hpp"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAIL %s\n", what);
+        failures++;
+    }
+}
+
+// One pass of the launcher's main loop, with work_us spent in it
+static uint32_t tick(FrameScheduler<FakeFrameClock>& scheduler, FakeFrameClock& clock, uint64_t work_us) {
+    uint32_t updates = scheduler.waitForNextFrame();
+    clock.advance_us(work_us);
+    scheduler.endFrame();
+    return updates;
+}
+
+// Deadlines are start + n * period, however long each frame's work took
+static void testDeadlinesDontDrift() {
+    FakeFrameClock clock;
+    clock.now = 1000;
+    FrameScheduler<FakeFrameClock> scheduler(clock, 20);
+
+    srand(1);
+    bool on_deadline = true, one_update = true, rendered = true;
+    for (int n = 0; n < 1000; n++) {
+        uint32_t updates = scheduler.waitForNextFrame();
+        on_deadline = on_deadline && clock.now == 1000 + (uint64_t)n * 50000;
+        one_update = one_update && updates == 1;
+        rendered = rendered && scheduler.renderDue();
+        clock.advance_us(rand() % 49000);
+        scheduler.endFrame();
+    }
+    check(on_deadline, "every frame starts on start + n * period");
+    check(one_update, "a frame that fits runs exactly one update");
+    check(rendered, "a frame that fits renders");
+    check(scheduler.getStats().overruns == 0, "no overruns when every frame fits");
+}
+
+// An overrun runs the updates it owes but renders only once for them
+static void testOverrunKeepsUpdatesSkipsRenders() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock, 20);
+
+    tick(scheduler, clock, 120000);  // 2.4 periods
+    check(scheduler.getStats().overruns == 1, "a frame past the next deadline counts as an overrun");
+
+    uint32_t updates = scheduler.waitForNextFrame();
+    check(updates == 2, "an overrun runs both updates whose deadlines passed");
+    check(scheduler.renderDue(), "one render after an overrun");
+    check(scheduler.getStats().skipped_renders == 1, "the render deadline that passed is skipped");
+    check(scheduler.getStats().dropped_updates == 0, "no updates dropped within the catch-up limit");
+    scheduler.endFrame();
+
+    scheduler.waitForNextFrame();
+    check(clock.now == 150000, "after an overrun the next deadline is still on the original grid");
+}
+
+// Past the catch-up limit the rest are dropped, counted, and pacing restarts
+static void testCatchUpIsCapped() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock, 20);
+
+    tick(scheduler, clock, 400000);  // 8 periods
+    uint32_t updates = scheduler.waitForNextFrame();
+    check(updates == 4, "catch-up is capped at four updates");
+    check(scheduler.getStats().dropped_updates == 4, "the updates past the cap are counted as dropped");
+    check(scheduler.getStats().updates == 5, "only the updates handed out are counted as run");
+    scheduler.endFrame();
+
+    updates = scheduler.waitForNextFrame();
+    check(updates == 1, "after dropping updates there is no further burst");
+    check(clock.now == 450000, "after dropping updates deadlines restart from the late frame");
+}
+
+// A rate change applies from the very next deadline, without a burst
+static void testRateChangesTakeEffectNextDeadline() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock, 20);
+
+    tick(scheduler, clock, 10000);
+    tick(scheduler, clock, 10000);  // Now 60000, next deadline 100000
+
+    scheduler.setTargetFps(50);
+    check(scheduler.getUpdatePeriodUs() == 20000, "setTargetFps sets the period");
+    uint32_t updates = scheduler.waitForNextFrame();
+    check(updates == 1, "setTargetFps doesn't cause catch-up updates");
+    check(clock.now == 80000, "setTargetFps's first deadline is one new period after the change");
+    clock.advance_us(5000);
+    scheduler.endFrame();
+    scheduler.waitForNextFrame();
+    check(clock.now == 100000, "setTargetFps's deadlines follow the new period");
+    scheduler.endFrame();
+
+    // 25 Hz updates, 5 Hz renders: a render every fifth update
+    scheduler.setRates({25, 25, 5, 5});
+    check(scheduler.getUpdatePeriodUs() == 40000 && scheduler.getRenderPeriodUs() == 200000,
+          "setRates sets both periods");
+    uint32_t renders = 0, total_updates = 0;
+    bool on_deadline = true;
+    for (int n = 1; n <= 20; n++) {
+        total_updates += scheduler.waitForNextFrame();
+        on_deadline = on_deadline && clock.now == 100000 + (uint64_t)n * 40000;
+        if (scheduler.renderDue()) renders++;
+        clock.advance_us(1000);
+        scheduler.endFrame();
+    }
+    check(on_deadline, "setRates's deadlines start one new period after the change");
+    check(total_updates == 20, "setRates runs one update per new period");
+    check(renders == 4, "setRates renders at the render rate");
+    check(scheduler.getStats().skipped_renders == 0, "renders below the update rate aren't skipped renders");
+}
+
+// Sustained overruns lower the render rate to its minimum before touching
+// the update rate, and neither goes below its minimum
+static void testLoadLowersRenderRateFirst() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock);
+    scheduler.setRates({50, 25, 25, 10});  // Updates 20..40 ms, renders 40..100 ms
+
+    tick(scheduler, clock, 1000);
+    tick(scheduler, clock, 60000);
+    tick(scheduler, clock, 60000);
+    check(scheduler.getStats().rate_reductions == 0 && scheduler.getRenderPeriodUs() == 40000,
+          "two late ticks in a row don't lower a rate");
+    tick(scheduler, clock, 60000);
+    check(scheduler.getStats().rate_reductions == 1 && scheduler.getRenderPeriodUs() == 50000,
+          "the third late tick in a row lowers the render rate by a quarter of its period");
+    check(scheduler.getUpdatePeriodUs() == 20000, "the update rate is kept while renders can still be shed");
+
+    bool update_kept = true, within_limits = true;
+    for (int n = 0; n < 200; n++) {
+        tick(scheduler, clock, 60000);
+        if (scheduler.getRenderPeriodUs() < 100000 && scheduler.getUpdatePeriodUs() != 20000) update_kept = false;
+        if (scheduler.getUpdatePeriodUs() > 40000 || scheduler.getRenderPeriodUs() > 100000) within_limits = false;
+    }
+    check(update_kept, "the update rate is lowered only once renders are at their minimum rate");
+    check(within_limits, "rates are never lowered past min_update_hz and min_render_hz");
+    check(scheduler.getUpdatePeriodUs() == 40000 && scheduler.getRenderPeriodUs() == 100000,
+          "sustained overruns end at both minimum rates");
+    // Renders 40 -> 50 -> 62.5 -> 78.1 -> 97.7 -> 100 ms, updates 20 -> 25 -> 31.3 -> 39.1 -> 40 ms
+    check(scheduler.getStats().rate_reductions == 9, "rate_reductions counts each step that lowered a rate");
+}
+
+// Once frames fit for two seconds the rates step back up, updates first,
+// until both are at the preferred rates again
+static void testRecoveryRestoresPreferredRates() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock);
+    scheduler.setRates({50, 25, 25, 10});
+    for (int n = 0; n < 200; n++) tick(scheduler, clock, 60000);
+    uint32_t reductions = scheduler.getStats().rate_reductions;
+
+    // One on-time tick between late ones starts the late count again
+    tick(scheduler, clock, 1000);
+    tick(scheduler, clock, 60000);
+    tick(scheduler, clock, 60000);
+
+    // Two seconds of on-time ticks is 50 at the slowed 40 ms update period
+    int first_raise = 0;
+    bool render_kept = true;
+    for (int n = 1; n <= 2000; n++) {
+        tick(scheduler, clock, 1000);
+        if (first_raise == 0 && scheduler.getUpdatePeriodUs() != 40000) first_raise = n;
+        if (scheduler.getUpdatePeriodUs() > 20000 && scheduler.getRenderPeriodUs() != 100000) render_kept = false;
+    }
+    check(first_raise == 50, "the first rate is raised after two seconds on time");
+    check(render_kept, "the update rate is restored before the render rate");
+    check(scheduler.getUpdatePeriodUs() == 20000 && scheduler.getRenderPeriodUs() == 40000,
+          "frames that fit return both rates to the preferred ones");
+    check(scheduler.getStats().rate_reductions == reductions,
+          "raising rates and broken runs of late ticks aren't counted as reductions");
+}
+
+// When the update rate drops below the render rate, renders follow it down
+// and stay there until updates are fast enough again
+static void testRenderRateNeverPassesUpdateRate() {
+    FakeFrameClock clock;
+    FrameScheduler<FakeFrameClock> scheduler(clock);
+    scheduler.setRates({50, 10, 50, 25});  // Updates 20..100 ms, renders 20..40 ms
+
+    bool clamped = true;
+    for (int n = 0; n < 200; n++) {
+        tick(scheduler, clock, 250000);
+        if (scheduler.getRenderPeriodUs() < scheduler.getUpdatePeriodUs()) clamped = false;
+    }
+    check(scheduler.getUpdatePeriodUs() == 100000, "updates slow to min_update_hz");
+    check(scheduler.getRenderPeriodUs() == 100000, "renders follow updates below min_render_hz");
+    for (int n = 0; n < 2000; n++) {
+        tick(scheduler, clock, 1000);
+        if (scheduler.getRenderPeriodUs() < scheduler.getUpdatePeriodUs()) clamped = false;
+    }
+    check(clamped, "the render period is never shorter than the update period");
+    check(scheduler.getUpdatePeriodUs() == 20000 && scheduler.getRenderPeriodUs() == 20000,
+          "recovery after clamping returns both rates to the preferred ones");
+}
+
+int main() {
+    testDeadlinesDontDrift();
+    testOverrunKeepsUpdatesSkipsRenders();
+    testCatchUpIsCapped();
+    testRateChangesTakeEffectNextDeadline();
+    testLoadLowersRenderRateFirst();
+    testRecoveryRestoresPreferredRates();
+    testRenderRateNeverPassesUpdateRate();
+
+    if (failures) {
+        printf("%d frame scheduler checks failed\n", failures);
+        return 1;
+    }
+    printf("Frame scheduler checks passed\n");
+    return 0;
+}
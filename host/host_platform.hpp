@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+
+// State behind the host shims. Game code sees a fake clock that only moves
+// when the host runner (or a sleep) advances it, so every run sees the same
+// timeline however fast the desktop is. Real elapsed time, for measuring
+// cost, comes from hostWallTimeUs().
+
+inline uint64_t host_time_us = 0;
+inline uint32_t host_buttons = 0;  // One bit per CosmicUnicorn switch number
+
+inline uint64_t hostNowUs() {
+    return host_time_us;
+}
+
+inline void hostAdvanceUs(uint64_t us) {
+    host_time_us += us;
+}
+
+inline uint64_t hostWallTimeUs() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+inline void hostSetButtons(uint32_t mask) {
+    host_buttons = mask;
+}
+
+inline bool hostButtonPressed(uint8_t switch_number) {
+    return switch_number < 32 && (host_buttons & (1u << switch_number)) != 0;
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+// Headless driver for the host build (cosmic_launcher_host). Included at the
+// bottom of cosmic_launcher.cpp in place of the device main(), so it drives
+// the real launcher state machine, menu and games. Each game is picked from
+// the menu with scripted button presses, run for a fixed number of frames
+// on the fake clock as fast as the CPU allows, then exited. Wall-clock cost
+// of update and render is printed per game, and frames can be dumped as PPM.
+// Runs can be recorded to an input stream and replayed (input_recorder.hpp);
+// the frame hash printed at the end matches between the two. The presented
+// frames can be saved as a frame stream (frame_stream.hpp).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <string>
+
+#include "host_platform.hpp"
+
+struct HostRunOptions {
+    int frames_per_game = 600;
+    const char* only_game = nullptr;   // Run just this menu entry
+    const char* ppm_dir = nullptr;     // Dump frames here when set
+    int ppm_every = 1;
+    const char* script_path = nullptr;
+    const char* record_path = nullptr;
+    const char* replay_path = nullptr;
+    const char* stream_path = nullptr;
+};
+
+// FNV-1a over every presented frame, to check replays are bit-identical
+static uint64_t host_frame_hash = 1469598103934665603ull;
+static uint32_t host_frame_count = 0;
+
+static void hashFrame(const uint32_t* pixels) {
+    const uint8_t* bytes = (const uint8_t*)pixels;
+    for (size_t i = 0; i < CosmicUnicorn::WIDTH * CosmicUnicorn::HEIGHT * sizeof(uint32_t); i++) {
+        host_frame_hash = (host_frame_hash ^ bytes[i]) * 1099511628211ull;
+    }
+    host_frame_count++;
+}
+
+static void writeRecording(const uint8_t* data, size_t length, void* context) {
+    fwrite(data, 1, length, (FILE*)context);
+}
+
+static bool loadFile(const char* path, std::vector<uint8_t>& contents) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + got);
+    }
+    fclose(file);
+    return true;
+}
+
+// Button script: "<frame> <buttons>" per line, applied from that frame of each
+// game until the next line. Buttons are letters - A B C D, U/V for volume
+// up/down, +/- for brightness up/down - or "." for none. '#' starts a comment.
+struct ScriptStep {
+    int frame;
+    uint32_t mask;
+};
+
+static uint32_t buttonBit(uint8_t switch_number) {
+    return 1u << switch_number;
+}
+
+static bool loadButtonScript(const char* path, std::vector<ScriptStep>& steps) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "Can't open script %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+
+        int frame;
+        char buttons[32];
+        if (sscanf(line, "%d %31s", &frame, buttons) != 2) continue;
+
+        uint32_t mask = 0;
+        for (const char* c = buttons; *c; c++) {
+            switch (*c) {
+                case 'A': mask |= buttonBit(CosmicUnicorn::SWITCH_A); break;
+                case 'B': mask |= buttonBit(CosmicUnicorn::SWITCH_B); break;
+                case 'C': mask |= buttonBit(CosmicUnicorn::SWITCH_C); break;
+                case 'D': mask |= buttonBit(CosmicUnicorn::SWITCH_D); break;
+                case 'U': mask |= buttonBit(CosmicUnicorn::SWITCH_VOLUME_UP); break;
+                case 'V': mask |= buttonBit(CosmicUnicorn::SWITCH_VOLUME_DOWN); break;
+                case '+': mask |= buttonBit(CosmicUnicorn::SWITCH_BRIGHTNESS_UP); break;
+                case '-': mask |= buttonBit(CosmicUnicorn::SWITCH_BRIGHTNESS_DOWN); break;
+                default: break;
+            }
+        }
+        steps.push_back({frame, mask});
+    }
+
+    fclose(file);
+    return true;
+}
+
+static uint32_t scriptMaskAt(const std::vector<ScriptStep>& steps, int frame) {
+    uint32_t mask = 0;
+    for (const ScriptStep& step : steps) {
+        if (step.frame > frame) break;
+        mask = step.mask;
+    }
+    return mask;
+}
+
+static void writePPM(const char* dir, const char* game, int frame, const uint32_t* pixels) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s_%05d.ppm", dir, game, frame);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "Can't write %s\n", path);
+        return;
+    }
+
+    fprintf(file, "P6\n%d %d\n255\n", CosmicUnicorn::WIDTH, CosmicUnicorn::HEIGHT);
+    for (int i = 0; i < CosmicUnicorn::WIDTH * CosmicUnicorn::HEIGHT; i++) {
+        uint8_t rgb[3] = {(uint8_t)(pixels[i] >> 16), (uint8_t)(pixels[i] >> 8), (uint8_t)pixels[i]};
+        fwrite(rgb, 1, 3, file);
+    }
+    fclose(file);
+}
+
+// One scheduler tick on the fake clock (waiting for the deadline just moves
+// the clock on); returns the wall time spent in update and render
+static void runHostFrame(uint32_t buttons, uint64_t& update_us, uint64_t& render_us) {
+    hostSetButtons(buttons);
+
+    uint32_t updates = frame_scheduler.waitForNextFrame();
+    uint64_t start = hostWallTimeUs();
+    for (uint32_t i = 0; i < updates; i++) {
+        updateLauncher();
+    }
+    uint64_t mid = hostWallTimeUs();
+    if (frame_scheduler.renderDue()) {
+        renderLauncher();
+    }
+    uint64_t end = hostWallTimeUs();
+    frame_scheduler.endFrame();
+
+    update_us += mid - start;
+    render_us += end - mid;
+    render_pipeline.waitUntilShown();
+    hashFrame((const uint32_t*)graphics.frame_buffer);
+}
+
+static void runHostFrame(uint32_t buttons) {
+    uint64_t update_us = 0, render_us = 0;
+    runHostFrame(buttons, update_us, render_us);
+}
+
+// Idle a few frames so the next press is seen as a fresh edge, well clear of
+// the input sampler's debounce window
+static void waitOutDebounce() {
+    for (int i = 0; i < 5; i++) runHostFrame(0);
+}
+
+static void tapButton(uint8_t switch_number) {
+    waitOutDebounce();
+    runHostFrame(buttonBit(switch_number));
+}
+
+static void closeFrameStream(FILE* file, const char* path) {
+    if (!file) return;
+#ifdef COSMIC_STREAM_FRAMES
+    frame_stream.end();
+    fclose(file);
+    printf("Streamed %lu of %lu frames to %s, %llu bytes\n", (unsigned long)frame_stream.getRecordCount(),
+           (unsigned long)frame_stream.getFrameCount(), path, (unsigned long long)frame_stream.getByteCount());
+#endif
+}
+
+// How much panel upload work damage tracking saved
+static void printHostPanelStats() {
+    uint32_t uploads = render_pipeline.getPresentedCount();
+    uint32_t unchanged = render_pipeline.getUnchangedCount();
+    printf("Panel: %lu frames, %lu unchanged (not uploaded), %lu uploads of which %lu partial, "
+           "%lu of %lu rows uploaded\n",
+           (unsigned long)host_frame_count, (unsigned long)unchanged, (unsigned long)uploads,
+           (unsigned long)render_pipeline.getPartialCount(),
+           (unsigned long)render_pipeline.getRowsUploaded(),
+           (unsigned long)(uploads * CosmicUnicorn::HEIGHT));
+}
+
+static void printHostUsage(const char* name) {
+    printf("Usage: %s [--frames N] [--game NAME] [--ppm DIR] [--ppm-every N] [--script FILE]\n"
+           "       [--record FILE | --replay FILE] [--stream FILE]\n", name);
+}
+
+static bool parseHostOptions(int argc, char** argv, HostRunOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            options.frames_per_game = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--game") == 0 && has_value) {
+            options.only_game = argv[++i];
+        } else if (strcmp(argv[i], "--ppm") == 0 && has_value) {
+            options.ppm_dir = argv[++i];
+        } else if (strcmp(argv[i], "--ppm-every") == 0 && has_value) {
+            options.ppm_every = atoi(argv[++i]);
+            if (options.ppm_every < 1) options.ppm_every = 1;
+        } else if (strcmp(argv[i], "--script") == 0 && has_value) {
+            options.script_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && has_value) {
+            options.record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && has_value) {
+            options.replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--stream") == 0 && has_value) {
+            options.stream_path = argv[++i];
+        } else {
+            printHostUsage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    HostRunOptions options;
+    if (!parseHostOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<ScriptStep> script;
+    if (options.script_path && !loadButtonScript(options.script_path, script)) {
+        return 1;
+    }
+
+    // Replaying: the stream supplies the seed, every frame's buttons and the clock
+    std::vector<uint8_t> replay_data;
+    if (options.replay_path) {
+        if (!loadFile(options.replay_path, replay_data) ||
+            !input_replay.begin(replay_data.data(), replay_data.size())) {
+            fprintf(stderr, "%s is not an input recording\n", options.replay_path);
+            return 1;
+        }
+    }
+
+    initializeLauncher();
+    render_pipeline.start(graphics, cosmic_unicorn);
+
+    // Every changed frame, no byte budget
+    FILE* stream_file = nullptr;
+    if (options.stream_path) {
+#ifdef COSMIC_STREAM_FRAMES
+        stream_file = fopen(options.stream_path, "wb");
+        if (!stream_file) {
+            fprintf(stderr, "Can't write %s\n", options.stream_path);
+            return 1;
+        }
+        frame_stream.begin(writeRecording, stream_file);
+#else
+        fprintf(stderr, "--stream needs a build with COSMIC_STREAM_FRAMES\n");
+        return 1;
+#endif
+    }
+
+    if (options.replay_path) {
+        uint64_t update_us = 0, render_us = 0;
+        while (input_replay.isActive()) {
+            runHostFrame(0, update_us, render_us);
+        }
+        printf("Replayed %lu frames  update %8.1f us/frame  render %8.1f us/frame\n",
+               (unsigned long)host_frame_count, (double)update_us / host_frame_count,
+               (double)render_us / host_frame_count);
+        printf("Frame hash %016llx\n", (unsigned long long)host_frame_hash);
+        render_pipeline.stop();
+        printHostPanelStats();
+        closeFrameStream(stream_file, options.stream_path);
+        return 0;
+    }
+
+    FILE* record_file = nullptr;
+    if (options.record_path) {
+        record_file = fopen(options.record_path, "wb");
+        if (!record_file) {
+            fprintf(stderr, "Can't write %s\n", options.record_path);
+            return 1;
+        }
+        input_recorder.begin(launcher_seed, frame_scheduler.getUpdatePeriodUs(), writeRecording, record_file);
+    }
+
+    int item_count = (int)menu.getItemCount();
+    for (int item = 0; item < item_count; item++) {
+        // Walk the menu selection down to this entry
+        while (menu.getSelectedIndex() != item) {
+            tapButton(CosmicUnicorn::SWITCH_C);
+        }
+
+        const char* name = menu.getSelectedGameName();
+        if (options.only_game && strcmp(options.only_game, name) != 0) {
+            continue;
+        }
+
+        tapButton(CosmicUnicorn::SWITCH_A);
+        if (current_state != LauncherState::PLAYING_GAME) {
+            fprintf(stderr, "%s: failed to start\n", name);
+            continue;
+        }
+
+        uint64_t update_us = 0, render_us = 0;
+        int frames = 0;
+        while (frames < options.frames_per_game && current_state == LauncherState::PLAYING_GAME) {
+            runHostFrame(scriptMaskAt(script, frames), update_us, render_us);
+
+            // After present() graphics holds a copy of the frame just finished
+            if (options.ppm_dir && frames % options.ppm_every == 0) {
+                writePPM(options.ppm_dir, name, frames, (const uint32_t*)graphics.frame_buffer);
+            }
+            frames++;
+        }
+
+        // Leave the way a player would, holding D, so a recording of this run
+        // replays the exit too. Forcing the state is a last resort.
+        uint64_t hold_until_us = hostNowUs() + 2000000;
+        while (hostNowUs() < hold_until_us && current_state == LauncherState::PLAYING_GAME) {
+            runHostFrame(buttonBit(CosmicUnicorn::SWITCH_D));
+        }
+        if (current_state == LauncherState::PLAYING_GAME) {
+            fprintf(stderr, "%s: didn't exit on a long D press\n", name);
+            current_state = LauncherState::EXITING_GAME;
+        }
+        runHostFrame(0);
+
+        printf("%-8s %6d frames  update %8.1f us/frame  render %8.1f us/frame\n", name, frames,
+               frames ? (double)update_us / frames : 0.0, frames ? (double)render_us / frames : 0.0);
+    }
+
+    if (record_file) {
+        input_recorder.end();
+        fclose(record_file);
+        printf("Recorded %lu frames to %s\n", (unsigned long)input_recorder.getFrameCount(), options.record_path);
+    }
+    printf("Frame hash %016llx\n", (unsigned long long)host_frame_hash);
+
+    render_pipeline.stop();
+    printHostPanelStats();
+    closeFrameStream(stream_file, options.stream_path);
+    return 0;
+}
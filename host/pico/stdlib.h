@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-in for the parts of the Pico SDK the launcher and pimoroni's
+// graphics library use, backed by the fake clock in host_platform.hpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../host_platform.hpp"
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+inline bool stdio_init_all() { return true; }
+inline void tight_loop_contents() {}
+
+inline uint64_t time_us_64() { return hostNowUs(); }
+inline uint32_t time_us_32() { return (uint32_t)hostNowUs(); }
+
+inline absolute_time_t get_absolute_time() { return hostNowUs(); }
+inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+inline absolute_time_t make_timeout_time_us(uint64_t us) { return hostNowUs() + us; }
+inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return hostNowUs() + (uint64_t)ms * 1000; }
+inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+// Sleeping just moves the fake clock on
+inline void sleep_until(absolute_time_t t) {
+    if (t > hostNowUs()) hostAdvanceUs(t - hostNowUs());
+}
+inline void sleep_us(uint64_t us) { hostAdvanceUs(us); }
+inline void sleep_ms(uint32_t ms) { hostAdvanceUs((uint64_t)ms * 1000); }
+inline void busy_wait_us(uint64_t us) { hostAdvanceUs(us); }
@@ -0,0 +1,153 @@
+// RenderPipeline (render_pipeline.hpp) under load: core 0's present() runs
+// against the present thread for thousands of frames, each side doing a
+// random amount of work per frame so every interleaving gets a turn. Every
+// row a frame draws is stamped with that frame's number, and after each
+// upload the present thread checks the panel against the rows the frame
+// should hold. Exits with 1 on any failure.
+//
+//   ./build-host/render_pipeline_test
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <random>
+#include <thread>
+
+#include "pico/stdlib.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "cosmic_unicorn.hpp"
+#include "render_pipeline.hpp"
+
+using namespace pimoroni;
+
+static const int FRAMES = 20000;
+static const int WIDTH = RenderPipeline::WIDTH;
+static const int HEIGHT = RenderPipeline::HEIGHT;
+
+// What a pixel of a row last drawn by frame n holds
+static uint32_t stamp(uint32_t n, int x) {
+    return (n * WIDTH + x) & 0xffffff;
+}
+
+// Core 0 writes the entry for a frame before handing it over, and core 1
+// reads it after; core 1 is never more than one frame behind, so a few
+// entries are enough
+struct ExpectedFrame {
+    uint32_t row_stamps[HEIGHT];  // The frame that last drew each row
+};
+
+struct StressState {
+    ExpectedFrame expected[8];
+
+    // Present thread only
+    std::mt19937 core1_random{2};
+    uint32_t last_frame = 0;
+    uint32_t uploads = 0;
+    uint32_t torn_frames = 0;
+    uint32_t backward_frames = 0;
+};
+
+static thread_local volatile uint32_t work_sink = 0;
+
+// Usually short, now and then long enough for the other side to get ahead.
+// Sometimes it gives up the CPU, so the threads interleave on a single core.
+static void busyWork(std::mt19937& random, uint32_t max_steps) {
+    uint32_t steps = random() % (random() % 8 == 0 ? max_steps * 8 : max_steps);
+    for (uint32_t i = 0; i < steps; i++) work_sink = work_sink + i;
+    if (random() % 2 == 0) std::this_thread::yield();
+}
+
+static void checkUpload(void* context, uint32_t frame, const uint32_t* panel) {
+    StressState& state = *(StressState*)context;
+    if (frame <= state.last_frame) state.backward_frames++;
+    state.last_frame = frame;
+    state.uploads++;
+
+    const ExpectedFrame& expected = state.expected[frame & 7];
+    bool torn = false;
+    for (int y = 0; y < HEIGHT && !torn; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            if (panel[y * WIDTH + x] != stamp(expected.row_stamps[y], x)) {
+                torn = true;
+                break;
+            }
+        }
+    }
+    if (torn) state.torn_frames++;
+
+    busyWork(state.core1_random, 500);
+}
+
+int main() {
+    static RenderPipeline pipeline;
+    static CosmicUnicorn unicorn;
+    static StressState state;
+    PicoGraphics_PenRGB888 graphics(WIDTH, HEIGHT, pipeline.getBackBuffer());
+
+    pipeline.setUploadObserver(checkUpload, &state);
+    pipeline.start(graphics, unicorn);
+
+    std::mt19937 random(1);
+    // Rows no frame has drawn yet hold frame 0's stamp
+    uint32_t row_stamps[HEIGHT] = {};
+    for (int y = 0; y < HEIGHT; y++) {
+        uint32_t* row = (uint32_t*)graphics.frame_buffer + y * WIDTH;
+        for (int x = 0; x < WIDTH; x++) row[x] = stamp(0, x);
+    }
+
+    // Frame numbers as the pipeline counts them: only frames handed over
+    uint32_t handed_over = 0;
+    for (uint32_t n = 1; n <= (uint32_t)FRAMES; n++) {
+        // Some frames draw nothing; the rest redraw a random band of rows
+        if (random() % 4 != 0) {
+            int first = random() % HEIGHT;
+            int last = first + random() % (HEIGHT - first);
+            for (int y = first; y <= last; y++) {
+                uint32_t* row = (uint32_t*)graphics.frame_buffer + y * WIDTH;
+                for (int x = 0; x < WIDTH; x++) row[x] = stamp(n, x);
+                row_stamps[y] = n;
+            }
+        }
+        // A brightness change forces a full upload
+        if (random() % 64 == 0) unicorn.set_brightness((random() % 100) / 100.0f);
+        busyWork(random, 4000);
+
+        memcpy(state.expected[(handed_over + 1) & 7].row_stamps, row_stamps, sizeof(row_stamps));
+        uint32_t unchanged_before = pipeline.getUnchangedCount();
+        pipeline.present();
+        if (pipeline.getUnchangedCount() == unchanged_before) handed_over++;
+    }
+
+    pipeline.waitUntilShown();
+    pipeline.stop();
+
+    int failures = 0;
+    auto check = [&](bool condition, const char* what) {
+        if (!condition) {
+            printf("FAIL %s\n", what);
+            failures++;
+        }
+    };
+    uint32_t presented = pipeline.getPresentedCount();
+    uint32_t skipped = pipeline.getSkippedCount();
+    uint32_t unchanged = pipeline.getUnchangedCount();
+    printf("%d frames: %lu presented (%lu partial), %lu skipped, %lu unchanged\n", FRAMES,
+           (unsigned long)presented, (unsigned long)pipeline.getPartialCount(),
+           (unsigned long)skipped, (unsigned long)unchanged);
+
+    check(state.torn_frames == 0, "every upload leaves the panel showing exactly one frame");
+    check(state.backward_frames == 0, "uploads only move forward");
+    check(state.uploads == presented, "every presented frame is uploaded once");
+    check(presented + skipped + unchanged == (uint32_t)FRAMES,
+          "presented + skipped + unchanged accounts for every frame drawn");
+    check(state.last_frame == handed_over, "the last frame handed over is the last one shown");
+    check(pipeline.getPartialCount() > 0 && unchanged > 0, "the run covered partial uploads and unchanged frames");
+
+    if (failures) {
+        printf("%d render pipeline checks failed\n", failures);
+        return 1;
+    }
+    printf("Render pipeline checks passed\n");
+    return 0;
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// IEEE single precision in integer code, for timing float against fix16 on
+// the host as the RP2040 sees it: its M0+ has no FPU, so every float
+// operation in the games is a call into a soft-float routine. The host's
+// own floats are one FPU instruction each and make fix16 look slow.
+//
+// Rounded to nearest even, as the RP2040's ROM routines are, and like them
+// subnormal inputs and results are flushed to zero. Otherwise results match
+// the host's float to the bit (benchmark --micro checks this).
+class SoftFloat {
+public:
+    SoftFloat() = default;
+    SoftFloat(float f) { memcpy(&bits, &f, sizeof(bits)); }
+    SoftFloat(int i) : bits(fromInt(i)) {}
+
+    static SoftFloat fromBits(uint32_t b) {
+        SoftFloat f;
+        f.bits = b;
+        return f;
+    }
+
+    uint32_t raw() const { return bits; }
+
+    float toFloat() const {
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // Truncated towards zero; out of range saturates
+    int toInt() const {
+        uint32_t magnitude = bits & ABS_MASK;
+        int exponent = (int)(magnitude >> 23) - 127;
+        if (exponent < 0) return 0;
+        if (exponent > 30) return (bits & SIGN) ? INT32_MIN : INT32_MAX;
+        uint32_t sig = (magnitude & FRACTION) | IMPLICIT;
+        int value = (int)(exponent >= 23 ? sig << (exponent - 23) : sig >> (23 - exponent));
+        return (bits & SIGN) ? -value : value;
+    }
+
+    SoftFloat operator-() const { return fromBits(bits ^ SIGN); }
+
+    friend SoftFloat operator+(SoftFloat a, SoftFloat b) { return fromBits(add(a.bits, b.bits)); }
+    friend SoftFloat operator-(SoftFloat a, SoftFloat b) { return fromBits(add(a.bits, b.bits ^ SIGN)); }
+    friend SoftFloat operator*(SoftFloat a, SoftFloat b) { return fromBits(mul(a.bits, b.bits)); }
+    friend SoftFloat operator/(SoftFloat a, SoftFloat b) { return fromBits(div(a.bits, b.bits)); }
+
+    SoftFloat& operator+=(SoftFloat b) { return *this = *this + b; }
+    SoftFloat& operator-=(SoftFloat b) { return *this = *this - b; }
+    SoftFloat& operator*=(SoftFloat b) { return *this = *this * b; }
+    SoftFloat& operator/=(SoftFloat b) { return *this = *this / b; }
+
+    // NaN compares false with everything
+    friend bool operator<(SoftFloat a, SoftFloat b) { return ordered(a, b) && key(a.bits) < key(b.bits); }
+    friend bool operator>(SoftFloat a, SoftFloat b) { return b < a; }
+    friend bool operator<=(SoftFloat a, SoftFloat b) { return ordered(a, b) && key(a.bits) <= key(b.bits); }
+    friend bool operator>=(SoftFloat a, SoftFloat b) { return b <= a; }
+    friend bool operator==(SoftFloat a, SoftFloat b) { return ordered(a, b) && key(a.bits) == key(b.bits); }
+    friend bool operator!=(SoftFloat a, SoftFloat b) { return !(a == b); }
+
+    friend SoftFloat softSqrt(SoftFloat a) { return fromBits(sqrt(a.bits)); }
+
+private:
+    static constexpr uint32_t SIGN = 0x80000000u;
+    static constexpr uint32_t ABS_MASK = 0x7fffffffu;
+    static constexpr uint32_t INFINITY_BITS = 0x7f800000u;
+    static constexpr uint32_t QUIET_NAN = 0x7fc00000u;
+    static constexpr uint32_t IMPLICIT = 0x00800000u;
+    static constexpr uint32_t FRACTION = 0x007fffffu;
+
+    uint32_t bits = 0;
+
+    static bool isNan(uint32_t b) { return (b & ABS_MASK) > INFINITY_BITS; }
+    static bool ordered(SoftFloat a, SoftFloat b) { return !isNan(a.bits) && !isNan(b.bits); }
+
+    // Subnormals become a zero of the same sign
+    static uint32_t flush(uint32_t b) { return (b & ABS_MASK) < IMPLICIT ? b & SIGN : b; }
+
+    // Sign-magnitude to an int that orders like the value, both zeros equal
+    static int32_t key(uint32_t b) {
+        b = flush(b);
+        int32_t magnitude = (int32_t)(b & ABS_MASK);
+        return (b & SIGN) ? -magnitude : magnitude;
+    }
+
+    static uint32_t fromInt(int i) {
+        if (i == 0) return 0;
+        uint32_t sign = i < 0 ? SIGN : 0;
+        uint32_t magnitude = i < 0 ? 0u - (uint32_t)i : (uint32_t)i;
+        int top = 31 - __builtin_clz(magnitude);
+        if (top <= 23) return sign | (uint32_t)(top + 127) << 23 | ((magnitude << (23 - top)) & FRACTION);
+        // More than 24 bits: round away the low ones
+        int drop = top - 23;
+        uint32_t sig = magnitude >> drop, rest = magnitude & ((1u << drop) - 1), half = 1u << (drop - 1);
+        uint32_t result = sign | (uint32_t)(top + 127) << 23 | (sig & FRACTION);
+        if (rest > half || (rest == half && (sig & 1))) result++;
+        return result;
+    }
+
+    // exponent is biased; sig holds 1.23 in bits 26..3 with guard, round and
+    // sticky bits below. Rounds to nearest even, flushing underflow to zero.
+    static uint32_t pack(uint32_t sign, int exponent, uint32_t sig) {
+        if (exponent >= 0xff) return sign | INFINITY_BITS;
+        if (exponent <= 0) return sign;
+        uint32_t result = sign | (uint32_t)exponent << 23 | ((sig >> 3) & FRACTION);
+        uint32_t round = sig & 7;
+        if (round > 4 || (round == 4 && (result & 1))) result++;  // May carry into infinity
+        if ((result & ABS_MASK) < IMPLICIT) return sign;
+        return result;
+    }
+
+    // Shift right, keeping any bits shifted out as a sticky low bit
+    static uint32_t shiftSticky(uint32_t value, int shift) {
+        if (shift == 0) return value;
+        if (shift >= 32) return value != 0;
+        return (value >> shift) | ((value << (32 - shift)) != 0);
+    }
+
+    static uint32_t add(uint32_t a, uint32_t b) {
+        a = flush(a);
+        b = flush(b);
+        uint32_t a_abs = a & ABS_MASK, b_abs = b & ABS_MASK;
+
+        if (a_abs >= INFINITY_BITS || b_abs >= INFINITY_BITS) {
+            if (isNan(a) || isNan(b)) return QUIET_NAN;
+            if (a_abs == INFINITY_BITS && b_abs == INFINITY_BITS && (a ^ b) == SIGN) return QUIET_NAN;
+            return a_abs == INFINITY_BITS ? a : b;
+        }
+        if (a_abs == 0) return b_abs == 0 ? (a & b) : b;
+        if (b_abs == 0) return a;
+
+        // Larger magnitude first; its sign wins
+        if (a_abs < b_abs) {
+            uint32_t t = a;
+            a = b;
+            b = t;
+            a_abs = a & ABS_MASK;
+            b_abs = b & ABS_MASK;
+        }
+        int a_exp = (int)(a_abs >> 23), b_exp = (int)(b_abs >> 23);
+        uint32_t a_sig = ((a & FRACTION) | IMPLICIT) << 3;
+        uint32_t b_sig = shiftSticky(((b & FRACTION) | IMPLICIT) << 3, a_exp - b_exp);
+
+        if ((a ^ b) & SIGN) {
+            a_sig -= b_sig;
+            if (a_sig == 0) return 0;
+            // Renormalise after cancellation
+            int shift = __builtin_clz(a_sig) - __builtin_clz(IMPLICIT << 3);
+            a_sig <<= shift;
+            a_exp -= shift;
+        } else {
+            a_sig += b_sig;
+            if (a_sig & (IMPLICIT << 4)) {
+                a_sig = shiftSticky(a_sig, 1);
+                a_exp++;
+            }
+        }
+        return pack(a & SIGN, a_exp, a_sig);
+    }
+
+    static uint32_t mul(uint32_t a, uint32_t b) {
+        a = flush(a);
+        b = flush(b);
+        uint32_t sign = (a ^ b) & SIGN;
+        uint32_t a_abs = a & ABS_MASK, b_abs = b & ABS_MASK;
+
+        if (a_abs >= INFINITY_BITS || b_abs >= INFINITY_BITS) {
+            if (isNan(a) || isNan(b)) return QUIET_NAN;
+            if (a_abs == 0 || b_abs == 0) return QUIET_NAN;  // Infinity * 0
+            return sign | INFINITY_BITS;
+        }
+        if (a_abs == 0 || b_abs == 0) return sign;
+
+        int exponent = (int)(a_abs >> 23) + (int)(b_abs >> 23) - 127;
+        uint64_t product = (uint64_t)((a & FRACTION) | IMPLICIT) * ((b & FRACTION) | IMPLICIT);
+        // 1.46 or 2.46: keep 24 bits plus guard, round and sticky
+        if (product & (1ull << 47)) {
+            exponent++;
+            product = (product >> 21) | ((product & ((1ull << 21) - 1)) != 0);
+        } else {
+            product = (product >> 20) | ((product & ((1ull << 20) - 1)) != 0);
+        }
+        return pack(sign, exponent, (uint32_t)product);
+    }
+
+    static uint32_t div(uint32_t a, uint32_t b) {
+        a = flush(a);
+        b = flush(b);
+        uint32_t sign = (a ^ b) & SIGN;
+        uint32_t a_abs = a & ABS_MASK, b_abs = b & ABS_MASK;
+
+        if (isNan(a) || isNan(b)) return QUIET_NAN;
+        if (a_abs == INFINITY_BITS) return b_abs == INFINITY_BITS ? QUIET_NAN : sign | INFINITY_BITS;
+        if (b_abs == INFINITY_BITS) return sign;
+        if (b_abs == 0) return a_abs == 0 ? QUIET_NAN : sign | INFINITY_BITS;
+        if (a_abs == 0) return sign;
+
+        int exponent = (int)(a_abs >> 23) - (int)(b_abs >> 23) + 127;
+        uint64_t numerator = (uint64_t)((a & FRACTION) | IMPLICIT) << 27;
+        uint32_t divisor = (b & FRACTION) | IMPLICIT;
+        // The quotient is 0.5..2 in 2^27ths: 27 or 28 bits
+        uint64_t quotient = numerator / divisor;
+        uint32_t sticky = (numerator % divisor) != 0;
+        if (quotient & (1ull << 27)) {
+            quotient = (quotient >> 1) | (quotient & 1);
+        } else {
+            exponent--;
+        }
+        return pack(sign, exponent, (uint32_t)quotient | sticky);
+    }
+
+    static uint32_t sqrt(uint32_t a) {
+        a = flush(a);
+        uint32_t a_abs = a & ABS_MASK;
+        if (isNan(a)) return QUIET_NAN;
+        if (a_abs == 0) return a;
+        if (a & SIGN) return QUIET_NAN;
+        if (a_abs == INFINITY_BITS) return a;
+
+        // Make the exponent even, then the root of 1.23 (or 2.23) in 2^26ths
+        int exponent = (int)(a_abs >> 23) - 127;
+        uint64_t sig = (a & FRACTION) | IMPLICIT;
+        if (exponent & 1) {
+            sig <<= 1;
+            exponent--;
+        }
+        uint64_t n = sig << 29;
+        uint64_t root = 0, bit = 1ull << 62;
+        while (bit > n) bit >>= 2;
+        while (bit) {
+            if (n >= root + bit) {
+                n -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        // root is 1.26 rounded down: 27 bits, the low three as guard and
+        // round, plus sticky if anything was left over
+        return pack(0, exponent / 2 + 127, (uint32_t)root | (n != 0));
+    }
+};
+
+// sinf and atan2f the way a soft-float libm does them: reduce, fold, then
+// the same polynomials math/fixed.hpp uses, one soft operation at a time
+inline SoftFloat softSin(SoftFloat angle) {
+    const SoftFloat PI = 3.14159265f, TWO_PI = 6.28318531f, HALF_PI = 1.57079633f;
+    SoftFloat turns = SoftFloat((angle / TWO_PI).toInt());
+    SoftFloat x = angle - turns * TWO_PI;
+    if (x > PI) x -= TWO_PI;
+    if (x < -PI) x += TWO_PI;
+    if (x > HALF_PI) x = PI - x;
+    if (x < -HALF_PI) x = -PI - x;
+    SoftFloat x2 = x * x, one = 1;
+    SoftFloat s = one - x2 / SoftFloat(72);
+    s = one - x2 * s / SoftFloat(42);
+    s = one - x2 * s / SoftFloat(20);
+    s = one - x2 * s / SoftFloat(6);
+    return x * s;
+}
+
+inline SoftFloat softAtan2(SoftFloat y, SoftFloat x) {
+    const SoftFloat PI = 3.14159265f, HALF_PI = 1.57079633f, zero = 0;
+    if (x == zero && y == zero) return zero;
+    SoftFloat ax = x < zero ? -x : x, ay = y < zero ? -y : y;
+    SoftFloat z = ay <= ax ? ay / ax : ax / ay, z2 = z * z;
+    SoftFloat angle = z * (SoftFloat(0.9998660f) + z2 * (SoftFloat(-0.3302995f) + z2 * (SoftFloat(0.1801410f) +
+                           z2 * (SoftFloat(-0.0851330f) + z2 * SoftFloat(0.0208351f)))));
+    if (ay > ax) angle = HALF_PI - angle;
+    if (x < zero) angle = PI - angle;
+    return y < zero ? -angle : angle;
+}
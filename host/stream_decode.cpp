@@ -0,0 +1,215 @@
+// Turns a frame stream (frame_stream.hpp) back into images: one PPM or PNG
+// per record, named by frame number, plus frames.txt listing each frame's
+// number, clock and size so gaps and timing can be checked.
+//
+//   grep '^FRM' serial.log | cut -c5- | xxd -r -p > run.clfs
+//   ./build-host/cosmic_stream_decode run.clfs frames/ --png --scale 8
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "frame_stream.hpp"
+
+struct DecodeOptions {
+    const char* stream_path = nullptr;
+    const char* out_dir = nullptr;
+    bool png = false;
+    int scale = 1;
+};
+
+static bool loadFile(const char* path, std::vector<uint8_t>& contents) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Can't open %s\n", path);
+        return false;
+    }
+    uint8_t chunk[4096];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + got);
+    }
+    fclose(file);
+    return true;
+}
+
+// Each pixel as a scale x scale block of r, g, b bytes
+static std::vector<uint8_t> scaledRows(const uint32_t* pixels, int width, int height, int scale) {
+    std::vector<uint8_t> rgb;
+    rgb.reserve((size_t)width * height * scale * scale * 3);
+    for (int y = 0; y < height * scale; y++) {
+        const uint32_t* row = pixels + (y / scale) * width;
+        for (int x = 0; x < width * scale; x++) {
+            uint32_t pen = row[x / scale];
+            rgb.push_back((uint8_t)(pen >> 16));
+            rgb.push_back((uint8_t)(pen >> 8));
+            rgb.push_back((uint8_t)pen);
+        }
+    }
+    return rgb;
+}
+
+static bool writePPM(const char* path, const std::vector<uint8_t>& rgb, int width, int height) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+    fwrite(rgb.data(), 1, rgb.size(), file);
+    fclose(file);
+    return true;
+}
+
+// PNG without a zlib dependency: the image data goes in stored (uncompressed)
+// deflate blocks, which is fine for frames this small
+static uint32_t crc32(const uint8_t* data, size_t length, uint32_t crc = 0) {
+    static uint32_t table[256];
+    if (table[1] == 0) {
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putU32BE(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(value >> shift));
+}
+
+static void putChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    putU32BE(out, (uint32_t)data.size());
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    putU32BE(out, crc32(out.data() + start, out.size() - start));
+}
+
+static bool writePNG(const char* path, const std::vector<uint8_t>& rgb, int width, int height) {
+    // Each row behind a "no filter" byte
+    std::vector<uint8_t> raw;
+    size_t stride = (size_t)width * 3;
+    for (int y = 0; y < height; y++) {
+        raw.push_back(0);
+        raw.insert(raw.end(), rgb.begin() + y * stride, rgb.begin() + (y + 1) * stride);
+    }
+
+    std::vector<uint8_t> zlib = {0x78, 0x01};
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : raw) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    for (size_t offset = 0; offset < raw.size(); offset += 65535) {
+        size_t block = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+        zlib.push_back(offset + block == raw.size() ? 1 : 0);
+        zlib.push_back((uint8_t)block);
+        zlib.push_back((uint8_t)(block >> 8));
+        zlib.push_back((uint8_t)~block);
+        zlib.push_back((uint8_t)(~block >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + block);
+    }
+    putU32BE(zlib, (b << 16) | a);
+
+    std::vector<uint8_t> header;
+    putU32BE(header, width);
+    putU32BE(header, height);
+    header.insert(header.end(), {8, 2, 0, 0, 0});  // 8-bit RGB, no interlace
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    putChunk(png, "IHDR", header);
+    putChunk(png, "IDAT", zlib);
+    putChunk(png, "IEND", {});
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    fwrite(png.data(), 1, png.size(), file);
+    fclose(file);
+    return true;
+}
+
+static void printUsage(const char* name) {
+    printf("Usage: %s STREAM OUT_DIR [--png] [--scale N]\n", name);
+}
+
+static bool parseOptions(int argc, char** argv, DecodeOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--png") == 0) {
+            options.png = true;
+        } else if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            options.scale = atoi(argv[++i]);
+            if (options.scale < 1) options.scale = 1;
+        } else if (argv[i][0] != '-' && !options.stream_path) {
+            options.stream_path = argv[i];
+        } else if (argv[i][0] != '-' && !options.out_dir) {
+            options.out_dir = argv[i];
+        } else {
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+    if (!options.stream_path || !options.out_dir) {
+        printUsage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    DecodeOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    FrameStreamDecoder decoder;
+    if (!loadFile(options.stream_path, data) || !decoder.begin(data.data(), data.size())) {
+        fprintf(stderr, "%s is not a frame stream\n", options.stream_path);
+        return 1;
+    }
+
+    std::string index_path = std::string(options.out_dir) + "/frames.txt";
+    FILE* index = fopen(index_path.c_str(), "w");
+    if (!index) {
+        fprintf(stderr, "Can't write %s\n", index_path.c_str());
+        return 1;
+    }
+    fprintf(index, "# frame clock_ms bytes kind\n");
+
+    int width = decoder.getWidth(), height = decoder.getHeight();
+    int out_width = width * options.scale, out_height = height * options.scale;
+    std::vector<uint32_t> pixels(width * height, 0);
+    FrameStreamDecoder::Frame frame;
+    uint32_t records = 0, keys = 0;
+    uint64_t first_us = 0, last_us = 0;
+    while (decoder.next(pixels.data(), frame)) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/frame_%06lu.%s", options.out_dir, (unsigned long)frame.number,
+                 options.png ? "png" : "ppm");
+        std::vector<uint8_t> rgb = scaledRows(pixels.data(), width, height, options.scale);
+        bool written = options.png ? writePNG(path, rgb, out_width, out_height)
+                                   : writePPM(path, rgb, out_width, out_height);
+        if (!written) {
+            fprintf(stderr, "Can't write %s\n", path);
+            fclose(index);
+            return 1;
+        }
+
+        fprintf(index, "%lu %.3f %lu %s\n", (unsigned long)frame.number, frame.clock_us / 1000.0,
+                (unsigned long)frame.size, frame.key ? "key" : "delta");
+        if (records == 0) first_us = frame.clock_us;
+        last_us = frame.clock_us;
+        records++;
+        if (frame.key) keys++;
+    }
+    fclose(index);
+
+    double seconds = (last_us - first_us) / 1e6;
+    printf("%lu frames (%lu key) over %.1f s, %.0f bytes/frame average\n", (unsigned long)records,
+           (unsigned long)keys, seconds, records ? (double)(data.size() - FRAME_STREAM_HEADER_SIZE) / records : 0.0);
+    return 0;
+}
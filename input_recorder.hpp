@@ -0,0 +1,168 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "input_state.hpp"
+
+// Record/replay of launcher input for reproducible runs.
+//
+// Stream layout (little-endian):
+//   header  "CLIR", u8 version, u32 rng seed, u32 frame period (us)
+//   frames  u8 raw button mask (InputButton bits, before debouncing),
+//           varint microseconds since the previous frame
+// so a 20 fps session costs about four bytes per frame.
+//
+// The seed is what the launcher passes to srand() at boot, and the clock is
+// the time the frame's inputs were read. Replaying a stream on the build that
+// recorded it (e.g. the host build with its fake clock) reproduces the run
+// frame for frame; recordings from the board replay the same inputs and
+// timing, but soft-float and libc rand() differences mean pixels can drift.
+
+static constexpr uint8_t INPUT_STREAM_VERSION = 1;
+static constexpr size_t INPUT_STREAM_HEADER_SIZE = 13;
+
+// Collects the stream in a small buffer and hands full chunks to a sink
+// (a file on the host, hex lines over USB stdio on the board)
+class InputRecorder {
+public:
+    typedef void (*Sink)(const uint8_t* data, size_t length, void* context);
+
+private:
+    static constexpr size_t BUFFER_SIZE = 256;
+
+    uint8_t buffer[BUFFER_SIZE];
+    size_t buffered = 0;
+    Sink sink = nullptr;
+    void* sink_context = nullptr;
+    uint64_t last_clock_us = 0;
+    uint32_t frames = 0;
+    bool recording = false;
+
+    void put(uint8_t byte) {
+        if (buffered == BUFFER_SIZE) flush();
+        buffer[buffered++] = byte;
+    }
+
+    void putU32(uint32_t value) {
+        for (int i = 0; i < 4; i++) put((uint8_t)(value >> (i * 8)));
+    }
+
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            put((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        put((uint8_t)value);
+    }
+
+public:
+    void begin(uint32_t seed, uint32_t frame_period_us, Sink output, void* context = nullptr) {
+        sink = output;
+        sink_context = context;
+        buffered = 0;
+        last_clock_us = 0;
+        frames = 0;
+        recording = true;
+
+        put('C'); put('L'); put('I'); put('R');
+        put(INPUT_STREAM_VERSION);
+        putU32(seed);
+        putU32(frame_period_us);
+    }
+
+    void recordFrame(uint8_t buttons, uint64_t clock_us) {
+        if (!recording) return;
+        put(buttons);
+        putVarint(clock_us >= last_clock_us ? clock_us - last_clock_us : 0);
+        last_clock_us = clock_us;
+        frames++;
+    }
+
+    void flush() {
+        if (sink && buffered > 0) sink(buffer, buffered, sink_context);
+        buffered = 0;
+    }
+
+    void end() {
+        if (!recording) return;
+        flush();
+        recording = false;
+    }
+
+    bool isRecording() const { return recording; }
+    uint32_t getFrameCount() const { return frames; }
+};
+
+// Walks a complete stream held in memory
+class InputReplay {
+private:
+    const uint8_t* data = nullptr;
+    size_t length = 0;
+    size_t position = 0;
+    uint32_t seed = 0;
+    uint32_t frame_period_us = 0;
+    uint64_t clock_us = 0;
+    bool active = false;
+
+    static uint32_t readU32(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+public:
+    // Returns false if the data isn't a stream this build understands
+    bool begin(const uint8_t* stream, size_t stream_length) {
+        active = false;
+        if (stream_length < INPUT_STREAM_HEADER_SIZE || memcmp(stream, "CLIR", 4) != 0 ||
+            stream[4] != INPUT_STREAM_VERSION) {
+            return false;
+        }
+
+        data = stream;
+        length = stream_length;
+        seed = readU32(stream + 5);
+        frame_period_us = readU32(stream + 9);
+        position = INPUT_STREAM_HEADER_SIZE;
+        clock_us = 0;
+        active = true;
+        return true;
+    }
+
+    // Next frame's buttons and clock; false (and replay stops) at the end
+    bool next(uint8_t& buttons, uint64_t& frame_clock_us) {
+        if (!active || position >= length) {
+            active = false;
+            return false;
+        }
+
+        buttons = data[position++];
+
+        uint64_t delta = 0;
+        int shift = 0;
+        while (position < length) {
+            uint8_t byte = data[position++];
+            delta |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) break;
+            shift += 7;
+        }
+
+        clock_us += delta;
+        frame_clock_us = clock_us;
+        if (position >= length) active = false;  // That was the last frame
+        return true;
+    }
+
+    bool isActive() const { return active; }
+    uint32_t getSeed() const { return seed; }
+    uint32_t getFramePeriodUs() const { return frame_period_us; }
+};
+
+// Sink for the board: the stream goes out over USB stdio as hex lines
+// prefixed "REC ", which `grep '^REC' | cut -c5- | xxd -r -p` turns back into
+// a binary stream for the host build
+inline void inputRecorderHexSink(const uint8_t* data, size_t length, void*) {
+    printf("REC ");
+    for (size_t i = 0; i < length; i++) printf("%02x", data[i]);
+    printf("\n");
+}
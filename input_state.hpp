@@ -0,0 +1,161 @@
+#pragma once
+
+#include <stdint.h>
+
+// One frame's worth of button input. The launcher reads the switches once
+// per update, runs them through an InputSampler (debounce, edge detection,
+// auto-repeat) and hands the resulting InputState to the menu or the game,
+// so nothing else needs to touch the GPIOs or keep its own "was pressed"
+// flags.
+
+// Bit order of InputState masks and of input recordings
+enum InputButton : uint8_t {
+    BUTTON_A,
+    BUTTON_B,
+    BUTTON_C,
+    BUTTON_D,
+    BUTTON_VOLUME_UP,
+    BUTTON_VOLUME_DOWN,
+    BUTTON_BRIGHTNESS_UP,
+    BUTTON_BRIGHTNESS_DOWN,
+    BUTTON_COUNT
+};
+
+constexpr uint8_t inputBit(InputButton button) {
+    return (uint8_t)(1u << button);
+}
+
+struct InputEvent {
+    enum Type : uint8_t {
+        PRESSED,
+        RELEASED,
+        REPEATED   // Auto-repeat while held
+    };
+
+    InputButton button;
+    Type type;
+    uint32_t held_ms;  // How long the button had been down (0 for PRESSED)
+};
+
+struct InputState {
+    static constexpr int MAX_EVENTS = 2 * BUTTON_COUNT;
+
+    uint8_t held = 0;      // Down this frame
+    uint8_t pressed = 0;   // Went down this frame
+    uint8_t released = 0;  // Came up this frame
+    uint8_t repeated = 0;  // Went down this frame or auto-repeated
+    // Time each button has been down; on the frame it is released, the
+    // length of the whole press
+    uint32_t held_ms[BUTTON_COUNT] = {};
+
+    // The same edges in the order they happened, for code that wants a queue
+    InputEvent events[MAX_EVENTS];
+    uint8_t event_count = 0;
+
+    bool isHeld(InputButton button) const { return held & inputBit(button); }
+    bool wasPressed(InputButton button) const { return pressed & inputBit(button); }
+    bool wasReleased(InputButton button) const { return released & inputBit(button); }
+    bool wasRepeated(InputButton button) const { return repeated & inputBit(button); }
+    uint32_t heldMs(InputButton button) const { return held_ms[button]; }
+};
+
+// Turns raw switch samples into InputStates. A change of switch state is
+// accepted on the first sample that sees it, then that switch is locked out
+// for debounce_ms so its contact bounce can't register as more edges. A held
+// button repeats after repeat_delay_ms and then every repeat_interval_ms.
+class InputSampler {
+private:
+    uint32_t debounce_ms;
+    uint32_t repeat_delay_ms;
+    uint32_t repeat_interval_ms;
+
+    uint8_t stable = 0;      // Debounced switch state
+    uint8_t suppressed = 0;  // Held buttons ignored until they are released
+    uint32_t last_change_ms[BUTTON_COUNT];  // When each switch's lockout started
+    uint32_t down_since_ms[BUTTON_COUNT] = {};
+    uint32_t next_repeat_ms[BUTTON_COUNT] = {};
+    InputState state;
+
+    void addEvent(InputButton button, InputEvent::Type type, uint32_t held_ms) {
+        if (state.event_count < InputState::MAX_EVENTS) {
+            state.events[state.event_count++] = {button, type, held_ms};
+        }
+    }
+
+public:
+    explicit InputSampler(uint32_t debounce = 20, uint32_t repeat_delay = 400, uint32_t repeat_interval = 150)
+        : debounce_ms(debounce), repeat_delay_ms(repeat_delay), repeat_interval_ms(repeat_interval) {
+        // Let the very first change through straight away
+        for (int i = 0; i < BUTTON_COUNT; i++) last_change_ms[i] = 0u - debounce_ms;
+    }
+
+    void setRepeat(uint32_t delay_ms, uint32_t interval_ms) {
+        repeat_delay_ms = delay_ms;
+        repeat_interval_ms = interval_ms > 0 ? interval_ms : 1;
+    }
+
+    // Buttons down right now report nothing until released - e.g. the A
+    // press that launched a game shouldn't also act inside it
+    void suppressHeld() {
+        suppressed |= stable;
+        state.held &= ~suppressed;
+    }
+
+    // raw: one bit per InputButton, as read from the switches
+    const InputState& sample(uint8_t raw, uint32_t now_ms) {
+        state.pressed = 0;
+        state.released = 0;
+        state.repeated = 0;
+        state.event_count = 0;
+
+        for (int i = 0; i < BUTTON_COUNT; i++) {
+            InputButton button = (InputButton)i;
+            uint8_t bit = inputBit(button);
+            bool down = raw & bit;
+            bool was_down = stable & bit;
+            bool ignored = suppressed & bit;
+
+            if (down != was_down && now_ms - last_change_ms[i] >= debounce_ms) {
+                last_change_ms[i] = now_ms;
+                if (down) {
+                    stable |= bit;
+                    down_since_ms[i] = now_ms;
+                    next_repeat_ms[i] = now_ms + repeat_delay_ms;
+                    if (!ignored) {
+                        state.pressed |= bit;
+                        state.repeated |= bit;
+                        addEvent(button, InputEvent::PRESSED, 0);
+                    }
+                    state.held_ms[i] = 0;
+                } else {
+                    stable &= ~bit;
+                    suppressed &= ~bit;
+                    state.held_ms[i] = ignored ? 0 : now_ms - down_since_ms[i];
+                    if (!ignored) {
+                        state.released |= bit;
+                        addEvent(button, InputEvent::RELEASED, state.held_ms[i]);
+                    }
+                }
+            } else if (was_down) {
+                state.held_ms[i] = now_ms - down_since_ms[i];
+                if (!ignored && (int32_t)(now_ms - next_repeat_ms[i]) >= 0) {
+                    state.repeated |= bit;
+                    addEvent(button, InputEvent::REPEATED, state.held_ms[i]);
+                    next_repeat_ms[i] += repeat_interval_ms;
+                    // Don't fire a burst after a long stall
+                    if ((int32_t)(now_ms - next_repeat_ms[i]) >= 0) next_repeat_ms[i] = now_ms + repeat_interval_ms;
+                }
+            } else {
+                state.held_ms[i] = 0;
+            }
+        }
+
+        state.held = stable & ~suppressed;
+        for (int i = 0; i < BUTTON_COUNT; i++) {
+            if (suppressed & (1u << i)) state.held_ms[i] = 0;
+        }
+        return state;
+    }
+
+    const InputState& current() const { return state; }
+};
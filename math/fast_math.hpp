@@ -0,0 +1,220 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+// Table-driven stand-ins for the libm calls in per-pixel and per-scanline
+// effect code. The tables are generated at compile time and live in flash;
+// each lookup is a few integer operations plus one interpolation.
+//
+// Worst-case error against libm (checked by cosmic_benchmark_host --micro):
+//
+//   fastSin, fastCos  1e-4 absolute     512-entry table, linear interpolation,
+//                                       for |x| < 1000; beyond that rounding
+//                                       x / 2pi adds about |x| * 1e-7
+//   fastAtan2         2e-5 radians      octant reduction + polynomial
+//   fastSqrt          1e-5 relative     64 entries per octave, interpolated
+//   fastExp           5e-5 relative     2^(n + f) with a 64-entry 2^f table;
+//                                       0 below -87, clamped above 88
+//
+// Good enough for anything that ends up as an 8-bit colour or a pixel
+// position; keep libm for physics that accumulates.
+
+namespace fast_math_detail {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double LN2 = 0.69314718055994530942;
+
+    // Compile-time versions of the functions the tables are built from.
+    // Slow and exact to double precision in the ranges used below.
+    constexpr double seriesSin(double x) {
+        while (x > PI) x -= 2 * PI;
+        while (x < -PI) x += 2 * PI;
+        double term = x, sum = x;
+        for (int n = 1; n < 20; n++) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double seriesExp(double x) {
+        double term = 1, sum = 1;
+        for (int n = 1; n < 30; n++) {
+            term *= x / n;
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Natural log for x > 0: halve or double into [1, 2), then the atanh
+    // series
+    constexpr double seriesLog(double x) {
+        double k = 0;
+        while (x >= 2) { x /= 2; k++; }
+        while (x < 1) { x *= 2; k--; }
+        double z = (x - 1) / (x + 1), z2 = z * z;
+        double term = z, sum = 0;
+        for (int n = 0; n < 30; n++) {
+            sum += term / (2 * n + 1);
+            term *= z2;
+        }
+        return k * LN2 + 2 * sum;
+    }
+
+    constexpr double newtonSqrt(double x) {
+        double r = x > 1 ? x : 1;
+        for (int i = 0; i < 40; i++) r = 0.5 * (r + x / r);
+        return r;
+    }
+
+    // atan(z) = 2 atan(z / (1 + sqrt(1 + z^2))), twice, brings |z| <= 1
+    // under 0.2 before the Taylor series
+    constexpr double seriesAtan(double z) {
+        for (int i = 0; i < 2; i++) z = z / (1 + newtonSqrt(1 + z * z));
+        double term = z, sum = 0;
+        for (int n = 0; n < 30; n++) {
+            sum += term / (2 * n + 1);
+            term *= -z * z;
+        }
+        return 4 * sum;
+    }
+
+    constexpr double seriesAtan2(double y, double x) {
+        double ax = x < 0 ? -x : x, ay = y < 0 ? -y : y;
+        if (ax == 0 && ay == 0) return 0;
+        double angle = ay <= ax ? seriesAtan(ay / ax) : PI / 2 - seriesAtan(ax / ay);
+        if (x < 0) angle = PI - angle;
+        return y < 0 ? -angle : angle;
+    }
+
+    constexpr int SINE_BITS = 9;
+    constexpr int SINE_SIZE = 1 << SINE_BITS;
+
+    // One full turn plus a guard entry so interpolation never wraps
+    struct SineTable {
+        float values[SINE_SIZE + 1] = {};
+        constexpr SineTable() {
+            for (int i = 0; i <= SINE_SIZE; i++) values[i] = (float)seriesSin(2 * PI * i / SINE_SIZE);
+        }
+    };
+
+    constexpr int SQRT_BITS = 6;
+    constexpr int SQRT_SIZE = 1 << SQRT_BITS;
+
+    // sqrt over one octave of mantissas, [1, 2) and [2, 4) (for odd
+    // exponents), each with a guard entry
+    struct SqrtTable {
+        float even[SQRT_SIZE + 1] = {};
+        float odd[SQRT_SIZE + 1] = {};
+        constexpr SqrtTable() {
+            for (int i = 0; i <= SQRT_SIZE; i++) {
+                double m = 1.0 + (double)i / SQRT_SIZE;
+                even[i] = (float)newtonSqrt(m);
+                odd[i] = (float)newtonSqrt(2 * m);
+            }
+        }
+    };
+
+    constexpr int EXP2_BITS = 6;
+    constexpr int EXP2_SIZE = 1 << EXP2_BITS;
+
+    // 2^f for f in [0, 1], with a guard entry
+    struct Exp2Table {
+        float values[EXP2_SIZE + 1] = {};
+        constexpr Exp2Table() {
+            for (int i = 0; i <= EXP2_SIZE; i++) values[i] = (float)seriesExp(LN2 * i / EXP2_SIZE);
+        }
+    };
+
+    inline constexpr SineTable SINE_TABLE{};
+    inline constexpr SqrtTable SQRT_TABLE{};
+    inline constexpr Exp2Table EXP2_TABLE{};
+
+    inline uint32_t floatBits(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        return bits;
+    }
+
+    inline float bitsFloat(uint32_t bits) {
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    // Table position for x radians plus quarter_turns * pi/2
+    inline float sineLookup(float x, int quarter_turns) {
+        float t = x * (float)(SINE_SIZE / (2 * PI));
+        int32_t i = (int32_t)t;
+        if (t < (float)i) i--;  // Round towards -infinity
+        float frac = t - (float)i;
+        i = (i + quarter_turns * (SINE_SIZE / 4)) & (SINE_SIZE - 1);
+        float a = SINE_TABLE.values[i];
+        return a + (SINE_TABLE.values[i + 1] - a) * frac;
+    }
+
+    // atan(z) for z in [0, 1]: Abramowitz & Stegun 4.4.49
+    inline float atanUnit(float z) {
+        float z2 = z * z;
+        return z * (0.9998660f + z2 * (-0.3302995f + z2 * (0.1801410f + z2 * (-0.0851330f + z2 * 0.0208351f))));
+    }
+}
+
+// pow() goes through log and exp even for small integer powers
+constexpr float squared(float x) { return x * x; }
+constexpr float cubed(float x) { return x * x * x; }
+
+inline float fastSin(float x) {
+    return fast_math_detail::sineLookup(x, 0);
+}
+
+inline float fastCos(float x) {
+    return fast_math_detail::sineLookup(x, 1);
+}
+
+// Angle of (x, y) in [-pi, pi], as atan2(y, x)
+inline float fastAtan2(float y, float x) {
+    using namespace fast_math_detail;
+    float ax = x < 0 ? -x : x;
+    float ay = y < 0 ? -y : y;
+    if (ax == 0 && ay == 0) return 0;
+
+    float angle = ay <= ax ? atanUnit(ay / ax) : (float)(PI / 2) - atanUnit(ax / ay);
+    if (x < 0) angle = (float)PI - angle;
+    return y < 0 ? -angle : angle;
+}
+
+// Square root from the float's exponent and a mantissa table; 0 for x <= 0
+inline float fastSqrt(float x) {
+    using namespace fast_math_detail;
+    if (!(x > 0)) return 0;
+
+    uint32_t bits = floatBits(x);
+    if ((bits >> 23) == 0) return 0;  // Denormals: close enough
+    int32_t exponent = (int32_t)(bits >> 23) - 127;  // x > 0, so no sign bit
+    uint32_t mantissa = bits & 0x7fffff;
+
+    const float* table = (exponent & 1) ? SQRT_TABLE.odd : SQRT_TABLE.even;
+    uint32_t index = mantissa >> (23 - SQRT_BITS);
+    float frac = (float)(mantissa & ((1u << (23 - SQRT_BITS)) - 1)) * (1.0f / (1u << (23 - SQRT_BITS)));
+    float root = table[index] + (table[index + 1] - table[index]) * frac;
+
+    // sqrt(m * 2^e) = sqrt(m * 2^(e & 1)) * 2^(e >> 1)
+    return bitsFloat(floatBits(root) + ((uint32_t)(exponent >> 1) << 23));
+}
+
+inline float fastExp(float x) {
+    using namespace fast_math_detail;
+    if (x < -87.0f) return 0;
+    if (x > 88.0f) x = 88.0f;
+
+    // e^x = 2^(x / ln 2) = 2^n * 2^f
+    float t = x * (float)(1.0 / LN2);
+    int32_t n = (int32_t)t;
+    if (t < (float)n) n--;
+    float f = (t - (float)n) * EXP2_SIZE;
+    int32_t index = (int32_t)f;
+    float a = EXP2_TABLE.values[index];
+    float result = a + (EXP2_TABLE.values[index + 1] - a) * (f - (float)index);
+    return bitsFloat(floatBits(result) + ((uint32_t)n << 23));
+}
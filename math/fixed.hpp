@@ -0,0 +1,313 @@
+#pragma once
+
+#include <stdint.h>
+#include <type_traits>
+
+// Fixed-point numbers for game physics. The RP2040 has no FPU, so every float
+// add or multiply is a call into the boot ROM's soft-float routines; a Fixed
+// is a plain integer with FRAC fractional bits. + - and comparisons are single
+// instructions. The M0+ has a 32x32 -> 32 multiply and no wider one, and a
+// 32-bit hardware divider but no 64-bit divide, so fix16's * / and sqrt are
+// written to stay in 32 bits (see fixed_detail): * is four 16x16 multiplies,
+// / one hardware divide for the integer part and one more per few fraction
+// bits, sqrt a bit-by-bit root. None of them go through int64_t, whose
+// multiply and divide are library calls on the M0+ (__aeabi_lmul,
+// __aeabi_ldivmod). fix8 works in int32_t, which the M0+ handles natively.
+//
+//   fix16  Q16.16 in an int32_t: range +-32768, step 1/65536 - positions,
+//          velocities, anything that used to be a float
+//   fix8   Q8.8 in an int16_t: range +-128, step 1/256 - compact state
+//
+// Values convert implicitly from int, float and double (rounded to the
+// nearest step), so existing float literals keep working:
+//
+//   fix16 velocity = 0.0f;
+//   velocity += steer * 0.05f;
+//   if (velocity > 0.1f) velocity = 0.1f;
+//
+// Going back is explicit: toFloat()/toInt(), or (float)/(int) casts. (int)
+// truncates towards zero like it does for a float. Results that don't fit
+// wrap around, as integer arithmetic does.
+namespace fixed_detail {
+    // (a * b) >> frac, to the bit (including wrapping), without a 64-bit
+    // multiply: split each value at frac into a signed high part and an
+    // unsigned low part, so every partial product fits in 32 bits
+    //
+    //   a * b >> frac = (ah * bh << frac) + ah * bl + al * bh + (al * bl >> frac)
+    template <int frac>
+    constexpr int32_t mul32(int32_t a, int32_t b) {
+        static_assert(frac > 0 && frac <= 16, "al * bl must fit in 32 bits");
+        int32_t ah = a >> frac, bh = b >> frac;
+        uint32_t al = (uint32_t)a & ((1u << frac) - 1), bl = (uint32_t)b & ((1u << frac) - 1);
+        uint32_t result = ((uint32_t)(ah * bh) << frac) + (uint32_t)(ah * (int32_t)bl) +
+                          (uint32_t)((int32_t)al * bh) + ((al * bl) >> frac);
+        return (int32_t)result;
+    }
+
+    // (a << frac) / b truncated towards zero, to the bit (including
+    // wrapping), with 32-bit divides only: the integer part from one divide,
+    // then the fraction bits by long division, as many bits per divide as
+    // the remainder has room for: one more divide for a divisor below 1.0,
+    // at most two below 256.0.
+    template <int frac>
+    constexpr int32_t div32(int32_t a, int32_t b) {
+        uint32_t ua = a < 0 ? 0u - (uint32_t)a : (uint32_t)a;
+        uint32_t ub = b < 0 ? 0u - (uint32_t)b : (uint32_t)b;
+        uint32_t remainder = ua % ub;
+        uint32_t result = (ua / ub) << frac;
+        int bits = frac;
+        while (bits > 0 && remainder) {
+            // remainder < ub <= 2^31, so at least one bit is free
+            int shift = __builtin_clz(remainder);
+            if (shift > bits) shift = bits;
+            remainder <<= shift;
+            bits -= shift;
+            result += (remainder / ub) << bits;
+            remainder %= ub;
+        }
+        return (int32_t)((a < 0) != (b < 0) ? 0u - result : result);
+    }
+}
+
+template <int FRAC, typename T, typename Wide>
+class Fixed {
+    static_assert(FRAC > 0 && FRAC < (int)(8 * sizeof(T)), "FRAC must leave room for the sign bit");
+    static_assert(sizeof(Wide) >= 2 * sizeof(T), "Wide must hold a full product");
+
+    T value = 0;
+
+public:
+    static constexpr int FRACTION_BITS = FRAC;
+    static constexpr T ONE = (T)1 << FRAC;
+
+    constexpr Fixed() = default;
+    constexpr Fixed(int i) : value((T)(i * ONE)) {}
+    constexpr Fixed(float f) : value((T)(f * ONE + (f >= 0 ? 0.5f : -0.5f))) {}
+    constexpr Fixed(double d) : value((T)(d * ONE + (d >= 0 ? 0.5 : -0.5))) {}
+
+    static constexpr Fixed fromRaw(Wide raw) {
+        Fixed f;
+        f.value = (T)raw;
+        return f;
+    }
+
+    constexpr T raw() const { return value; }
+    constexpr float toFloat() const { return (float)value / ONE; }
+    constexpr int toInt() const { return value >= 0 ? value >> FRAC : -(int)(-(Wide)value >> FRAC); }
+    // Largest integer <= value, for grid cells left of zero
+    constexpr int floor() const { return value >> FRAC; }
+
+    explicit constexpr operator float() const { return toFloat(); }
+    explicit constexpr operator int() const { return toInt(); }
+
+    constexpr Fixed operator-() const { return fromRaw(-(Wide)value); }
+    constexpr Fixed operator+() const { return *this; }
+
+    friend constexpr Fixed operator+(Fixed a, Fixed b) { return fromRaw((Wide)a.value + b.value); }
+    friend constexpr Fixed operator-(Fixed a, Fixed b) { return fromRaw((Wide)a.value - b.value); }
+    friend constexpr Fixed operator*(Fixed a, Fixed b) {
+        if constexpr (NARROW) return fromRaw(fixed_detail::mul32<FRAC>(a.value, b.value));
+        return fromRaw(((Wide)a.value * b.value) >> FRAC);
+    }
+    // Division by zero saturates instead of trapping
+    friend constexpr Fixed operator/(Fixed a, Fixed b) {
+        if (b.value == 0) return fromRaw(a.value >= 0 ? maxRaw() : -maxRaw());
+        if constexpr (NARROW) return fromRaw(fixed_detail::div32<FRAC>(a.value, b.value));
+        return fromRaw(((Wide)a.value * ONE) / b.value);
+    }
+
+    // Scaling by an integer needs no shift. Templates so that a float
+    // operand still goes through Fixed rather than being truncated to int.
+    // The multiply wraps in 32 bits as the Wide one would after truncation.
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    friend constexpr Fixed operator*(Fixed a, I b) {
+        if constexpr (NARROW && sizeof(I) <= 4) return fromRaw((int32_t)((uint32_t)a.value * (uint32_t)b));
+        return fromRaw((Wide)a.value * b);
+    }
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    friend constexpr Fixed operator*(I a, Fixed b) { return b * a; }
+    template <typename I, typename = std::enable_if_t<std::is_integral<I>::value>>
+    friend constexpr Fixed operator/(Fixed a, I b) {
+        if (b == 0) return fromRaw(a.value >= 0 ? maxRaw() : -maxRaw());
+        if constexpr (NARROW && sizeof(I) <= 4) {
+            // The one quotient that doesn't fit in 32 bits wraps, as in Wide
+            if (b == -1) return -a;
+            return fromRaw(a.value / (int32_t)b);
+        }
+        return fromRaw((Wide)a.value / b);
+    }
+
+    constexpr Fixed& operator+=(Fixed b) { return *this = *this + b; }
+    constexpr Fixed& operator-=(Fixed b) { return *this = *this - b; }
+    constexpr Fixed& operator*=(Fixed b) { return *this = *this * b; }
+    constexpr Fixed& operator/=(Fixed b) { return *this = *this / b; }
+
+    friend constexpr bool operator==(Fixed a, Fixed b) { return a.value == b.value; }
+    friend constexpr bool operator!=(Fixed a, Fixed b) { return a.value != b.value; }
+    friend constexpr bool operator<(Fixed a, Fixed b) { return a.value < b.value; }
+    friend constexpr bool operator>(Fixed a, Fixed b) { return a.value > b.value; }
+    friend constexpr bool operator<=(Fixed a, Fixed b) { return a.value <= b.value; }
+    friend constexpr bool operator>=(Fixed a, Fixed b) { return a.value >= b.value; }
+
+private:
+    // 32-bit values with a Wide that the M0+ would only multiply and divide
+    // in library calls: fix16
+    static constexpr bool NARROW = sizeof(T) == 4 && sizeof(Wide) > 4 && FRAC <= 16;
+
+    static constexpr Wide maxRaw() { return (Wide)(((Wide)1 << (8 * sizeof(T) - 1)) - 1); }
+};
+
+using fix16 = Fixed<16, int32_t, int64_t>;
+using fix8 = Fixed<8, int16_t, int32_t>;
+
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedAbs(Fixed<F, T, W> a) {
+    return a.raw() < 0 ? -a : a;
+}
+
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedMin(Fixed<F, T, W> a, Fixed<F, T, W> b) { return a < b ? a : b; }
+
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedMax(Fixed<F, T, W> a, Fixed<F, T, W> b) { return a > b ? a : b; }
+
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedClamp(Fixed<F, T, W> v, Fixed<F, T, W> low, Fixed<F, T, W> high) {
+    return v < low ? low : (v > high ? high : v);
+}
+
+// a at t = 0, b at t = 1
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedLerp(Fixed<F, T, W> a, Fixed<F, T, W> b, Fixed<F, T, W> t) {
+    return a + (b - a) * t;
+}
+
+template <int F, typename T, typename W>
+constexpr Fixed<F, T, W> fixedReciprocal(Fixed<F, T, W> a) {
+    return Fixed<F, T, W>(1) / a;
+}
+
+namespace fixed_detail {
+    // Bit-by-bit integer square root, rounded down
+    template <typename U>
+    inline U isqrt(U n) {
+        U root = 0;
+        U bit = (U)1 << (8 * sizeof(U) - 2);
+        while (bit > n) bit >>= 2;
+        while (bit) {
+            if (n >= root + bit) {
+                n -= root + bit;
+                root = (root >> 1) + bit;
+            } else {
+                root >>= 1;
+            }
+            bit >>= 2;
+        }
+        return root;
+    }
+
+    // isqrt(n << 16) in 32-bit registers: the bit-by-bit root of n gives the
+    // top 16 bits, then the remainder and root are shifted up 16 for the
+    // last 8, which is where the 64-bit loop would be at that point
+    inline uint32_t sqrtQ16(uint32_t n) {
+        uint32_t root = 0;
+        uint32_t bit = (n & 0xfff00000) ? 1u << 30 : 1u << 18;
+        while (bit > n) bit >>= 2;
+        for (int pass = 0; pass < 2; pass++) {
+            while (bit) {
+                if (n >= root + bit) {
+                    n -= root + bit;
+                    root = (root >> 1) + bit;
+                } else {
+                    root >>= 1;
+                }
+                bit >>= 2;
+            }
+            if (pass == 1) break;
+
+            if (n > 0xffff) {
+                // n << 16 would overflow. The next bit is set whenever
+                // n > root, so take that step here, which subtracts enough
+                n = ((n - root) << 16) - (1u << 14);
+                root = (root << 15) + (1u << 14);
+                bit = 1u << 12;
+            } else {
+                n <<= 16;
+                root <<= 16;
+                bit = 1u << 14;
+            }
+        }
+        return root;
+    }
+}
+
+// No division and no float; exact to the last step (rounded down). Negative
+// input gives 0. sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F): fix16 takes the
+// two-pass 32-bit root above, about 24 shift-and-subtract steps whatever the
+// size; fix8's raw * 2^8 fits in 32 bits as it is.
+template <int F, typename T, typename W>
+inline Fixed<F, T, W> fixedSqrt(Fixed<F, T, W> a) {
+    if (a.raw() <= 0) return Fixed<F, T, W>();
+
+    if constexpr (F == 16 && sizeof(T) == 4) {
+        return Fixed<F, T, W>::fromRaw((W)fixed_detail::sqrtQ16((uint32_t)a.raw()));
+    } else if constexpr (F + 8 * sizeof(T) <= 33) {
+        return Fixed<F, T, W>::fromRaw((W)fixed_detail::isqrt<uint32_t>((uint32_t)a.raw() << F));
+    } else {
+        return Fixed<F, T, W>::fromRaw((W)fixed_detail::isqrt<uint64_t>((uint64_t)a.raw() << F));
+    }
+}
+
+namespace fixed_detail {
+    constexpr fix16 PI = 3.14159265358979;
+    constexpr fix16 HALF_PI = 1.57079632679490;
+    constexpr fix16 TWO_PI = 6.28318530717959;
+
+    // sin(x) for x in [-pi/2, pi/2]: Taylor series to x^9 in Horner form,
+    // worst case about 1e-5 at the ends before rounding
+    inline fix16 sinQuadrant(fix16 x) {
+        fix16 x2 = x * x;
+        fix16 s = fix16(1) - x2 / 72;
+        s = fix16(1) - x2 * s / 42;
+        s = fix16(1) - x2 * s / 20;
+        s = fix16(1) - x2 * s / 6;
+        return x * s;
+    }
+
+    // atan(z) for z in [-1, 1]: Abramowitz & Stegun 4.4.49, error < 1e-5
+    inline fix16 atanUnit(fix16 z) {
+        constexpr fix16 C1 = 0.9998660, C3 = -0.3302995, C5 = 0.1801410, C7 = -0.0851330, C9 = 0.0208351;
+        fix16 z2 = z * z;
+        return z * (C1 + z2 * (C3 + z2 * (C5 + z2 * (C7 + z2 * C9))));
+    }
+}
+
+// Angles in radians, any range
+inline fix16 fixedSin(fix16 angle) {
+    using namespace fixed_detail;
+    // Reduce to [-pi, pi]
+    int32_t raw = angle.raw() % TWO_PI.raw();
+    if (raw > PI.raw()) raw -= TWO_PI.raw();
+    if (raw < -PI.raw()) raw += TWO_PI.raw();
+    // Fold into [-pi/2, pi/2]: sin(pi - x) = sin(x)
+    if (raw > HALF_PI.raw()) raw = PI.raw() - raw;
+    if (raw < -HALF_PI.raw()) raw = -PI.raw() - raw;
+    return sinQuadrant(fix16::fromRaw(raw));
+}
+
+inline fix16 fixedCos(fix16 angle) {
+    // cos(x) = sin(x + pi/2); keep the sum in range for huge angles
+    int32_t raw = angle.raw() % fixed_detail::TWO_PI.raw();
+    return fixedSin(fix16::fromRaw(raw) + fixed_detail::HALF_PI);
+}
+
+// Angle of (x, y) in [-pi, pi], as std::atan2
+inline fix16 fixedAtan2(fix16 y, fix16 x) {
+    using namespace fixed_detail;
+    if (x == 0 && y == 0) return fix16();
+
+    fix16 ax = fixedAbs(x), ay = fixedAbs(y);
+    fix16 angle = ay <= ax ? atanUnit(ay / ax) : HALF_PI - atanUnit(ax / ay);
+    if (x < 0) angle = PI - angle;
+    return y < 0 ? -angle : angle;
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "fixed.hpp"
+
+// The game code ported to fix16, as kernels written once for any number
+// type, so fix16 can be timed against float the way the RP2040 runs it.
+// host/benchmark.cpp --micro runs them against host/soft_float.hpp; a
+// firmware built with COSMIC_FIXED_BENCH runs them against the board's own
+// float routines at boot and prints one FIX line per kernel over USB:
+//
+//   FIX fixed_sqrt          float   1234 ns  fix16    567 ns
+//
+// Each kernel returns its result so the work can't be optimised away.
+
+inline float benchSqrt(float x) { return sqrtf(x); }
+inline fix16 benchSqrt(fix16 x) { return fixedSqrt(x); }
+inline float benchSin(float x) { return sinf(x); }
+inline fix16 benchSin(fix16 x) { return fixedSin(x); }
+inline float benchAtan2(float y, float x) { return atan2f(y, x); }
+inline fix16 benchAtan2(fix16 y, fix16 x) { return fixedAtan2(y, x); }
+
+template <typename Number>
+struct FixedBenchData {
+    static constexpr int COUNT = 256;
+    static constexpr int BOIDS = 16;
+    Number values[COUNT];         // 0.05 .. 94.4
+    Number dxs[COUNT], dys[COUNT];  // Qix enemy directions, -1 .. 1
+    Number xs[BOIDS], ys[BOIDS];    // Boids in a 12x12 patch, so most pairs are close
+
+    FixedBenchData() {
+        for (int i = 0; i < COUNT; i++) {
+            values[i] = Number(0.05f + i * 0.37f);
+            dxs[i] = Number(((i * 37) % 201 - 100) * 0.01f);
+            dys[i] = Number(((i * 91) % 201 - 100) * 0.01f);
+        }
+        for (int i = 0; i < BOIDS; i++) {
+            xs[i] = Number(((i * 7) % 12) + 0.3f * i);
+            ys[i] = Number(((i * 5) % 12) + 0.1f * i);
+        }
+    }
+};
+
+namespace fixed_bench {
+    // Car::update's steering step: multiply-add, friction, clamp
+    template <typename Number>
+    Number physicsStep(const FixedBenchData<Number>& d) {
+        Number v = Number(0), power = Number(0.05f), friction = Number(0.85f), limit = Number(0.1f);
+        for (int k = 0; k < d.COUNT; k++) {
+            v = (v + d.values[k] * power) * friction;
+            if (v > limit) v = limit;
+        }
+        return v;
+    }
+
+    template <typename Number>
+    Number divide(const FixedBenchData<Number>& d) {
+        Number sum = Number(0), one = Number(1);
+        for (int k = 0; k < d.COUNT; k++) sum += one / d.values[k];
+        return sum;
+    }
+
+    template <typename Number>
+    Number sqrt(const FixedBenchData<Number>& d) {
+        Number sum = Number(0);
+        for (int k = 0; k < d.COUNT; k++) sum += benchSqrt(d.values[k]);
+        return sum;
+    }
+
+    template <typename Number>
+    Number sin(const FixedBenchData<Number>& d) {
+        Number sum = Number(0);
+        for (int k = 0; k < d.COUNT; k++) sum += benchSin(d.values[k]);
+        return sum;
+    }
+
+    template <typename Number>
+    Number atan2(const FixedBenchData<Number>& d) {
+        Number sum = Number(0), cx = Number(40), cy = Number(50);
+        for (int k = 0; k < d.COUNT; k++) sum += benchAtan2(d.values[k] - cx, d.values[d.COUNT - 1 - k] - cy);
+        return sum;
+    }
+
+    // The boids' separate(): a distance per pair, and for close pairs the
+    // offset normalised and weighted by distance
+    template <typename Number>
+    Number boidSeparation(const FixedBenchData<Number>& d) {
+        Number steer_x = Number(0), steer_y = Number(0);
+        Number zero = Number(0), separation = Number(3), min_weight = Number(0.25f);
+        for (int a = 0; a < d.BOIDS; a++) {
+            for (int b = 0; b < d.BOIDS; b++) {
+                Number dx = d.xs[a] - d.xs[b], dy = d.ys[a] - d.ys[b];
+                Number dist = benchSqrt(dx * dx + dy * dy);
+                if (dist > zero && dist < separation) {
+                    dx = dx / dist;
+                    dy = dy / dist;
+                    Number weight = dist > min_weight ? dist : min_weight;
+                    steer_x += dx / weight;
+                    steer_y += dy / weight;
+                }
+            }
+        }
+        return steer_x + steer_y;
+    }
+
+    // A Qix enemy's step: move, stuck check, renormalise the direction,
+    // clamp to the field
+    template <typename Number>
+    Number qixStep(const FixedBenchData<Number>& d) {
+        Number x = Number(20), y = Number(15), total = Number(0);
+        Number speed = Number(0.4f), stuck = Number(0.1f), low = Number(5), high = Number(58);
+        for (int k = 0; k < d.COUNT; k++) {
+            Number dx = d.dxs[k], dy = d.dys[k];
+            Number moved_x = dx * speed, moved_y = dy * speed;
+            x += moved_x;
+            y += moved_y;
+            if (benchSqrt(moved_x * moved_x + moved_y * moved_y) < stuck) total += Number(1);
+            Number mag = benchSqrt(dx * dx + dy * dy);
+            if (mag > stuck) {
+                dx = dx / mag;
+                dy = dy / mag;
+            }
+            x = x < low ? low : (x > high ? high : x);
+            y = y < low ? low : (y > high ? high : y);
+            total += dx + dy;
+        }
+        return total + x + y;
+    }
+}
+
+// Calls time(name, items, float_kernel, fix16_kernel) for every kernel,
+// with Float standing in for float
+template <typename Float, typename Time>
+void forEachFixedBench(Time time) {
+    static FixedBenchData<Float> floats;
+    static FixedBenchData<fix16> fixeds;
+    const int n = FixedBenchData<fix16>::COUNT;
+    const int pairs = FixedBenchData<fix16>::BOIDS * FixedBenchData<fix16>::BOIDS;
+    time("fixed_physics_step", n, [] { return fixed_bench::physicsStep(floats); }, [] { return fixed_bench::physicsStep(fixeds); });
+    time("fixed_divide", n, [] { return fixed_bench::divide(floats); }, [] { return fixed_bench::divide(fixeds); });
+    time("fixed_sqrt", n, [] { return fixed_bench::sqrt(floats); }, [] { return fixed_bench::sqrt(fixeds); });
+    time("fixed_sin", n, [] { return fixed_bench::sin(floats); }, [] { return fixed_bench::sin(fixeds); });
+    time("fixed_atan2", n, [] { return fixed_bench::atan2(floats); }, [] { return fixed_bench::atan2(fixeds); });
+    time("fixed_boid_pairs", pairs, [] { return fixed_bench::boidSeparation(floats); }, [] { return fixed_bench::boidSeparation(fixeds); });
+    time("fixed_qix_step", n, [] { return fixed_bench::qixStep(floats); }, [] { return fixed_bench::qixStep(fixeds); });
+}
+
+// 32 bits of any 32-bit number, for sinks
+template <typename Number>
+uint32_t fixedBenchBits(Number n) {
+    static_assert(sizeof(Number) == sizeof(uint32_t), "32-bit numbers only");
+    uint32_t bits;
+    memcpy(&bits, &n, sizeof(bits));
+    return bits;
+}
+
+inline volatile uint32_t fixed_bench_sink = 0;
+
+// The board run, against real float
+inline void runFixedBenchOnBoard(int iterations = 200) {
+    forEachFixedBench<float>([&](const char* name, int items, auto run_float, auto run_fixed) {
+        uint64_t start = time_us_64();
+        for (int i = 0; i < iterations; i++) fixed_bench_sink = fixed_bench_sink + fixedBenchBits(run_float());
+        uint64_t float_us = time_us_64() - start;
+
+        start = time_us_64();
+        for (int i = 0; i < iterations; i++) fixed_bench_sink = fixed_bench_sink + fixedBenchBits(run_fixed());
+        uint64_t fixed_us = time_us_64() - start;
+
+        uint64_t calls = (uint64_t)iterations * items;
+        printf("FIX %-18s float %6lu ns  fix16 %6lu ns\n", name,
+               (unsigned long)(float_us * 1000 / calls), (unsigned long)(fixed_us * 1000 / calls));
+    });
+}
@@ -10,28 +10,40 @@
 #include "libraries/bitmap_fonts/font6_data.hpp"
 #include "cosmic_unicorn.hpp"
 #include "game_base.hpp"
+#include "heap_stats.hpp"
+#include "game_arena.hpp"
+#include "gfx/span_fill.hpp"
+#include "gfx/compositor.hpp"
+#include "gfx/glyph_font.hpp"
 #include "games/halloween_scenes/stormy_night_scene.hpp"
 
 using namespace pimoroni;
 
+// Games are only constructed when picked from the menu, so just one game's
+// state is resident at a time
+using GameFactory = std::unique_ptr<GameBase> (*)();
+
+template <typename T>
+std::unique_ptr<GameBase> createGame() {
+    return std::make_unique<T>();
+}
+
 struct MenuItem {
     const char* name;
     const char* description;
-    std::unique_ptr<GameBase> game;
+    GameFactory factory;
+    size_t peak_live_bytes = 0;   // Most game memory in use at once, across all sessions
+    size_t peak_arena_bytes = 0;  // Highest arena high-water mark across all sessions
+    int name_width = -1;          // In the menu font, measured on first draw
     
-    MenuItem(const char* n, const char* d, std::unique_ptr<GameBase> g) 
-        : name(n), description(d), game(std::move(g)) {}
+    MenuItem(const char* n, const char* d, GameFactory f) 
+        : name(n), description(d), factory(f) {}
 };
 
 class GameMenu {
 private:
     std::vector<MenuItem> menu_items;
     int selected_index = 0;
-    bool button_a_pressed = false;
-    bool button_b_pressed = false;
-    bool button_c_pressed = false;
-    uint32_t last_input_time = 0;
-    const uint32_t input_debounce_ms = 200;
     
     // Visual properties
     Pen bg_pen, text_pen, selected_pen, title_pen;
@@ -41,22 +53,68 @@ private:
     // Stormy background
     StormyNightScene stormy_background;
     
-    void drawText(PicoGraphics_PenRGB888& gfx, const char* text, int x, int y, float scale = 1.0f) {
-        gfx.text(text, Point(x, y), -1, scale);
-    }
+    // The storm is simulated and drawn every other frame; the item list only
+    // when the selection moves, keyed over the storm
+    Layer storm_layer{"menuStorm", LayerRefresh::EVERY_N, 2};
+    Layer items_layer{"menuItems", LayerRefresh::STATIC, 1, LayerBlend::KEYED};
+    Compositor layers;
+    int drawn_selection = -1;
+    
+    // The game currently being played, if any
+    std::unique_ptr<GameBase> active_game;
+    int active_index = -1;
+    GameArena* game_arena = nullptr;  // Owned by the launcher; games allocate from it while active
+    
+    // font6, rasterised as item names first need its characters
+    GlyphFont item_font{&font6};
     
     void drawStormyBackground(PicoGraphics_PenRGB888& gfx) {
         stormy_background.update();
         stormy_background.render(&gfx);
     }
+    
+    void drawItems(PicoGraphics_PenRGB888& gfx) {
+        // Calculate how many items can fit on screen
+        int item_height = 7;  // Height per menu item
+        int start_y = 2;      // Start near top
+        int max_visible_items = (32 - start_y) / item_height; // How many items fit on screen
+        
+        // Calculate scroll offset to keep selected item at top
+        int scroll_start = selected_index;
+        if (scroll_start + max_visible_items > (int)menu_items.size()) {
+            scroll_start = std::max(0, (int)menu_items.size() - max_visible_items);
+        }
+        
+        // Render visible items
+        for (int display_index = 0; display_index < max_visible_items && 
+             display_index + scroll_start < (int)menu_items.size(); display_index++) {
+            
+            int item_index = display_index + scroll_start;
+            int y_pos = start_y + display_index * item_height;
+            
+            if (item_index == selected_index) {
+                // Draw selection background rectangle
+                fillRect(gfx, 0, y_pos, 32, 6, packPen(60, 60, 20));
+            }
+            
+            // Center each game name horizontally
+            MenuItem& item = menu_items[item_index];
+            if (item.name_width < 0) {
+                item_font.prepare(gfx, item.name);
+                item.name_width = item_font.measure(item.name);
+            }
+            int name_x = (32 - item.name_width) / 2;
+            item_font.draw(gfx, item.name, name_x, y_pos + 1, item_index == selected_index ? selected_pen : text_pen);
+        }
+    }
 
 public:
-    GameMenu() {
-        last_input_time = to_ms_since_boot(get_absolute_time());
+    void setGameArena(GameArena* arena) {
+        game_arena = arena;
     }
     
-    void addGame(const char* name, const char* description, std::unique_ptr<GameBase> game) {
-        menu_items.emplace_back(name, description, std::move(game));
+    void addGame(const char* name, const char* description, GameFactory factory) {
+        menu_items.emplace_back(name, description, factory);
     }
     
     void init(PicoGraphics_PenRGB888& gfx) {
@@ -70,95 +128,97 @@ public:
         
         // Initialize stormy background
         stormy_background.init(&gfx);
+        
+        storm_layer.setDraw([this](PicoGraphics_PenRGB888& g) { drawStormyBackground(g); });
+        items_layer.setDraw([this](PicoGraphics_PenRGB888& g) { drawItems(g); });
+        layers.add(storm_layer);
+        layers.add(items_layer);
     }
     
     // Returns pointer to selected game if one was chosen, nullptr otherwise
-    GameBase* update(bool button_a, bool button_b, bool button_c) {
-        uint32_t current_time = to_ms_since_boot(get_absolute_time());
-        
-        if (current_time - last_input_time < input_debounce_ms) {
-            return nullptr;
-        }
-        
-        // Navigation - SWITCH_B for up, SWITCH_C for down
-        if (button_b && !button_b_pressed) {
-            button_b_pressed = true;
+    GameBase* update(const InputState& input) {
+        // Navigation - SWITCH_B for up, SWITCH_C for down, repeating while held
+        if (input.wasRepeated(BUTTON_B)) {
             selected_index = (selected_index - 1 + menu_items.size()) % menu_items.size();
-            last_input_time = current_time;
-        } else if (!button_b) {
-            button_b_pressed = false;
         }
-        
-        if (button_c && !button_c_pressed) {
-            button_c_pressed = true;
+        if (input.wasRepeated(BUTTON_C)) {
             selected_index = (selected_index + 1) % menu_items.size();
-            last_input_time = current_time;
-        } else if (!button_c) {
-            button_c_pressed = false;
         }
         
         // Selection
-        if (button_a && !button_a_pressed) {
-            button_a_pressed = true;
-            last_input_time = current_time;
+        if (input.wasPressed(BUTTON_A)) {
             if (selected_index >= 0 && selected_index < (int)menu_items.size()) {
-                return menu_items[selected_index].game.get();
+                return startGame(selected_index);
             }
-        } else if (!button_a) {
-            button_a_pressed = false;
         }
         
         return nullptr;
     }
     
     void render(PicoGraphics_PenRGB888& gfx) {
-        // Clear screen with stormy background
-        drawStormyBackground(gfx);
-        
-        // Calculate how many items can fit on screen
-        int item_height = 7;  // Height per menu item
-        int start_y = 2;      // Start near top
-        int max_visible_items = (32 - start_y) / item_height; // How many items fit on screen
-        
-        // Calculate scroll offset to keep selected item at top
-        int scroll_start = selected_index;
-        if (scroll_start + max_visible_items > (int)menu_items.size()) {
-            scroll_start = std::max(0, (int)menu_items.size() - max_visible_items);
+        if (selected_index != drawn_selection) {
+            drawn_selection = selected_index;
+            items_layer.invalidate();
+        }
+        layers.render(gfx);
+    }
+    
+    // Construct the chosen game; everything it allocates from here until
+    // releaseGame() comes from the game arena, which measures its use
+    GameBase* startGame(int index) {
+        releaseGame();
+        if (game_arena) {
+            game_arena->activate();
+        }
+        active_game = menu_items[index].factory();
+        active_index = index;
+        return active_game.get();
+    }
+    
+    // Destroy the active game and return its memory, releasing the whole
+    // arena in one go
+    void releaseGame() {
+        if (!active_game) {
+            return;
         }
         
-        // Render visible items
-        for (int display_index = 0; display_index < max_visible_items && 
-             display_index + scroll_start < (int)menu_items.size(); display_index++) {
-            
-            int item_index = display_index + scroll_start;
-            int y_pos = start_y + display_index * item_height;
-            
-            if (item_index == selected_index) {
-                // Draw selection background rectangle
-                for (int x = 0; x < 32; x++) {
-                    for (int y = y_pos; y < y_pos + 6; y++) {
-                        Pen bg = gfx.create_pen(60, 60, 20);
-                        gfx.set_pen(bg);
-                        gfx.pixel({x, y});
-                    }
-                }
-                gfx.set_pen(selected_pen);
-            } else {
-                gfx.set_pen(text_pen);
+        active_game.reset();
+        
+        // Games allocate from the arena, so its peak live bytes are what the
+        // game needed resident; the high-water mark adds what churn cost
+        MenuItem& item = menu_items[active_index];
+        if (game_arena) {
+            size_t peak_live = game_arena->getPeakLiveBytes();
+            size_t high_water = game_arena->getHighWaterMark();
+            if (peak_live > item.peak_live_bytes) {
+                item.peak_live_bytes = peak_live;
             }
-            
-            // Center each game name horizontally
-            const char* name = menu_items[item_index].name;
-            int name_width = gfx.measure_text(name, 1.0f);
-            int name_x = (32 - name_width) / 2;
-            drawText(gfx, name, name_x, y_pos + 1, 1.0f);
+            if (high_water > item.peak_arena_bytes) {
+                item.peak_arena_bytes = high_water;
+            }
+            printf("%s: peak live %u bytes (highest %u), arena high-water %u of %u (highest %u), "
+                   "%lu overflowed to heap",
+                   item.name, (unsigned)peak_live, (unsigned)item.peak_live_bytes, (unsigned)high_water,
+                   (unsigned)game_arena->getCapacity(), (unsigned)item.peak_arena_bytes,
+                   (unsigned long)game_arena->getOverflowCount());
+            game_arena->reset();
+        }
+        printf("; heap %u bytes in use after exit", (unsigned)heapBytesInUse());
+        if (heapBytesTotal() > 0) {
+            printf(" of %u", (unsigned)heapBytesTotal());
         }
+        printf("\n");
+        active_index = -1;
     }
     
     size_t getItemCount() const {
         return menu_items.size();
     }
     
+    int getSelectedIndex() const {
+        return selected_index;
+    }
+    
     const char* getSelectedGameName() const {
         if (selected_index >= 0 && selected_index < (int)menu_items.size()) {
             return menu_items[selected_index].name;
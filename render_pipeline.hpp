@@ -0,0 +1,298 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+#include "pico/stdlib.h"
+#include "libraries/pico_graphics/pico_graphics.hpp"
+#include "cosmic_unicorn.hpp"
+#include "frame_profiler.hpp"
+
+#if PICO_ON_DEVICE
+#include "pico/multicore.h"
+#include "hardware/sync.h"
+#else
+#include <thread>
+#endif
+
+using namespace pimoroni;
+
+// Double-buffered present path. Core 0 runs updates and draws the next frame
+// into the back buffer while core 1 pushes the previous frame to the panel
+// (cosmic_unicorn.update(), the gamma/bit-plane conversion) from the other
+// buffer. On Linux core 1 is a std::thread so the handoff can be exercised
+// on a desktop.
+//
+// The handoff only uses atomic loads and stores (no read-modify-write, which
+// the RP2040's Cortex-M0+ cores do not have):
+//   ready_frame - written by core 0: sequence number of the newest finished frame
+//   shown_frame - written by core 1: sequence number of the last frame presented
+// Frame n lives in buffers[n & 1]. Before core 0 reuses a buffer for frame
+// n + 1 it waits until core 1 has finished with frame n - 1, which in practice
+// never blocks because a present is far shorter than a frame.
+//
+// Damage tracking: at present() core 0 compares the new frame with the one
+// before it row by row. A frame identical to the last one isn't handed over
+// at all (Tetris between drops, a paused scene), and otherwise core 1 only
+// re-uploads the span of rows that changed. The whole panel is refreshed
+// when core 1 missed a frame or the brightness changed, since brightness is
+// applied as pixels are uploaded.
+class RenderPipeline {
+public:
+    static constexpr int WIDTH = CosmicUnicorn::WIDTH;
+    static constexpr int HEIGHT = CosmicUnicorn::HEIGHT;
+
+private:
+    uint32_t buffers[2][WIDTH * HEIGHT];
+    PicoGraphics_PenRGB888* graphics;
+    PicoGraphics_PenRGB888 present_view;  // Core 1's view of the front buffer
+    CosmicUnicorn* cosmic;
+
+    std::atomic<uint32_t> ready_frame;
+    std::atomic<uint32_t> shown_frame;
+    std::atomic<bool> running;
+    uint32_t frame_seq;         // Frame core 0 is currently drawing (core 0 only)
+    uint32_t presented_count;   // Core 1 only
+    uint32_t skipped_count;     // Core 1 only - frames replaced before they were shown
+
+    // Changed rows of the frame in each buffer, written by core 0 before the
+    // frame is published
+    struct Damage {
+        uint8_t first_row;
+        uint8_t last_row;
+    };
+    Damage damage[2];
+    bool full_upload_pending;   // Core 0 only
+    float uploaded_brightness;  // Core 0 only
+    uint32_t unchanged_count;   // Core 0 only - frames identical to the last, never uploaded
+    uint32_t partial_count;     // Core 1 only - uploads limited to the damaged rows
+    uint32_t rows_uploaded;     // Core 1 only
+
+#if COSMIC_PROFILING
+    // Time core 1 spends in cosmic->update(). Written only by core 1; core 0
+    // prints it and asks core 1 to clear it for the next window.
+    TimingHistogram panel_time;
+    std::atomic<bool> panel_time_reset;
+#endif
+
+    inline static RenderPipeline* active = nullptr;
+
+#if !PICO_ON_DEVICE
+    std::thread present_thread;
+
+public:
+    // Host tests: called on the present thread after each upload with the
+    // frame's sequence number and what the panel now shows
+    using UploadObserver = void (*)(void* context, uint32_t frame, const uint32_t* panel);
+
+private:
+    UploadObserver upload_observer = nullptr;
+    void* upload_context = nullptr;
+#endif
+
+public:
+    RenderPipeline()
+        : graphics(nullptr), present_view(WIDTH, HEIGHT, buffers[0]), cosmic(nullptr),
+          ready_frame(0), shown_frame(0), running(false), frame_seq(1),
+          presented_count(0), skipped_count(0), full_upload_pending(true), uploaded_brightness(0.0f),
+          unchanged_count(0), partial_count(0), rows_uploaded(0) {
+#if COSMIC_PROFILING
+        panel_time_reset.store(false);
+#endif
+        memset(buffers, 0, sizeof(buffers));
+    }
+
+    ~RenderPipeline() {
+        stop();
+    }
+
+    // The buffer to hand to the PicoGraphics constructor so nothing draws
+    // into a third, unused buffer
+    void* getBackBuffer() {
+        return buffers[frame_seq & 1];
+    }
+
+    // Point graphics at the back buffer and start presenting on core 1
+    void start(PicoGraphics_PenRGB888& gfx, CosmicUnicorn& unicorn) {
+        graphics = &gfx;
+        cosmic = &unicorn;
+        graphics->set_framebuffer(buffers[frame_seq & 1]);
+
+        active = this;
+        running.store(true);
+#if PICO_ON_DEVICE
+        multicore_launch_core1(presentLoopEntry);
+#else
+        present_thread = std::thread(presentLoopEntry);
+#endif
+    }
+
+    // Only meaningful on the host; core 1 on the device runs forever
+    void stop() {
+        if (!running.load()) return;
+        running.store(false);
+#if PICO_ON_DEVICE
+        multicore_reset_core1();
+#else
+        if (present_thread.joinable()) present_thread.join();
+#endif
+    }
+
+    // Hand the finished back buffer to core 1 and switch graphics to the other
+    // buffer, seeded with the frame just finished so games that only redraw
+    // part of the screen behave exactly as they did with one buffer
+    void present() {
+        uint32_t finished = frame_seq;
+        const uint32_t* frame = buffers[finished & 1];
+        const uint32_t* previous = buffers[(finished - 1) & 1];
+
+        // Find the rows that differ from the frame handed over last time
+        int first_row = 0;
+        int last_row = HEIGHT - 1;
+        float brightness = cosmic->get_brightness();
+        if (!full_upload_pending && brightness == uploaded_brightness) {
+            while (first_row < HEIGHT && rowEqual(frame, previous, first_row)) first_row++;
+            if (first_row == HEIGHT) {
+                // Nothing changed: keep drawing into the same buffer, which
+                // already holds this frame
+                unchanged_count++;
+                return;
+            }
+            while (rowEqual(frame, previous, last_row)) last_row--;
+        }
+        full_upload_pending = false;
+        uploaded_brightness = brightness;
+        damage[finished & 1] = {(uint8_t)first_row, (uint8_t)last_row};
+
+        ready_frame.store(finished, std::memory_order_release);
+        signalOtherCore();
+
+        // The next buffer last held frame finished - 1; wait for core 1 to be done with it
+        while (shown_frame.load(std::memory_order_acquire) + 1 < finished) {
+            waitForOtherCore();
+        }
+
+        frame_seq = finished + 1;
+        memcpy(buffers[frame_seq & 1], buffers[finished & 1], sizeof(buffers[0]));
+        graphics->set_framebuffer(buffers[frame_seq & 1]);
+    }
+
+    // Block until core 1 has shown the last frame handed over. The host runner
+    // uses this to mimic the board, where core 1 always keeps up.
+    void waitUntilShown() {
+        while (running.load(std::memory_order_relaxed) &&
+               shown_frame.load(std::memory_order_acquire) < ready_frame.load(std::memory_order_relaxed)) {
+            waitForOtherCore();
+        }
+    }
+
+#if !PICO_ON_DEVICE
+    // Set before start()
+    void setUploadObserver(UploadObserver observer, void* context) {
+        upload_observer = observer;
+        upload_context = context;
+    }
+#endif
+
+    // Called from core 0 alongside FrameProfiler::report()
+    void reportPanelTime() {
+#if COSMIC_PROFILING
+        if (!panel_time_reset.load(std::memory_order_acquire) && panel_time.count > 0) {
+            panel_time.print("core1", "cosmic_unicorn.update");
+            panel_time_reset.store(true, std::memory_order_release);
+        }
+#endif
+    }
+
+    uint32_t getPresentedCount() const { return presented_count; }
+    uint32_t getSkippedCount() const { return skipped_count; }
+    uint32_t getUnchangedCount() const { return unchanged_count; }
+    uint32_t getPartialCount() const { return partial_count; }
+    uint32_t getRowsUploaded() const { return rows_uploaded; }
+
+private:
+    static bool rowEqual(const uint32_t* a, const uint32_t* b, int row) {
+        return memcmp(a + row * WIDTH, b + row * WIDTH, WIDTH * sizeof(uint32_t)) == 0;
+    }
+
+    // The per-pixel half of cosmic->update() for just the damaged rows
+    void uploadRows(const uint32_t* frame, int first_row, int last_row) {
+        for (int y = first_row; y <= last_row; y++) {
+            const uint32_t* p = frame + y * WIDTH;
+            for (int x = 0; x < WIDTH; x++) {
+                uint32_t colour = p[x];
+                cosmic->set_pixel(x, y, (colour >> 16) & 0xff, (colour >> 8) & 0xff, colour & 0xff);
+            }
+        }
+    }
+
+    void uploadFrame(uint32_t frame, bool follows_last_shown) {
+        Damage rows = damage[frame & 1];
+        if (follows_last_shown && (rows.first_row > 0 || rows.last_row < HEIGHT - 1)) {
+            uploadRows(buffers[frame & 1], rows.first_row, rows.last_row);
+            partial_count++;
+            rows_uploaded += rows.last_row - rows.first_row + 1;
+        } else {
+            present_view.set_framebuffer(buffers[frame & 1]);
+            cosmic->update(&present_view);
+            rows_uploaded += HEIGHT;
+        }
+    }
+
+    static void presentLoopEntry() {
+        active->presentLoop();
+    }
+
+    void presentLoop() {
+        uint32_t last_shown = shown_frame.load(std::memory_order_relaxed);
+
+        while (running.load(std::memory_order_relaxed)) {
+            uint32_t frame = ready_frame.load(std::memory_order_acquire);
+            if (frame == last_shown) {
+                waitForOtherCore();
+                continue;
+            }
+
+            if (frame > last_shown + 1) skipped_count += frame - last_shown - 1;
+
+            // Damage is relative to the previous frame, so only usable if
+            // that one is what the panel is showing
+            bool follows_last_shown = frame == last_shown + 1;
+#if COSMIC_PROFILING
+            if (panel_time_reset.load(std::memory_order_acquire)) {
+                panel_time.clear();
+                panel_time_reset.store(false, std::memory_order_release);
+            }
+            uint32_t start_us = profilerNowUs();
+            uploadFrame(frame, follows_last_shown);
+            panel_time.add(profilerNowUs() - start_us);
+#else
+            uploadFrame(frame, follows_last_shown);
+#endif
+#if !PICO_ON_DEVICE
+            if (upload_observer) upload_observer(upload_context, frame, cosmic->getPanel());
+#endif
+            presented_count++;
+
+            last_shown = frame;
+            shown_frame.store(frame, std::memory_order_release);
+            signalOtherCore();
+        }
+    }
+
+    // Both sides idle on an event rather than spinning flat out
+    static void waitForOtherCore() {
+#if PICO_ON_DEVICE
+        __wfe();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    static void signalOtherCore() {
+#if PICO_ON_DEVICE
+        __sev();
+#endif
+    }
+};